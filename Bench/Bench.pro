@@ -0,0 +1,46 @@
+QT += testlib opengl core gui
+
+TARGET = MLEBench
+
+TEMPLATE = app
+CONFIG += console c++14
+CONFIG -= app_bundle
+MOC_DIR = moc
+OBJECTS_DIR = obj
+
+# Benchmarks run against the demo's own mesh code and models
+DEFINES += MODEL_DIR=\\\"$$PWD/../Demo/models/\\\"
+
+INCLUDEPATH += $$PWD/include \
+            /usr/local/include/glm/glm \
+            /usr/local/include/glm \
+            $$PWD/../Demo/NitronoidSource/include \
+            $$PWD/../MLElib/include
+
+HEADERS += $$files(./include/*.h) \
+            $$files(../Demo/NitronoidSource/include/Mesh*.h) \
+            ../Demo/NitronoidSource/include/ObjLoader.h \
+            ../Demo/NitronoidSource/include/Tangents.h \
+            ../Demo/NitronoidSource/include/GeometryArena.h \
+            ../Demo/NitronoidSource/include/DrawBatches.h \
+            ../Demo/NitronoidSource/include/IndirectDraws.h
+
+SOURCES += $$files(./src/*.cpp) \
+    ../Demo/NitronoidSource/src/Mesh.cpp \
+    ../Demo/NitronoidSource/src/MeshCache.cpp \
+    ../Demo/NitronoidSource/src/ObjLoader.cpp \
+    ../Demo/NitronoidSource/src/MeshVBO.cpp \
+    ../Demo/NitronoidSource/src/GeometryArena.cpp \
+    ../Demo/NitronoidSource/src/DrawBatches.cpp \
+    ../Demo/NitronoidSource/src/IndirectDraws.cpp \
+    ../Demo/NitronoidSource/src/MeshOptimizer.cpp \
+    ../Demo/NitronoidSource/src/MeshSimplifier.cpp \
+    ../Demo/NitronoidSource/src/Meshlets.cpp \
+    ../Demo/NitronoidSource/src/Tangents.cpp \
+    benchAll.cpp
+
+QMAKE_CXXFLAGS += -std=c++14 -O2
+
+linux:{
+    LIBS += -lGL -lassimp -L../MLElib -lMyLittleEditor
+}
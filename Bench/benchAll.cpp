@@ -0,0 +1,45 @@
+#include "benchMeshLoad.h"
+#include "benchVertexFetch.h"
+#include "benchRenderLayout.h"
+#include "benchMeshOptimize.h"
+#include "benchMeshletCull.h"
+#include "benchTangents.h"
+#include "benchDrawSubmit.h"
+
+#define LOAD_BENCH
+//#define FETCH_BENCH
+//#define RENDER_BENCH
+//#define OPTIMIZE_BENCH
+//#define CULL_BENCH
+//#define TANGENT_BENCH
+//#define SUBMIT_BENCH
+
+#ifdef LOAD_BENCH
+  QTEST_APPLESS_MAIN(benchMeshLoad)
+#endif
+
+#ifdef FETCH_BENCH
+  QTEST_APPLESS_MAIN(benchVertexFetch)
+#endif
+
+#ifdef RENDER_BENCH
+  // Needs an application for the offscreen surface
+  QTEST_MAIN(benchRenderLayout)
+#endif
+
+#ifdef OPTIMIZE_BENCH
+  QTEST_APPLESS_MAIN(benchMeshOptimize)
+#endif
+
+#ifdef CULL_BENCH
+  QTEST_APPLESS_MAIN(benchMeshletCull)
+#endif
+
+#ifdef TANGENT_BENCH
+  QTEST_APPLESS_MAIN(benchTangents)
+#endif
+
+#ifdef SUBMIT_BENCH
+  // Needs an application for the offscreen surface
+  QTEST_MAIN(benchDrawSubmit)
+#endif
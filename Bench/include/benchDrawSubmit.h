@@ -0,0 +1,55 @@
+#ifndef BENCHDRAWSUBMIT_H
+#define BENCHDRAWSUBMIT_H
+
+#include <QtTest/QtTest>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLBuffer>
+#include <QOpenGLVertexArrayObject>
+#include <memory>
+#include <vector>
+#include "Mesh.h"
+#include "GeometryArena.h"
+#include "DrawBatches.h"
+#include "IndirectDraws.h"
+
+// Draws a scene of many objects over a few meshes and materials offscreen, one draw per object, one
+// instanced draw per batch and one multi draw indirect per material. Needs GL 4.3, meant to run headless
+// on Mesa: QT_QPA_PLATFORM=offscreen LIBGL_ALWAYS_SOFTWARE=1 ./MLEBench
+class benchDrawSubmit : public QObject
+{
+  Q_OBJECT
+private Q_SLOTS:
+  void initTestCase();
+  void cleanupTestCase();
+  void bench_submit_data();
+  void bench_submit();
+private:
+  void setPage(const GeometryArena::Allocation &_range);
+  void setMaterial(const size_t _material);
+private:
+  static constexpr size_t s_objects = 2000;
+  static constexpr size_t s_materials = 4;
+  QOffscreenSurface m_surface;
+  QOpenGLContext m_context;
+  std::unique_ptr<QOpenGLFramebufferObject> m_fbo;
+  std::unique_ptr<QOpenGLShaderProgram> m_program;
+  std::unique_ptr<QOpenGLVertexArrayObject> m_vao;
+  GeometryArena m_geometry;
+  std::vector<std::unique_ptr<Mesh>> m_meshes;
+  std::vector<const GeometryArena::Allocation*> m_ranges;
+  DrawBatches m_batches;
+  IndirectDraws m_indirect;
+  QOpenGLBuffer m_instanceBuffer {QOpenGLBuffer::VertexBuffer};
+  QOpenGLBuffer m_commandBuffer {QOpenGLBuffer::VertexBuffer};
+  const MeshVBO* m_boundBuffers = nullptr;
+  // Each object's mesh, material and matrices in scene order, as the per object draws take them
+  std::vector<DrawBatches::Key> m_keys;
+  std::vector<DrawBatches::Instance> m_sceneInstances;
+  // The per object image, the other paths must draw the same
+  QImage m_reference;
+};
+
+#endif // BENCHDRAWSUBMIT_H
@@ -0,0 +1,21 @@
+#ifndef BENCHMESHLOAD_H
+#define BENCHMESHLOAD_H
+
+#include <QtTest/QtTest>
+#include "Mesh.h"
+
+// Times Mesh::load on the bundled models, with Assimp against the native OBJ importer, both bypassing the cache
+class benchMeshLoad : public QObject
+{
+  Q_OBJECT
+private Q_SLOTS:
+  void bench_assimp_data();
+  void bench_assimp();
+  void bench_native_data();
+  void bench_native();
+private:
+  void models();
+  void load(const bool _native);
+};
+
+#endif // BENCHMESHLOAD_H
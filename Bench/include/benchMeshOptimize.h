@@ -0,0 +1,26 @@
+#ifndef BENCHMESHOPTIMIZE_H
+#define BENCHMESHOPTIMIZE_H
+
+#include <QtTest/QtTest>
+#include <map>
+#include "Mesh.h"
+
+// Times the optimizer passes on the native importer's output and reports the simulated post-transform
+// cache miss ratios before and after
+class benchMeshOptimize : public QObject
+{
+  Q_OBJECT
+private Q_SLOTS:
+  void initTestCase();
+  void bench_vertexCache_data();
+  void bench_vertexCache();
+  void bench_overdraw_data();
+  void bench_overdraw();
+private:
+  void models();
+  void optimize(const unsigned int _passes);
+private:
+  std::map<QString, MeshStorage> m_imported;
+};
+
+#endif // BENCHMESHOPTIMIZE_H
@@ -0,0 +1,23 @@
+#ifndef BENCHMESHLETCULL_H
+#define BENCHMESHLETCULL_H
+
+#include <QtTest/QtTest>
+#include <map>
+#include <memory>
+#include "Mesh.h"
+#include "Meshlets.h"
+
+// Times culling the meshlets of full detail meshes from cameras orbiting them, and reports the share
+// of triangles still submitted next to the share that actually faces the camera
+class benchMeshletCull : public QObject
+{
+  Q_OBJECT
+private Q_SLOTS:
+  void initTestCase();
+  void bench_cull_data();
+  void bench_cull();
+private:
+  std::map<QString, std::unique_ptr<Mesh>> m_meshes;
+};
+
+#endif // BENCHMESHLETCULL_H
@@ -0,0 +1,39 @@
+#ifndef BENCHRENDERLAYOUT_H
+#define BENCHRENDERLAYOUT_H
+
+#include <QtTest/QtTest>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
+#include <memory>
+#include "Mesh.h"
+#include "MeshVBO.h"
+
+// Renders the bundled models offscreen with each vertex layout. Meant to run headless on Mesa:
+// QT_QPA_PLATFORM=offscreen LIBGL_ALWAYS_SOFTWARE=1 ./MLEBench
+class benchRenderLayout : public QObject
+{
+  Q_OBJECT
+private Q_SLOTS:
+  void initTestCase();
+  void cleanupTestCase();
+  void bench_planar_data();
+  void bench_planar();
+  void bench_interleaved_data();
+  void bench_interleaved();
+  void bench_quantized_data();
+  void bench_quantized();
+private:
+  void models();
+  void render(const MeshAttributes::Layout _layout);
+private:
+  // Draws per benchmark iteration, so the upload and setup are a small part of the time
+  static constexpr int s_draws = 10;
+  QOffscreenSurface m_surface;
+  QOpenGLContext m_context;
+  std::unique_ptr<QOpenGLFramebufferObject> m_fbo;
+  std::unique_ptr<QOpenGLShaderProgram> m_program;
+};
+
+#endif // BENCHRENDERLAYOUT_H
@@ -0,0 +1,21 @@
+#ifndef BENCHTANGENTS_H
+#define BENCHTANGENTS_H
+
+#include <QtTest/QtTest>
+#include <map>
+#include "Mesh.h"
+
+// Times generating tangents for the largest bundled models with UVs, and checks every frame is unit
+// length, orthogonal to its normal and has a handedness
+class benchTangents : public QObject
+{
+  Q_OBJECT
+private Q_SLOTS:
+  void initTestCase();
+  void bench_generate_data();
+  void bench_generate();
+private:
+  std::map<QString, MeshStorage> m_imported;
+};
+
+#endif // BENCHTANGENTS_H
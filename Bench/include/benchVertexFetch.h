@@ -0,0 +1,28 @@
+#ifndef BENCHVERTEXFETCH_H
+#define BENCHVERTEXFETCH_H
+
+#include <QtTest/QtTest>
+#include <map>
+#include <memory>
+#include "Mesh.h"
+
+// Reads every attribute of every indexed vertex on the CPU, the way the vertex stage fetches them, from
+// the planar arrays and from the interleaved array
+class benchVertexFetch : public QObject
+{
+  Q_OBJECT
+private Q_SLOTS:
+  void initTestCase();
+  void bench_planar_data();
+  void bench_planar();
+  void bench_interleaved_data();
+  void bench_interleaved();
+private:
+  void models();
+  template<typename Fetch>
+  float fetchIndexed(const Mesh &_mesh, Fetch _fetch) const;
+private:
+  std::map<QString, std::unique_ptr<Mesh>> m_meshes;
+};
+
+#endif // BENCHVERTEXFETCH_H
@@ -0,0 +1,252 @@
+#include "benchDrawSubmit.h"
+#include <QOpenGLFunctions_4_3_Core>
+#include <gtc/matrix_transform.hpp>
+#include <gtc/type_ptr.hpp>
+#include <cstddef>
+
+constexpr size_t benchDrawSubmit::s_objects;
+constexpr size_t benchDrawSubmit::s_materials;
+
+void benchDrawSubmit::initTestCase()
+{
+  QSurfaceFormat format;
+  format.setMajorVersion(4);
+  format.setMinorVersion(3);
+  format.setProfile(QSurfaceFormat::CoreProfile);
+  m_context.setFormat(format);
+  QVERIFY(m_context.create());
+  m_surface.setFormat(m_context.format());
+  m_surface.create();
+  QVERIFY(m_context.makeCurrent(&m_surface));
+  QVERIFY(m_context.versionFunctions<QOpenGLFunctions_4_3_Core>() != nullptr);
+  qDebug() << reinterpret_cast<const char*>(m_context.functions()->glGetString(GL_RENDERER));
+
+  m_fbo.reset(new QOpenGLFramebufferObject(512, 512, QOpenGLFramebufferObject::Depth));
+  QVERIFY(m_fbo->bind());
+  // The matrices are per instance attributes at the locations the demo's material shaders use
+  m_program.reset(new QOpenGLShaderProgram);
+  QVERIFY(m_program->addShaderFromSourceCode(QOpenGLShader::Vertex,
+    "#version 420 core\n"
+    "layout (location = 0) in vec3 inVert;\n"
+    "layout (location = 2) in vec3 inNormal;\n"
+    "layout (location = 4) in mat4 M;\n"
+    "layout (location = 8) in mat4 N;\n"
+    "uniform mat4 VP;\n"
+    "out vec3 normal;\n"
+    "void main() { normal = normalize((N * vec4(inNormal, 0.0)).xyz); gl_Position = VP * M * vec4(inVert, 1.0); }\n"));
+  QVERIFY(m_program->addShaderFromSourceCode(QOpenGLShader::Fragment,
+    "#version 420 core\n"
+    "in vec3 normal;\n"
+    "uniform vec3 colour;\n"
+    "out vec4 fragColour;\n"
+    "void main() { fragColour = vec4(colour * (0.2 + 0.8 * abs(normal.z)), 1.0); }\n"));
+  QVERIFY(m_program->link());
+  QVERIFY(m_program->bind());
+  m_program->setUniformValue("VP", QMatrix4x4(glm::value_ptr(glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -2.0f, 2.0f))).transposed());
+  auto gl = m_context.functions();
+  gl->glViewport(0, 0, 512, 512);
+  gl->glEnable(GL_DEPTH_TEST);
+  gl->glEnable(GL_CULL_FACE);
+
+  // Uploaded quantized into one arena, as MainScene does
+  m_vao.reset(new QOpenGLVertexArrayObject);
+  m_vao->create();
+  m_vao->bind();
+  for (const char* model : {"cube.obj", "Sphere.obj", "Suzanne.obj", "mandarin.obj", "test2.obj"})
+  {
+    std::unique_ptr<Mesh> mesh(new Mesh);
+    mesh->setUseCache(false);
+    mesh->setLayout(MeshAttributes::QUANTIZED);
+    QVERIFY(mesh->load(QString(QString(MODEL_DIR) + model).toStdString(), [](float){ return true; }));
+    m_ranges.push_back(mesh->upload(m_geometry));
+    QVERIFY(m_ranges.back() != nullptr);
+    m_meshes.push_back(std::move(mesh));
+  }
+  qDebug() << m_geometry.usedBytes() << "bytes of geometry in" << m_geometry.pageCount() << "pages";
+
+  // A grid of small objects cycling through the meshes and materials, so neighbours never share both
+  const size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<float>(s_objects))));
+  const float cell = 2.0f / side;
+  for (size_t i = 0; i < s_objects; ++i)
+  {
+    const Mesh& mesh = *m_meshes[i % m_meshes.size()];
+    const glm::vec3 centre = (mesh.getMin() + mesh.getMax()) * 0.5f;
+    const float radius = glm::length(mesh.getMax() - mesh.getMin()) * 0.5f;
+    const glm::vec3 position(-1.0f + cell * (i % side + 0.5f), -1.0f + cell * (i / side + 0.5f), 0.0f);
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+    model = glm::rotate(model, 0.3f * i, glm::vec3(0.0f, 1.0f, 0.0f));
+    model = glm::scale(model, glm::vec3(cell * 0.45f / radius));
+    model = glm::translate(model, -centre);
+    DrawBatches::Instance instance;
+    instance.model = model * mesh.getPositionMatrix();
+    instance.normal = glm::inverse(glm::transpose(model));
+    m_sceneInstances.push_back(instance);
+    DrawBatches::Key key;
+    key.material = i % s_materials;
+    key.geo = i % m_meshes.size();
+    key.cullBackFaces = true;
+    m_keys.push_back(key);
+  }
+
+  m_instanceBuffer.create();
+  m_instanceBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+  m_instanceBuffer.bind();
+  auto gl43 = m_context.versionFunctions<QOpenGLFunctions_4_3_Core>();
+  using namespace MeshAttributes;
+  for (const auto matrix : {MODEL_MATRIX, NORMAL_MATRIX})
+  {
+    const size_t offset = matrix == MODEL_MATRIX ? offsetof(DrawBatches::Instance, model) : offsetof(DrawBatches::Instance, normal);
+    for (GLuint column = 0; column < 4; ++column)
+    {
+      gl43->glEnableVertexAttribArray(matrix + column);
+      gl43->glVertexAttribPointer(matrix + column, 4, GL_FLOAT, GL_FALSE, sizeof(DrawBatches::Instance),
+                                  reinterpret_cast<const void*>(offset + column * sizeof(glm::vec4)));
+      gl43->glVertexAttribDivisor(matrix + column, 1);
+    }
+  }
+  m_commandBuffer.create();
+  m_commandBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+}
+
+void benchDrawSubmit::cleanupTestCase()
+{
+  m_instanceBuffer.destroy();
+  m_commandBuffer.destroy();
+  m_ranges.clear();
+  m_meshes.clear();
+  m_geometry = GeometryArena();
+  m_vao.reset();
+  m_program.reset();
+  m_fbo.reset();
+  m_context.doneCurrent();
+}
+
+void benchDrawSubmit::setPage(const GeometryArena::Allocation &_range)
+{
+  MeshVBO& buffers = _range.buffers();
+  if (&buffers == m_boundBuffers)
+    return;
+  m_boundBuffers = &buffers;
+  buffers.use();
+  using namespace MeshAttributes;
+  for (const auto buff : {VERTEX, UV, NORMAL, TANGENT})
+  {
+    if (buffers.dataAmount(buff) == 0)
+    {
+      m_program->disableAttributeArray(buff);
+      continue;
+    }
+    m_program->enableAttributeArray(buff);
+    m_program->setAttributeBuffer(buff, buffers.type(buff), buffers.offset(buff), buffers.components(buff), buffers.stride());
+  }
+}
+
+void benchDrawSubmit::setMaterial(const size_t _material)
+{
+  static const QVector3D colours[s_materials] = {{1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}};
+  m_program->setUniformValue("colour", colours[_material]);
+}
+
+void benchDrawSubmit::bench_submit_data()
+{
+  QTest::addColumn<QString>("path");
+  for (const char* path : {"object", "instanced", "indirect"})
+    QTest::newRow(path) << QString(path);
+}
+
+void benchDrawSubmit::bench_submit()
+{
+  QFETCH(QString, path);
+  auto gl = m_context.versionFunctions<QOpenGLFunctions_4_3_Core>();
+  std::vector<Meshlets::DrawRange> ranges(1);
+  size_t calls = 0;
+  if (path == "object")
+  {
+    // Every object on its own, in scene order, the way the demo drew before batching
+    m_instanceBuffer.bind();
+    m_instanceBuffer.allocate(m_sceneInstances.data(), static_cast<int>(m_sceneInstances.size() * sizeof(DrawBatches::Instance)));
+    QBENCHMARK
+    {
+      gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      m_boundBuffers = nullptr;
+      calls = 0;
+      for (size_t i = 0; i < m_keys.size(); ++i)
+      {
+        const Mesh& mesh = *m_meshes[m_keys[i].geo];
+        const GeometryArena::Allocation& range = *m_ranges[m_keys[i].geo];
+        setMaterial(m_keys[i].material);
+        setPage(range);
+        gl->glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(mesh.getLodIndexCount(0)), range.indexType(),
+                                                          range.indexOffset(mesh.getSubMesh(mesh.getLod(0).firstSubMesh).firstIndex), 1,
+                                                          range.baseVertex(), static_cast<GLuint>(i));
+        ++calls;
+      }
+      gl->glFinish();
+    }
+  }
+  else
+  {
+    // Batching is part of every frame, so it is timed with the draws
+    const bool indirect = path == "indirect";
+    QBENCHMARK
+    {
+      gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      m_boundBuffers = nullptr;
+      calls = 0;
+      m_batches.clear();
+      for (size_t i = 0; i < m_keys.size(); ++i)
+      {
+        const Mesh& mesh = *m_meshes[m_keys[i].geo];
+        ranges[0].firstIndex = mesh.getSubMesh(mesh.getLod(0).firstSubMesh).firstIndex;
+        ranges[0].indexCount = mesh.getLodIndexCount(0);
+        m_batches.add(m_keys[i], m_sceneInstances[i], ranges);
+      }
+      m_batches.build();
+      m_instanceBuffer.bind();
+      m_instanceBuffer.allocate(m_batches.instances().data(), static_cast<int>(m_batches.instances().size() * sizeof(DrawBatches::Instance)));
+      if (indirect)
+      {
+        m_indirect.clear();
+        for (const auto& batch : m_batches.batches())
+        {
+          m_indirect.add(m_batches, batch, *m_meshes[batch.key.geo], *m_ranges[batch.key.geo]);
+        }
+        m_commandBuffer.bind();
+        m_commandBuffer.allocate(m_indirect.commands().data(), static_cast<int>(m_indirect.commands().size() * sizeof(IndirectDraws::Command)));
+        gl->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer.bufferId());
+        for (const auto& bucket : m_indirect.buckets())
+        {
+          setMaterial(bucket.key.material);
+          setPage(*bucket.range);
+          gl->glMultiDrawElementsIndirect(GL_TRIANGLES, bucket.range->indexType(),
+                                          reinterpret_cast<const void*>(bucket.firstCommand * sizeof(IndirectDraws::Command)),
+                                          static_cast<GLsizei>(bucket.commandCount), 0);
+          ++calls;
+        }
+      }
+      else
+      {
+        for (const auto& batch : m_batches.batches())
+        {
+          const Mesh& mesh = *m_meshes[batch.key.geo];
+          const GeometryArena::Allocation& range = *m_ranges[batch.key.geo];
+          setMaterial(batch.key.material);
+          setPage(range);
+          gl->glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(mesh.getLodIndexCount(0)), range.indexType(),
+                                                            range.indexOffset(mesh.getSubMesh(mesh.getLod(0).firstSubMesh).firstIndex),
+                                                            static_cast<GLsizei>(batch.instanceCount), range.baseVertex(), batch.firstInstance);
+          ++calls;
+        }
+      }
+      gl->glFinish();
+    }
+  }
+  qDebug() << calls << "draw calls for" << m_keys.size() << "objects";
+  QCOMPARE(gl->glGetError(), static_cast<GLenum>(GL_NO_ERROR));
+
+  // The objects don't overlap, so every path must give the same image
+  const QImage image = m_fbo->toImage();
+  if (m_reference.isNull())
+    m_reference = image;
+  QCOMPARE(image, m_reference);
+}
@@ -0,0 +1,43 @@
+#include "benchMeshLoad.h"
+
+void benchMeshLoad::models()
+{
+  QTest::addColumn<QString>("model");
+  for (const char* model : {"Face.obj", "Face2.obj", "Suzanne.obj", "mandarin.obj"})
+    QTest::newRow(model) << QString(MODEL_DIR) + model;
+}
+
+void benchMeshLoad::load(const bool _native)
+{
+  QFETCH(QString, model);
+  Mesh mesh;
+  mesh.setUseCache(false);
+  mesh.setNativeObj(_native);
+  // Only the import is timed, the optimizer passes cost the same after either importer
+  mesh.setOptimization(0);
+  QBENCHMARK
+  {
+    QVERIFY(mesh.load(model.toStdString(), [](float){ return true; }));
+  }
+  QVERIFY(mesh.getNIndicesData() > 0);
+}
+
+void benchMeshLoad::bench_assimp_data()
+{
+  models();
+}
+
+void benchMeshLoad::bench_assimp()
+{
+  load(false);
+}
+
+void benchMeshLoad::bench_native_data()
+{
+  models();
+}
+
+void benchMeshLoad::bench_native()
+{
+  load(true);
+}
@@ -0,0 +1,64 @@
+#include "benchMeshOptimize.h"
+#include "ObjLoader.h"
+
+void benchMeshOptimize::initTestCase()
+{
+  for (const char* model : {"Face.obj", "Face2.obj", "Suzanne.obj", "mandarin.obj", "Asteroid.obj"})
+  {
+    MeshStorage data;
+    QVERIFY(ObjLoader::load(QString(QString(MODEL_DIR) + model).toStdString(), data, [](float){ return true; }));
+    // Mesh::load adds the single range when the file has no parts
+    if (data.subMeshes.empty())
+    {
+      SubMesh whole;
+      whole.indexCount = static_cast<GLuint>(data.indices.size() + data.indices32.size());
+      data.subMeshes.push_back(whole);
+    }
+    m_imported[model] = std::move(data);
+  }
+}
+
+void benchMeshOptimize::models()
+{
+  QTest::addColumn<QString>("model");
+  for (const auto& imported : m_imported)
+    QTest::newRow(imported.first.toLatin1().constData()) << imported.first;
+}
+
+void benchMeshOptimize::optimize(const unsigned int _passes)
+{
+  QFETCH(QString, model);
+  const MeshStorage& imported = m_imported[model];
+  MeshStorage optimized;
+  // Includes copying the arrays, which is small next to the passes
+  QBENCHMARK
+  {
+    optimized = imported;
+    MeshOptimizer::optimize(optimized, _passes);
+  }
+  const MeshOptimizer::CacheStats before = MeshOptimizer::analyze(imported);
+  const MeshOptimizer::CacheStats after = MeshOptimizer::analyze(optimized);
+  qDebug() << "ACMR" << before.acmr << "->" << after.acmr << "ATVR" << before.atvr << "->" << after.atvr;
+  QCOMPARE(optimized.indices.size() + optimized.indices32.size(), imported.indices.size() + imported.indices32.size());
+  QVERIFY(after.acmr <= before.acmr);
+}
+
+void benchMeshOptimize::bench_vertexCache_data()
+{
+  models();
+}
+
+void benchMeshOptimize::bench_vertexCache()
+{
+  optimize(MeshOptimizer::VERTEX_CACHE | MeshOptimizer::VERTEX_FETCH);
+}
+
+void benchMeshOptimize::bench_overdraw_data()
+{
+  models();
+}
+
+void benchMeshOptimize::bench_overdraw()
+{
+  optimize(MeshOptimizer::VERTEX_CACHE | MeshOptimizer::OVERDRAW | MeshOptimizer::VERTEX_FETCH);
+}
@@ -0,0 +1,89 @@
+#include "benchMeshletCull.h"
+#include <gtc/matrix_transform.hpp>
+#include <gtc/constants.hpp>
+
+namespace
+{
+// Cameras on rings around the mesh, a close and a far one per direction
+std::vector<glm::vec3> orbit(const Mesh &_mesh)
+{
+  const glm::vec3 centre = (_mesh.getMin() + _mesh.getMax()) * 0.5f;
+  const float radius = glm::length(_mesh.getMax() - _mesh.getMin()) * 0.5f;
+  std::vector<glm::vec3> eyes;
+  for (int yaw = 0; yaw < 12; ++yaw)
+  {
+    for (int pitch = -2; pitch <= 2; ++pitch)
+    {
+      const float y = glm::radians(30.0f * yaw);
+      const float p = 0.6f * pitch;
+      const glm::vec3 direction(std::cos(p) * std::sin(y), std::sin(p), std::cos(p) * std::cos(y));
+      for (const float distance : {1.2f, 2.5f})
+        eyes.push_back(centre + direction * radius * distance);
+    }
+  }
+  return eyes;
+}
+}
+
+void benchMeshletCull::initTestCase()
+{
+  for (const char* model : {"Face2.obj", "Suzanne.obj", "mandarin.obj", "test2.obj"})
+  {
+    std::unique_ptr<Mesh> mesh(new Mesh);
+    mesh->setUseCache(false);
+    QVERIFY(mesh->load(QString(QString(MODEL_DIR) + model).toStdString(), [](float){ return true; }));
+    m_meshes[model] = std::move(mesh);
+  }
+}
+
+void benchMeshletCull::bench_cull_data()
+{
+  QTest::addColumn<QString>("model");
+  for (const auto& mesh : m_meshes)
+    QTest::newRow(mesh.first.toLatin1().constData()) << mesh.first;
+}
+
+void benchMeshletCull::bench_cull()
+{
+  QFETCH(QString, model);
+  const Mesh& mesh = *m_meshes[model];
+  const glm::vec3 centre = (mesh.getMin() + mesh.getMax()) * 0.5f;
+  const float radius = glm::length(mesh.getMax() - mesh.getMin()) * 0.5f;
+  const glm::mat4 projection = glm::perspective(glm::quarter_pi<float>(), 16.0f / 9.0f, radius * 0.01f, radius * 100.0f);
+  const std::vector<glm::vec3> eyes = orbit(mesh);
+  std::vector<glm::mat4> clips;
+  for (const glm::vec3& eye : eyes)
+    clips.push_back(projection * glm::lookAt(eye, centre, glm::vec3(0.0f, 1.0f, 0.0f)));
+  const MeshLod& lod = mesh.getLod(0);
+  std::vector<Meshlets::DrawRange> ranges;
+  size_t submitted = 0;
+  QBENCHMARK
+  {
+    submitted = 0;
+    for (size_t view = 0; view < eyes.size(); ++view)
+      submitted += Meshlets::cull(mesh, lod, clips[view], eyes[view], true, ranges);
+  }
+
+  // Triangles a GPU culling back faces would keep, the best any cluster test can do
+  const size_t indexCount = mesh.getLodIndexCount(0);
+  const GLuint first = mesh.getSubMesh(lod.firstSubMesh).firstIndex;
+  const GLfloat* positions = mesh.getVertexData();
+  size_t facing = 0;
+  for (const glm::vec3& eye : eyes)
+  {
+    for (GLuint i = first; i < first + indexCount; i += 3)
+    {
+      glm::vec3 corners[3];
+      for (GLuint c = 0; c < 3; ++c)
+      {
+        const GLuint index = mesh.getIndexType() == GL_UNSIGNED_INT ? static_cast<const GLuint*>(mesh.getIndicesData())[i + c]
+                                                                     : static_cast<const GLushort*>(mesh.getIndicesData())[i + c];
+        corners[c] = glm::vec3(positions[index * 3], positions[index * 3 + 1], positions[index * 3 + 2]);
+      }
+      facing += glm::dot(eye - corners[0], glm::cross(corners[1] - corners[0], corners[2] - corners[0])) > 0.0f ? 3 : 0;
+    }
+  }
+  const double total = static_cast<double>(indexCount * eyes.size());
+  qDebug() << submitted / total << "of the triangles submitted," << facing / total << "facing the camera";
+  QVERIFY(submitted < indexCount * eyes.size());
+}
@@ -0,0 +1,147 @@
+#include "benchRenderLayout.h"
+#include <QOpenGLFunctions>
+#include <QOpenGLVertexArrayObject>
+#include <gtc/type_ptr.hpp>
+
+void benchRenderLayout::initTestCase()
+{
+  QSurfaceFormat format;
+  format.setMajorVersion(4);
+  format.setMinorVersion(3);
+  format.setProfile(QSurfaceFormat::CoreProfile);
+  m_context.setFormat(format);
+  QVERIFY(m_context.create());
+  m_surface.setFormat(m_context.format());
+  m_surface.create();
+  QVERIFY(m_context.makeCurrent(&m_surface));
+  qDebug() << reinterpret_cast<const char*>(m_context.functions()->glGetString(GL_RENDERER));
+
+  m_fbo.reset(new QOpenGLFramebufferObject(512, 512, QOpenGLFramebufferObject::Depth));
+  QVERIFY(m_fbo->bind());
+  // Uses all three attributes so none of them is optimised away
+  m_program.reset(new QOpenGLShaderProgram);
+  QVERIFY(m_program->addShaderFromSourceCode(QOpenGLShader::Vertex,
+    "#version 410 core\n"
+    "layout (location = 0) in vec3 inVert;\n"
+    "layout (location = 1) in vec2 inUV;\n"
+    "layout (location = 2) in vec3 inNormal;\n"
+    "out vec3 normal;\n"
+    "out vec2 uv;\n"
+    "uniform mat4 position;\n"
+    "void main() { normal = inNormal; uv = inUV; gl_Position = vec4((position * vec4(inVert, 1.0)).xyz * 0.5, 1.0); }\n"));
+  QVERIFY(m_program->addShaderFromSourceCode(QOpenGLShader::Fragment,
+    "#version 410 core\n"
+    "in vec3 normal;\n"
+    "in vec2 uv;\n"
+    "out vec4 fragColour;\n"
+    "void main() { fragColour = vec4(abs(normal) * 0.8 + vec3(uv, 0.0) * 0.2, 1.0); }\n"));
+  QVERIFY(m_program->link());
+  QVERIFY(m_program->bind());
+  auto gl = m_context.functions();
+  gl->glViewport(0, 0, 512, 512);
+  gl->glEnable(GL_DEPTH_TEST);
+}
+
+void benchRenderLayout::cleanupTestCase()
+{
+  m_program.reset();
+  m_fbo.reset();
+  m_context.doneCurrent();
+}
+
+void benchRenderLayout::models()
+{
+  QTest::addColumn<QString>("model");
+  for (const char* model : {"Face.obj", "Face2.obj", "Suzanne.obj", "mandarin.obj"})
+    QTest::newRow(model) << QString(MODEL_DIR) + model;
+}
+
+void benchRenderLayout::render(const MeshAttributes::Layout _layout)
+{
+  QFETCH(QString, model);
+  Mesh mesh;
+  mesh.setUseCache(false);
+  mesh.setLayout(_layout);
+  QVERIFY(mesh.load(model.toStdString(), [](float){ return true; }));
+
+  // Uploaded once the same way MainScene does, only the draws are timed
+  QOpenGLVertexArrayObject vao;
+  vao.create();
+  vao.bind();
+  MeshVBO vbo;
+  vbo.init();
+  vbo.reset(mesh.getIndexType(), mesh.getNIndicesData(), sizeof(GLfloat), mesh.getNVertData(), mesh.getNUVData(), mesh.getNNormData(), mesh.getNTangentData(),
+            _layout);
+  using namespace MeshAttributes;
+  if (_layout == INTERLEAVED)
+  {
+    vbo.write(mesh.getInterleavedData());
+  }
+  else if (_layout == QUANTIZED)
+  {
+    vbo.write(mesh.getQuantizedData());
+    // Half the float size at most, with errors well below what the models are modelled to
+    const QuantizationError error = mesh.getQuantizationError();
+    qDebug() << vbo.stride() << "bytes per vertex, largest error" << error.position << "units" << error.normal << "degrees" << error.uv << "uv";
+    QVERIFY(error.normal < 0.2f);
+    QVERIFY(error.uv < 0.001f);
+  }
+  else
+  {
+    for (const auto buff : {VERTEX, UV, NORMAL})
+      vbo.write(mesh.getAttribData(buff), buff);
+  }
+  vbo.setIndices(mesh.getIndicesData());
+  for (const auto buff : {VERTEX, UV, NORMAL})
+  {
+    if (vbo.dataAmount(buff) == 0)
+    {
+      m_program->disableAttributeArray(buff);
+      continue;
+    }
+    m_program->enableAttributeArray(buff);
+    m_program->setAttributeBuffer(buff, vbo.type(buff), vbo.offset(buff), vbo.components(buff), vbo.stride());
+  }
+  m_program->setUniformValue("position", QMatrix4x4(glm::value_ptr(mesh.getPositionMatrix())).transposed());
+
+  auto gl = m_context.functions();
+  QBENCHMARK
+  {
+    gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    for (int i = 0; i < s_draws; ++i)
+      gl->glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.getLodIndexCount(0)), vbo.indexType(), nullptr);
+    gl->glFinish();
+  }
+  QCOMPARE(gl->glGetError(), static_cast<GLenum>(GL_NO_ERROR));
+  vao.release();
+}
+
+void benchRenderLayout::bench_planar_data()
+{
+  models();
+}
+
+void benchRenderLayout::bench_planar()
+{
+  render(MeshAttributes::PLANAR);
+}
+
+void benchRenderLayout::bench_interleaved_data()
+{
+  models();
+}
+
+void benchRenderLayout::bench_interleaved()
+{
+  render(MeshAttributes::INTERLEAVED);
+}
+
+void benchRenderLayout::bench_quantized_data()
+{
+  models();
+}
+
+void benchRenderLayout::bench_quantized()
+{
+  render(MeshAttributes::QUANTIZED);
+}
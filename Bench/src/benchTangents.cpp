@@ -0,0 +1,48 @@
+#include "benchTangents.h"
+#include "ObjLoader.h"
+#include "Tangents.h"
+
+void benchTangents::initTestCase()
+{
+  for (const char* model : {"Face.obj", "Face2.obj", "mandarin.obj", "test2.obj"})
+  {
+    MeshStorage data;
+    QVERIFY(ObjLoader::load(QString(QString(MODEL_DIR) + model).toStdString(), data, [](float){ return true; }));
+    QVERIFY(!data.uvs.empty());
+    m_imported[model] = std::move(data);
+  }
+}
+
+void benchTangents::bench_generate_data()
+{
+  QTest::addColumn<QString>("model");
+  for (const auto& imported : m_imported)
+    QTest::newRow(imported.first.toLatin1().constData()) << imported.first;
+}
+
+void benchTangents::bench_generate()
+{
+  QFETCH(QString, model);
+  MeshStorage& data = m_imported[model];
+  QBENCHMARK
+  {
+    Tangents::generate(data);
+  }
+
+  QCOMPARE(data.tangents.size(), data.vertices.size());
+  float lengthError = 0.0f;
+  float normalDot = 0.0f;
+  size_t mirrored = 0;
+  for (size_t v = 0; v < data.tangents.size(); ++v)
+  {
+    const glm::vec3 tangent(data.tangents[v]);
+    lengthError = std::max(lengthError, std::abs(glm::length(tangent) - 1.0f));
+    normalDot = std::max(normalDot, std::abs(glm::dot(tangent, glm::normalize(data.normals[v]))));
+    QVERIFY(data.tangents[v].w == 1.0f || data.tangents[v].w == -1.0f);
+    mirrored += data.tangents[v].w < 0.0f ? 1 : 0;
+  }
+  qDebug() << data.vertices.size() << "vertices," << mirrored << "with mirrored UVs, largest length error" << lengthError
+           << "largest cosine to the normal" << normalDot;
+  QVERIFY(lengthError < 1e-4f);
+  QVERIFY(normalDot < 1e-3f);
+}
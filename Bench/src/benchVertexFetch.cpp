@@ -0,0 +1,97 @@
+#include "benchVertexFetch.h"
+
+void benchVertexFetch::initTestCase()
+{
+  for (const char* model : {"Face.obj", "Face2.obj", "Suzanne.obj", "mandarin.obj"})
+  {
+    std::unique_ptr<Mesh> mesh(new Mesh);
+    mesh->setUseCache(false);
+    mesh->setLayout(MeshAttributes::INTERLEAVED);
+    QVERIFY(mesh->load(QString(QString(MODEL_DIR) + model).toStdString(), [](float){ return true; }));
+    m_meshes[model] = std::move(mesh);
+  }
+}
+
+void benchVertexFetch::models()
+{
+  QTest::addColumn<QString>("model");
+  for (const auto& mesh : m_meshes)
+    QTest::newRow(mesh.first.toLatin1().constData()) << mesh.first;
+}
+
+template<typename Fetch>
+float benchVertexFetch::fetchIndexed(const Mesh &_mesh, Fetch _fetch) const
+{
+  float sum = 0.0f;
+  // Full detail only, like a close up draw
+  const int count = static_cast<int>(_mesh.getLodIndexCount(0));
+  if (_mesh.getIndexType() == GL_UNSIGNED_INT)
+  {
+    auto indices = static_cast<const GLuint*>(_mesh.getIndicesData());
+    for (int i = 0; i < count; ++i)
+      sum += _fetch(indices[i]);
+  }
+  else
+  {
+    auto indices = static_cast<const GLushort*>(_mesh.getIndicesData());
+    for (int i = 0; i < count; ++i)
+      sum += _fetch(indices[i]);
+  }
+  return sum;
+}
+
+void benchVertexFetch::bench_planar_data()
+{
+  models();
+}
+
+void benchVertexFetch::bench_planar()
+{
+  QFETCH(QString, model);
+  const Mesh& mesh = *m_meshes[model];
+  const GLfloat* vertices = mesh.getVertexData();
+  const GLfloat* normals = mesh.getNormalsData();
+  const GLfloat* uvs = mesh.getNUVData() != 0 ? mesh.getUVsData() : nullptr;
+  float sum = 0.0f;
+  QBENCHMARK
+  {
+    sum += fetchIndexed(mesh, [=](const size_t _i)
+    {
+      float attribs = vertices[3 * _i] + vertices[3 * _i + 1] + vertices[3 * _i + 2] +
+                      normals[3 * _i] + normals[3 * _i + 1] + normals[3 * _i + 2];
+      if (uvs != nullptr)
+        attribs += uvs[2 * _i] + uvs[2 * _i + 1];
+      return attribs;
+    });
+  }
+  QVERIFY(sum == sum);
+}
+
+void benchVertexFetch::bench_interleaved_data()
+{
+  models();
+}
+
+void benchVertexFetch::bench_interleaved()
+{
+  QFETCH(QString, model);
+  const Mesh& mesh = *m_meshes[model];
+  const GLfloat* data = mesh.getInterleavedData();
+  const bool hasUVs = mesh.getNUVData() != 0;
+  const size_t stride = hasUVs ? 8 : 6;
+  float sum = 0.0f;
+  QBENCHMARK
+  {
+    sum += fetchIndexed(mesh, [=](const size_t _i)
+    {
+      const GLfloat* vert = data + stride * _i;
+      float attribs = vert[0] + vert[1] + vert[2];
+      if (hasUVs)
+        attribs += vert[3] + vert[4] + vert[5] + vert[6] + vert[7];
+      else
+        attribs += vert[3] + vert[4] + vert[5];
+      return attribs;
+    });
+  }
+  QVERIFY(sum == sum);
+}
@@ -0,0 +1,118 @@
+#ifndef DRAWBATCHES_H
+#define DRAWBATCHES_H
+
+#include <QOpenGLFunctions>
+#include <vector>
+#include "mat4x4.hpp"
+#include "Meshlets.h"
+
+//-------------------------------------------------------------------------------------------------------
+/// @brief Groups the objects drawn in a frame by what they are drawn with, so all objects sharing a mesh,
+/// material and level of detail go out in one instanced draw. The model and normal matrices of every
+/// object are gathered into one array in draw order, uploaded as the per instance buffer, and each batch
+/// reads a run of it from its first instance.
+//-------------------------------------------------------------------------------------------------------
+class DrawBatches
+{
+public:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief What objects are drawn with, they only share a batch when all of it matches.
+  //-----------------------------------------------------------------------------------------------------
+  struct Key
+  {
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Batches are drawn pass by pass, so a later pass such as a selection outline goes over the
+    /// objects of earlier ones. Within a pass they are sorted by material then culling, so shaders and
+    /// state change least and batches a multi draw can submit together follow each other.
+    //---------------------------------------------------------------------------------------------------
+    size_t pass = 0;
+    size_t material = 0;
+    size_t geo = 0;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief The level of detail, each level is its own index range.
+    //---------------------------------------------------------------------------------------------------
+    size_t level = 0;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Whether back faces are culled, mirroring transforms turn them to the front.
+    //---------------------------------------------------------------------------------------------------
+    bool cullBackFaces = false;
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief One row of the per instance buffer, read at the MeshAttributes instance locations.
+  //-----------------------------------------------------------------------------------------------------
+  struct Instance
+  {
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::mat4 normal = glm::mat4(1.0f);
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief A run of instances drawn with one key.
+  //-----------------------------------------------------------------------------------------------------
+  struct Batch
+  {
+    Key key;
+    GLuint firstInstance = 0;
+    GLuint instanceCount = 0;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief The index ranges left after meshlet culling when the batch holds one object. Batches of
+    /// several draw their whole level, the instances' ranges differ and can't share a draw.
+    //---------------------------------------------------------------------------------------------------
+    size_t firstRange = 0;
+    size_t rangeCount = 0;
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to start a new frame, the allocations are kept.
+  //-----------------------------------------------------------------------------------------------------
+  void clear();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to add an object to draw.
+  /// @param [in] _key is what the object is drawn with.
+  /// @param [in] _instance holds the object's matrices.
+  /// @param [in] _ranges are the object's index ranges after meshlet culling, none skips the object.
+  //-----------------------------------------------------------------------------------------------------
+  void add(const Key &_key, const Instance &_instance, const std::vector<Meshlets::DrawRange> &_ranges);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to sort the objects added since clear into batches and their instances into draw order.
+  //-----------------------------------------------------------------------------------------------------
+  void build();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the batches made by build.
+  /// @return The batches in the order to draw them.
+  //-----------------------------------------------------------------------------------------------------
+  const std::vector<Batch>& batches() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the per instance data made by build.
+  /// @return The instances of all batches, to upload as one buffer.
+  //-----------------------------------------------------------------------------------------------------
+  const std::vector<Instance>& instances() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the index ranges of a batch holding one object.
+  /// @param [in] _index is the range, from the batch's firstRange.
+  /// @return The range.
+  //-----------------------------------------------------------------------------------------------------
+  const Meshlets::DrawRange& range(const size_t _index) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get how many draws the objects would take one by one, a draw per index range.
+  /// @return The draws without instancing, to compare with the batches.
+  //-----------------------------------------------------------------------------------------------------
+  size_t separateDraws() const noexcept;
+
+private:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief An object added since clear, with where its data was kept.
+  //-----------------------------------------------------------------------------------------------------
+  struct Entry
+  {
+    Key key;
+    size_t instance = 0;
+    size_t firstRange = 0;
+    size_t rangeCount = 0;
+  };
+  std::vector<Entry> m_entries;
+  std::vector<Instance> m_added;
+  std::vector<Meshlets::DrawRange> m_ranges;
+  std::vector<Instance> m_instances;
+  std::vector<Batch> m_batches;
+};
+
+#endif // DRAWBATCHES_H
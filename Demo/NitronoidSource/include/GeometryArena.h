@@ -0,0 +1,158 @@
+#ifndef GEOMETRYARENA_H
+#define GEOMETRYARENA_H
+
+#include "MeshVBO.h"
+#include <array>
+#include <memory>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------
+/// @brief Shared vertex and element buffers every mesh is uploaded into once, then drawn from by range.
+/// Meshes with the same attributes, layout and index type go into the same page, a pair of buffers large
+/// enough for many meshes, so the buffers only change between meshes of different formats. Draws add
+/// the allocation's base vertex to each index, so 16 bit indices keep working in a full page. Pages are
+/// never moved or grown, a mesh that doesn't fit the free space of any page gets a new one.
+//-------------------------------------------------------------------------------------------------------
+class GeometryArena
+{
+public:
+  class Page;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief A run of vertices and one of indices in a page holding one mesh. The runs go back to the page
+  /// when the allocation is destroyed, meshes keep theirs in a shared pointer in MeshStorage.
+  //-----------------------------------------------------------------------------------------------------
+  class Allocation
+  {
+  public:
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Constructed by GeometryArena::upload.
+    //---------------------------------------------------------------------------------------------------
+    Allocation(const std::shared_ptr<Page> &_page, const int _firstVertex, const int _firstIndex, const int _nIndices,
+               const std::array<int, 4> &_amountOfData);
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Gives the runs back to the page, without GL calls so any thread may drop the last owner.
+    //---------------------------------------------------------------------------------------------------
+    ~Allocation();
+    Allocation(const Allocation&) = delete;
+    Allocation& operator=(const Allocation&) = delete;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Used to get the page's buffers, to bind and to set the attribute pointers from.
+    /// @return The buffers, shared with every allocation of the page.
+    //---------------------------------------------------------------------------------------------------
+    MeshVBO& buffers() const noexcept;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Used to get the arena the allocation was made in.
+    /// @return The arena, only to compare with.
+    //---------------------------------------------------------------------------------------------------
+    const GeometryArena* arena() const noexcept;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Used to get the page vertex the mesh's vertex 0 is stored at, the base vertex of draws.
+    /// @return The first vertex of the run.
+    //---------------------------------------------------------------------------------------------------
+    GLint baseVertex() const noexcept;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Used to get the page index the mesh's index 0 is stored at, mesh index ranges start there.
+    /// @return The first index of the run.
+    //---------------------------------------------------------------------------------------------------
+    GLuint firstIndex() const noexcept;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Used to get the byte offset of a mesh index in the page's element buffer, for draw calls.
+    /// @param [in] _index is the index, counted from the mesh's first.
+    /// @return The offset, as the pointer draw calls take.
+    //---------------------------------------------------------------------------------------------------
+    const void* indexOffset(const GLuint _index) const noexcept;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Used to get the amount of the mesh's indices.
+    /// @return The length of the index run.
+    //---------------------------------------------------------------------------------------------------
+    int indexAmount() const noexcept;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Used to get the amount of data elements the mesh uploaded for an attribute.
+    /// @return The number of floats the attribute's array held, 0 for attributes the mesh doesn't have.
+    //---------------------------------------------------------------------------------------------------
+    int dataAmount(const MeshAttributes::Attribute _section) const noexcept;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Used to get the type the indices are stored as, the page's.
+    /// @return GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+    //---------------------------------------------------------------------------------------------------
+    GLenum indexType() const noexcept;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Used to get how the vertices are arranged, the page's.
+    /// @return INTERLEAVED or QUANTIZED.
+    //---------------------------------------------------------------------------------------------------
+    MeshAttributes::Layout layout() const noexcept;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Used to get the part of the page the mesh takes.
+    /// @return The size of both runs in bytes.
+    //---------------------------------------------------------------------------------------------------
+    size_t byteSize() const noexcept;
+
+  private:
+    std::shared_ptr<Page> m_page;
+    int m_firstVertex = 0;
+    int m_firstIndex = 0;
+    int m_numIndices = 0;
+    std::array<int, 4> m_amountOfData = {{0,0,0,0}};
+  };
+
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to put a mesh into the arena, in the free space of a page of its format or a new page.
+  /// A GL context must be current. The arguments follow MeshVBO::reset.
+  /// @param [in] _indexType is GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+  /// @param [in] _indices is a pointer to _nIndices indices of _indexType.
+  /// @param [in] _nIndices is the amount of indices.
+  /// @param [in] _vertices is a pointer to the vertices, arranged in _layout.
+  /// @param [in] _nVert, _nUV, _nNorm and _nTangent are the amounts of floats of each attribute in the
+  /// mesh's arrays, 0 for attributes it doesn't have.
+  /// @param [in] _layout is INTERLEAVED or QUANTIZED, planar sections can't be shared between meshes.
+  /// @return The allocation, nullptr for an empty mesh or the planar layout.
+  //-----------------------------------------------------------------------------------------------------
+  std::shared_ptr<Allocation> upload(
+      const GLenum _indexType,
+      const void *_indices,
+      const int _nIndices,
+      const void *_vertices,
+      const int _nVert,
+      const int _nUV,
+      const int _nNorm,
+      const int _nTangent,
+      const MeshAttributes::Layout _layout
+      );
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the amount of pages, pairs of buffers the draws switch between.
+  /// @return The number of pages made so far.
+  //-----------------------------------------------------------------------------------------------------
+  size_t pageCount() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the memory the pages take on the GPU, used or not.
+  /// @return The size in bytes of all pages.
+  //-----------------------------------------------------------------------------------------------------
+  size_t byteSize() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the memory the live allocations take on the GPU.
+  /// @return The size in bytes of all allocations.
+  //-----------------------------------------------------------------------------------------------------
+  size_t usedBytes() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get how much has been written to the GPU, to tell how much a frame uploaded.
+  /// @return The bytes written by every upload so far.
+  //-----------------------------------------------------------------------------------------------------
+  size_t uploadedBytes() const noexcept;
+
+private:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Vertices and indices a new page has room for, unless the mesh it is made for needs more.
+  //-----------------------------------------------------------------------------------------------------
+  static constexpr int s_pageVertices = 1 << 18;
+  static constexpr int s_pageIndices = 1 << 20;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Every page made, kept when empty for later meshes of the same format.
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<std::shared_ptr<Page>> m_pages;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Bytes written by every upload.
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_uploadedBytes = 0;
+};
+
+#endif // GEOMETRYARENA_H
@@ -0,0 +1,85 @@
+#ifndef INDIRECTDRAWS_H
+#define INDIRECTDRAWS_H
+
+#include <QOpenGLFunctions>
+#include <vector>
+#include "DrawBatches.h"
+#include "GeometryArena.h"
+
+class Mesh;
+
+//-------------------------------------------------------------------------------------------------------
+/// @brief Turns the batches of a frame into indirect draw commands, so every batch drawn with the same
+/// material, culling state and geometry page is submitted with one glMultiDrawElementsIndirect. The
+/// commands of all buckets are kept in one array in draw order, uploaded as the indirect buffer, and each
+/// bucket draws a run of it. A command's base instance points at its batch's instances, so the per
+/// instance matrices are fetched for each command as they are for an instanced draw.
+//-------------------------------------------------------------------------------------------------------
+class IndirectDraws
+{
+public:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief One draw, laid out as the DrawElementsIndirectCommand glMultiDrawElementsIndirect reads.
+  //-----------------------------------------------------------------------------------------------------
+  struct Command
+  {
+    GLuint count = 0;
+    GLuint instanceCount = 0;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief The first index in the page's element buffer, counted in indices rather than bytes.
+    //---------------------------------------------------------------------------------------------------
+    GLuint firstIndex = 0;
+    GLint baseVertex = 0;
+    GLuint baseInstance = 0;
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief A run of commands submitted together.
+  //-----------------------------------------------------------------------------------------------------
+  struct Bucket
+  {
+    //---------------------------------------------------------------------------------------------------
+    /// @brief The key of the first batch in the bucket, the others share its pass, material and culling.
+    //---------------------------------------------------------------------------------------------------
+    DrawBatches::Key key;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief The range of the first batch's mesh, every mesh of the bucket is in the same page.
+    //---------------------------------------------------------------------------------------------------
+    const GeometryArena::Allocation* range = nullptr;
+    size_t firstCommand = 0;
+    size_t commandCount = 0;
+    //---------------------------------------------------------------------------------------------------
+    /// @brief Indices drawn by the bucket over all instances.
+    //---------------------------------------------------------------------------------------------------
+    size_t indices = 0;
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to start a new frame, the allocations are kept.
+  //-----------------------------------------------------------------------------------------------------
+  void clear();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to add the commands of a batch, in the order batches are drawn. A batch holding one
+  /// object gives a command per index range left after meshlet culling, a batch of several one command
+  /// for its whole level.
+  /// @param [in] _batches holds the batch, for its ranges.
+  /// @param [in] _batch is the batch to draw.
+  /// @param [in] _mesh is the batch's mesh.
+  /// @param [in] _range is where the mesh was uploaded.
+  //-----------------------------------------------------------------------------------------------------
+  void add(const DrawBatches &_batches, const DrawBatches::Batch &_batch, const Mesh &_mesh, const GeometryArena::Allocation &_range);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the commands added since clear.
+  /// @return The commands of all buckets, to upload as one buffer.
+  //-----------------------------------------------------------------------------------------------------
+  const std::vector<Command>& commands() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the buckets added since clear.
+  /// @return The buckets in the order to draw them.
+  //-----------------------------------------------------------------------------------------------------
+  const std::vector<Bucket>& buckets() const noexcept;
+
+private:
+  std::vector<Command> m_commands;
+  std::vector<Bucket> m_buckets;
+};
+
+#endif // INDIRECTDRAWS_H
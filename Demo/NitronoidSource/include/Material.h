@@ -71,6 +71,13 @@ public:
   virtual void handleKey(QKeyEvent* io_event, QOpenGLContext* io_context);
 
 protected:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to pass the scene matrices to the shader. The view projection is a uniform, the model
+  /// and normal matrices are per instance attributes, set here as the constant that draws without an
+  /// instance buffer read.
+  /// @param [io] io_shader is the shader program of this material.
+  //-----------------------------------------------------------------------------------------------------
+  void setMatrices(QOpenGLShaderProgram* io_shader);
   //-----------------------------------------------------------------------------------------------------
   /// @brief A pointer to the central Shader Library.
   //-----------------------------------------------------------------------------------------------------
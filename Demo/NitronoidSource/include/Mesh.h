@@ -4,14 +4,191 @@
 #include <QOpenGLFunctions>
 #include <vector>
 #include <string>
-#include "MeshVBO.h"
+#include <memory>
+#include "GeometryArena.h"
+#include "MeshOptimizer.h"
 #include "vec3.hpp"
 #include "vec2.hpp"
+#include "vec4.hpp"
+#include "mat4x4.hpp"
 #include "BaseMesh.h"
 
+//-----------------------------------------------------------------------------------------------------
+/// @brief One part of a mesh file, drawn from a range of the shared index array.
+//-----------------------------------------------------------------------------------------------------
+struct SubMesh
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The range of the index array holding the part's triangles.
+  //-----------------------------------------------------------------------------------------------------
+  GLuint firstIndex = 0;
+  GLuint indexCount = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The meshlets covering the part's index range in order, none until the optimizer builds them.
+  //-----------------------------------------------------------------------------------------------------
+  GLuint firstMeshlet = 0;
+  GLuint meshletCount = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Bounds of the vertices the part uses.
+  //-----------------------------------------------------------------------------------------------------
+  glm::vec3 min = glm::vec3(0.0f, 0.0f, 0.0f);
+  glm::vec3 max = glm::vec3(0.0f, 0.0f, 0.0f);
+};
+
+//-----------------------------------------------------------------------------------------------------
+/// @brief A small cluster of neighbouring triangles, culled on its own before drawing. See Meshlets.
+//-----------------------------------------------------------------------------------------------------
+struct Meshlet
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The range of the index array holding the meshlet's triangles.
+  //-----------------------------------------------------------------------------------------------------
+  GLuint firstIndex = 0;
+  GLuint indexCount = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Sphere around the meshlet's vertices, in model units.
+  //-----------------------------------------------------------------------------------------------------
+  glm::vec3 centre = glm::vec3(0.0f, 0.0f, 0.0f);
+  float radius = 0.0f;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Cone around the meshlet's face normals, moved back along its axis to an apex behind every
+  /// triangle. The whole meshlet faces away from any eye that sees the apex within acos(coneCutoff) of
+  /// the axis, a cutoff of 1 marks normals too spread out for that to happen.
+  //-----------------------------------------------------------------------------------------------------
+  glm::vec3 coneApex = glm::vec3(0.0f, 0.0f, 0.0f);
+  glm::vec3 coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+  float coneCutoff = 1.0f;
+};
+
+//-----------------------------------------------------------------------------------------------------
+/// @brief One level of detail of a mesh, a run of consecutive submeshes with one range per part of the
+/// full detail mesh. Level 0 is the imported mesh, each further level has about half the triangles.
+//-----------------------------------------------------------------------------------------------------
+struct MeshLod
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The submeshes drawn for this level.
+  //-----------------------------------------------------------------------------------------------------
+  GLuint firstSubMesh = 0;
+  GLuint subMeshCount = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Largest distance between this level's surface and the full detail one, in model units.
+  //-----------------------------------------------------------------------------------------------------
+  float error = 0.0f;
+};
+
+//-----------------------------------------------------------------------------------------------------
+/// @brief Largest differences between the quantized attributes and the originals.
+//-----------------------------------------------------------------------------------------------------
+struct QuantizationError
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Distance between original and decoded positions, in model units.
+  //-----------------------------------------------------------------------------------------------------
+  float position = 0.0f;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Angle between original and decoded normals, in degrees.
+  //-----------------------------------------------------------------------------------------------------
+  float normal = 0.0f;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Difference between original and decoded UV components.
+  //-----------------------------------------------------------------------------------------------------
+  float uv = 0.0f;
+};
+
+//-----------------------------------------------------------------------------------------------------
+/// @brief The arrays of a mesh, shared by all meshes imported with identical content.
+//-----------------------------------------------------------------------------------------------------
+struct MeshStorage
+{
+  std::vector<glm::vec3> vertices;
+  std::vector<glm::vec3> normals;
+  std::vector<glm::vec2> uvs;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Tangent of each vertex in xyz and the handedness of its UVs in w, 1 or -1, so the bitangent is
+  /// w * cross(normal, tangent). Only generated by the TANGENTS pass for meshes with UVs. See Tangents.
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<glm::vec4> tangents;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Triangle indices, only one of the two is filled. 16 bit indices are used whenever every
+  /// vertex can be reached with them, larger meshes use 32 bit ones.
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<GLushort> indices;
+  std::vector<GLuint> indices32;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Every part of the file in import order, their index ranges follow each other and cover the
+  /// whole index array, so any run of consecutive parts is drawn with one call.
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<SubMesh> subMeshes;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Levels of detail from the finest, there is always at least level 0 covering the imported
+  /// parts. Coarser levels use the same vertices with their own index ranges after those of level 0.
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<MeshLod> lods;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Meshlets of every submesh, each submesh's run covers its index range in order.
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<Meshlet> meshlets;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Position, UV, normal and tangent of each vertex next to each other, only built once a mesh
+  /// using the storage asks for the interleaved layout.
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<GLfloat> interleaved;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Quantized vertices as 4 byte words, 4 per vertex with UVs and 3 without, plus 1 with tangents,
+  /// only built once a mesh using the storage asks for the quantized layout. Words hold little endian
+  /// shorts and halves.
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<GLuint> quantized;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief How far the quantized vertices are from the originals, set with quantized.
+  //-----------------------------------------------------------------------------------------------------
+  QuantizationError quantizationError;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Bounds of all vertices.
+  //-----------------------------------------------------------------------------------------------------
+  glm::vec3 min = glm::vec3(0.0f, 0.0f, 0.0f);
+  glm::vec3 max = glm::vec3(0.0f, 0.0f, 0.0f);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Sphere around all vertices, close to the smallest one.
+  //-----------------------------------------------------------------------------------------------------
+  glm::vec3 centre = glm::vec3(0.0f, 0.0f, 0.0f);
+  float radius = 0.0f;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Hash of all arrays, 0 while empty.
+  //-----------------------------------------------------------------------------------------------------
+  size_t hash = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Where the arrays are in a GeometryArena, one range per uploaded layout made by the first
+  /// Mesh::upload in that layout (planar meshes upload interleaved). Meshes sharing the storage draw from
+  /// the same ranges even when they ask for different layouts, and so do copies of it. A range is freed
+  /// with the last of them.
+  //-----------------------------------------------------------------------------------------------------
+  std::shared_ptr<GeometryArena::Allocation> gpu[3];
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Set while the vertex and index arrays are released, their sizes are then read from gpu.
+  //-----------------------------------------------------------------------------------------------------
+  bool released = false;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get any uploaded range, they all hold the same index type and amounts.
+  /// @return The first uploaded range, nullptr if the storage was never uploaded.
+  //-----------------------------------------------------------------------------------------------------
+  const GeometryArena::Allocation* uploaded() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to store imported indices in the smallest type that can address every vertex.
+  /// @param [in] _indices are the indices, the vertices must already be set.
+  //-----------------------------------------------------------------------------------------------------
+  void setIndices(std::vector<GLuint> &&_indices);
+};
+
 class Mesh : public BaseMesh
 {
 public:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Where the vertex and index arrays are kept once they are in GPU buffers. KEEP_ARRAYS leaves
+  /// them in system memory too, GPU_ONLY releases them after upload.
+  //-----------------------------------------------------------------------------------------------------
+  enum Residency { KEEP_ARRAYS, GPU_ONLY };
   //-----------------------------------------------------------------------------------------------------
   /// @brief Virtual default destructor.
   //-----------------------------------------------------------------------------------------------------
@@ -24,14 +201,82 @@ public:
   //void load(const std::string &_fname, const size_t _meshNum = 0);
   virtual void load(const std::string &_fname)override;
   //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to load a mesh from a file path, reporting import progress.
+  /// @param [in] _fname is the path to the mesh file.
+  /// @param [in] _progress is called with the completed fraction, returning false aborts the import.
+  /// @return false if the import failed or was aborted.
+  //-----------------------------------------------------------------------------------------------------
+  virtual bool load(const std::string &_fname, const std::function<bool(float)> &_progress)override;
+  //-----------------------------------------------------------------------------------------------------
   /// @brief Used to reset the mesh arrays.
   //-----------------------------------------------------------------------------------------------------
   virtual void reset()override;
   //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the memory held by the mesh arrays.
+  /// @return The capacity of all arrays in bytes.
+  //-----------------------------------------------------------------------------------------------------
+  virtual size_t residentBytes() const override;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the hash of the mesh arrays, computed at import.
+  /// @return The hash, 0 if the mesh is empty.
+  //-----------------------------------------------------------------------------------------------------
+  virtual size_t contentHash() const override;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to make this mesh use the arrays of another mesh with identical content.
+  /// @param [in] _other is the mesh to share with, it must be a Mesh.
+  /// @return false if the content differs, the mesh is left unchanged.
+  //-----------------------------------------------------------------------------------------------------
+  virtual bool shareStorage(const BaseMesh &_other) override;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to identify the arrays this mesh uses.
+  /// @return The address of the shared storage block.
+  //-----------------------------------------------------------------------------------------------------
+  virtual const void* storageID() const override;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the bounding box and sphere of all vertices, computed at import.
+  /// @return The bounds, empty if the mesh has no vertices.
+  //-----------------------------------------------------------------------------------------------------
+  virtual Bounds getBounds() const override;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the memory the mesh takes in the arena it was uploaded to.
+  /// @return The size of its vertices and indices in bytes, 0 before upload.
+  //-----------------------------------------------------------------------------------------------------
+  virtual size_t gpuBytes() const override;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to put the mesh in the shared buffers of an arena, only done the first time or when it was
+  /// put in another arena or layout. Planar meshes are uploaded interleaved, the arena can't share planar
+  /// sections between meshes. A GL context must be current. GPU_ONLY meshes release their arrays afterwards.
+  /// @param [in,out] io_arena is the arena to upload to.
+  /// @return The range to draw from, nullptr if the mesh is empty or its arrays can't be fetched.
+  //-----------------------------------------------------------------------------------------------------
+  const GeometryArena::Allocation* upload(GeometryArena &io_arena);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to drop the vertex and index arrays of an uploaded mesh from system memory. Level of
+  /// detail, meshlet and bounds data stays, so the mesh can still be culled and drawn.
+  /// @note Meshes sharing the storage lose the arrays too, they all draw from the same buffers.
+  //-----------------------------------------------------------------------------------------------------
+  void releaseArrays();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the arrays back after they were released, before any CPU access such as picking.
+  /// They are read from the mesh cache, or imported again from the source file without one.
+  /// @return false if they could not be fetched, or the source file no longer holds the same mesh.
+  //-----------------------------------------------------------------------------------------------------
+  bool fetchArrays();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to check whether the vertex and index arrays are in system memory.
+  /// @return false while they are released.
+  //-----------------------------------------------------------------------------------------------------
+  bool hasArrays() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
   /// @brief Gets a pointer to the first data element in the indices array for use with openGL buffers.
-  /// @return A pointer to the first element in the indices array.
+  /// @return A pointer to the first element in the indices array, of the type given by getIndexType.
+  //-----------------------------------------------------------------------------------------------------
+  const void *getIndicesData() const noexcept;
   //-----------------------------------------------------------------------------------------------------
-  const GLushort *getIndicesData() const noexcept;
+  /// @brief Used to get the type of the indices, chosen per mesh at import.
+  /// @return GL_UNSIGNED_SHORT, or GL_UNSIGNED_INT for meshes with more than 65536 vertices.
+  //-----------------------------------------------------------------------------------------------------
+  GLenum getIndexType() const noexcept;
   //-----------------------------------------------------------------------------------------------------
   /// @brief Gets a pointer to the first data element in the vertex array for use with openGL buffers.
   /// @return A pointer to the first element in the vertex array.
@@ -48,13 +293,51 @@ public:
   //-----------------------------------------------------------------------------------------------------
   const GLfloat* getUVsData() const noexcept;
   //-----------------------------------------------------------------------------------------------------
+  /// @brief Gets a pointer to the first data element in the tangent array for use with openGL buffers.
+  /// @return A pointer to the first element in the tangent array, 4 floats per vertex.
+  //-----------------------------------------------------------------------------------------------------
+  const GLfloat* getTangentsData() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
   /// @brief Gets a pointer to the first data element in the specified attribute array for use with
   /// openGL buffers.
   /// @return A pointer to the first element in an attribute array.
   //-----------------------------------------------------------------------------------------------------
   const GLfloat* getAttribData(const MeshAttributes::Attribute _attrib) const noexcept;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Used to the the amount of face indices.
+  /// @brief Gets a pointer to the interleaved vertex data for use with openGL buffers.
+  /// @return A pointer to getNData elements, null unless the mesh uses the interleaved layout.
+  //-----------------------------------------------------------------------------------------------------
+  const GLfloat* getInterleavedData() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Gets a pointer to the quantized vertex data for use with openGL buffers.
+  /// @return A pointer to the packed vertices, null unless the mesh uses the quantized layout.
+  //-----------------------------------------------------------------------------------------------------
+  const GLuint* getQuantizedData() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get how much precision quantizing lost.
+  /// @return The largest errors, all 0 unless the mesh uses the quantized layout.
+  //-----------------------------------------------------------------------------------------------------
+  QuantizationError getQuantizationError() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the transform from stored positions to model space, to be folded into the model
+  /// matrix. Quantized positions are fractions of the bounds, so no shader needs to decode them.
+  /// @return The bounds transform for the quantized layout, identity otherwise.
+  //-----------------------------------------------------------------------------------------------------
+  glm::mat4 getPositionMatrix() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to choose how the mesh is arranged in vertex buffers, planar by default. The interleaved
+  /// or quantized copy is built here and after every load, so it costs its memory once rather than per
+  /// upload.
+  /// @param [in] _layout is the layout to use.
+  //-----------------------------------------------------------------------------------------------------
+  void setLayout(const MeshAttributes::Layout _layout);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get how the mesh is arranged in vertex buffers.
+  /// @return The layout, to pass to MeshVBO::reset.
+  //-----------------------------------------------------------------------------------------------------
+  MeshAttributes::Layout getLayout() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to the the amount of face indices, every level of detail included.
   /// @return The size of our indices array.
   //-----------------------------------------------------------------------------------------------------
   int getNIndicesData() const noexcept;
@@ -74,28 +357,124 @@ public:
   //-----------------------------------------------------------------------------------------------------
   int getNUVData() const noexcept;
   //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to the the amount of tangent data elements.
+  /// @return The size of our tangent array, 0 unless the mesh was loaded with the TANGENTS pass.
+  //-----------------------------------------------------------------------------------------------------
+  int getNTangentData() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
   /// @brief Used to the the amount of data elements across all arrays.
   /// @return The size of our data arrays combined.
   //-----------------------------------------------------------------------------------------------------
   int getNData() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to check where the last load got its data from.
+  /// @return true if the last load read the mesh cache instead of importing the file.
+  //-----------------------------------------------------------------------------------------------------
+  bool loadedFromCache() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the amount of index ranges, the parts the mesh file held followed by the parts
+  /// of every coarser level of detail.
+  /// @return The number of submeshes, at least 1 once loaded.
+  //-----------------------------------------------------------------------------------------------------
+  size_t getSubMeshCount() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the draw range and bounds of one part.
+  /// @param [in] _index is the submesh, in import order.
+  /// @return The submesh.
+  //-----------------------------------------------------------------------------------------------------
+  const SubMesh& getSubMesh(const size_t _index) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the amount of levels of detail.
+  /// @return The amount of levels, 1 when no coarser levels were built and 0 for an empty mesh.
+  //-----------------------------------------------------------------------------------------------------
+  size_t getLodCount() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get a level of detail.
+  /// @param [in] _level is the level, 0 is the full detail mesh.
+  /// @return The submeshes to draw for the level and its error.
+  //-----------------------------------------------------------------------------------------------------
+  const MeshLod& getLod(const size_t _level) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get how many indices a level of detail draws, its parts follow each other so this is
+  /// one range from the level's first submesh.
+  /// @param [in] _level is the level, 0 is the full detail mesh.
+  /// @return The amount of indices of all the level's submeshes.
+  //-----------------------------------------------------------------------------------------------------
+  GLuint getLodIndexCount(const size_t _level) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get a meshlet, the ones of a part are listed by its SubMesh.
+  /// @param [in] _index is the meshlet.
+  /// @return The meshlet's index range and culling bounds.
+  //-----------------------------------------------------------------------------------------------------
+  const Meshlet& getMeshlet(const size_t _index) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the bounds of all vertices.
+  /// @return The smallest corner of the bounds.
+  //-----------------------------------------------------------------------------------------------------
+  const glm::vec3& getMin() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get the bounds of all vertices.
+  /// @return The largest corner of the bounds.
+  //-----------------------------------------------------------------------------------------------------
+  const glm::vec3& getMax() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to choose whether loads read and write the mesh cache, on by default.
+  /// @param [in] _use is false to always import the file.
+  //-----------------------------------------------------------------------------------------------------
+  void setUseCache(const bool _use) noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to choose whether OBJ files go through the native importer, on by default.
+  /// @param [in] _use is false to import OBJ files with Assimp like every other format.
+  //-----------------------------------------------------------------------------------------------------
+  void setNativeObj(const bool _use) noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to choose how loads prepare the imported mesh for the GPU, levels of detail, meshlets,
+  /// vertex cache and vertex fetch by default. The overdraw pass is left to meshes that are mostly seen from outside,
+  /// and tangents to meshes drawn with normal maps.
+  /// @param [in] _passes are MeshOptimizer::Pass flags, 0 keeps the importer's order.
+  //-----------------------------------------------------------------------------------------------------
+  void setOptimization(const unsigned int _passes) noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to choose what happens to the arrays on upload, KEEP_ARRAYS by default.
+  /// @param [in] _mode is GPU_ONLY to release them once they are in GPU buffers.
+  //-----------------------------------------------------------------------------------------------------
+  void setResidency(const Residency _mode) noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to get what happens to the arrays on upload.
+  /// @return The mode set by setResidency.
+  //-----------------------------------------------------------------------------------------------------
+  Residency getResidency() const noexcept;
 
 protected:
   //-----------------------------------------------------------------------------------------------------
-  /// @brief m_vertices contains the vertices
+  /// @brief m_data contains the vertices, normals, UVs and indices, possibly shared with other meshes
+  //-----------------------------------------------------------------------------------------------------
+  std::shared_ptr<MeshStorage> m_data = std::make_shared<MeshStorage>();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief m_fromCache is set when the last load read the mesh cache
+  //-----------------------------------------------------------------------------------------------------
+  bool m_fromCache = false;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief m_useCache enables the mesh cache for loads
+  //-----------------------------------------------------------------------------------------------------
+  bool m_useCache = true;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief m_nativeObj sends OBJ files to the native importer instead of Assimp
   //-----------------------------------------------------------------------------------------------------
-  std::vector<glm::vec3> m_vertices;
+  bool m_nativeObj = true;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief m_normals contains the normals
+  /// @brief m_optimization holds the MeshOptimizer passes loads run
   //-----------------------------------------------------------------------------------------------------
-  std::vector<glm::vec3> m_normals;
+  unsigned int m_optimization = MeshOptimizer::LOD | MeshOptimizer::MESHLETS | MeshOptimizer::VERTEX_CACHE |
+                                MeshOptimizer::VERTEX_FETCH;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief m_uvs contains the UVs
+  /// @brief m_layout is how the mesh is arranged in vertex buffers
   //-----------------------------------------------------------------------------------------------------
-  std::vector<glm::vec2> m_uvs;
+  MeshAttributes::Layout m_layout = MeshAttributes::PLANAR;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief m_indices contains the indices
+  /// @brief m_residency is what upload does with the arrays
   //-----------------------------------------------------------------------------------------------------
-  std::vector<GLushort> m_indices;
+  Residency m_residency = KEEP_ARRAYS;
 
 };
 
@@ -0,0 +1,42 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <string>
+#include "Mesh.h"
+
+//-------------------------------------------------------------------------------------------------------
+/// @brief On-disk cache of imported meshes. Each entry is a blob holding the bounds, positions, normals,
+/// UVs, indices, submesh ranges, levels of detail and meshlets of one mesh in the layout they are
+/// uploaded in, stored next to the model in a cache folder and named after a hash of the model file, the
+/// importer, the import flags and the optimizer passes. Any change to the model or the settings gives a new
+/// name, so entries never need invalidating.
+//-------------------------------------------------------------------------------------------------------
+namespace MeshCache
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to find the cache entry of a model file.
+  /// @param [in] _fname is the path to the model file.
+  /// @param [in] _nativeObj is set if OBJ files go to the native importer instead of Assimp.
+  /// @param [in] _importFlags are the Assimp post processing flags the model is imported with.
+  /// @param [in] _passes are the MeshOptimizer passes run after the import.
+  /// @return The path of the cache entry, empty if the model file could not be read.
+  //-----------------------------------------------------------------------------------------------------
+  std::string entryPath(const std::string &_fname, const bool _nativeObj, const unsigned int _importFlags, const unsigned int _passes);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to read a cache entry by mapping it.
+  /// @param [in] _entry is the path returned by entryPath.
+  /// @param [out] o_data receives the mesh arrays, bounds and hash.
+  /// @return false if the entry is missing or damaged, or any of its ranges falls outside its arrays, o_data
+  /// is then left unchanged.
+  //-----------------------------------------------------------------------------------------------------
+  bool read(const std::string &_entry, MeshStorage &o_data);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to store an imported mesh, safe to call from several threads for the same entry.
+  /// @param [in] _entry is the path returned by entryPath.
+  /// @param [in] _data is the imported mesh.
+  /// @return false if the entry could not be written.
+  //-----------------------------------------------------------------------------------------------------
+  bool write(const std::string &_entry, const MeshStorage &_data);
+}
+
+#endif // MESHCACHE_H
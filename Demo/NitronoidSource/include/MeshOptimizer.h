@@ -0,0 +1,80 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include <QOpenGLFunctions>
+#include <vector>
+#include <cstddef>
+
+struct MeshStorage;
+
+//-------------------------------------------------------------------------------------------------------
+/// @brief Reorders imported meshes for the GPU without changing what they look like. Triangles are
+/// reordered within each submesh with Tipsify (Sander et al. 2007) so that recently transformed vertices
+/// are reused from the post-transform cache. They can then be regrouped so that clusters facing away from
+/// the mesh centre come first and hide less. Finally, vertices are renumbered in the order the triangles
+/// first use them, so that fetches walk the vertex buffer forwards. Levels of detail can be appended
+/// and parts split into meshlets before any of that, the triangle passes then work within each meshlet.
+/// Tangents for normal mapping can be generated last, from the final vertices.
+//-------------------------------------------------------------------------------------------------------
+namespace MeshOptimizer
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The passes optimize can run, combined as bit flags.
+  //-----------------------------------------------------------------------------------------------------
+  enum Pass : unsigned int
+  {
+    VERTEX_CACHE = 1,
+    // Needs the clusters of the vertex cache pass, so it runs that too
+    OVERDRAW = 2,
+    VERTEX_FETCH = 4,
+    // Appends coarser levels of detail, see MeshSimplifier
+    LOD = 8,
+    // Splits parts into culling clusters, see Meshlets
+    MESHLETS = 16,
+    // Generates a tangent per vertex for meshes with UVs, see Tangents
+    TANGENTS = 32
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Post-transform cache size the passes target and the simulation models, a FIFO of this many
+  /// vertices is a conservative match for current hardware.
+  //-----------------------------------------------------------------------------------------------------
+  constexpr size_t s_cacheSize = 16;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief How well an index order uses the post-transform cache.
+  //-----------------------------------------------------------------------------------------------------
+  struct CacheStats
+  {
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief Average cache miss ratio, transformed vertices per triangle. 0.5 is the best a large
+    /// regular mesh can get, 3 means no reuse at all.
+    //-----------------------------------------------------------------------------------------------------
+    float acmr = 0.0f;
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief Average transform to vertex ratio, transformed vertices per referenced vertex. 1 is optimal.
+    //-----------------------------------------------------------------------------------------------------
+    float atvr = 0.0f;
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to measure an index order on a simulated FIFO cache.
+  /// @param [in] _indices are the triangle list indices.
+  /// @param [in] _vertexCount is the amount of vertices the indices refer to.
+  /// @param [in] _cacheSize is the amount of vertices the simulated cache holds.
+  /// @return The miss ratios, all 0 for an empty list.
+  //-----------------------------------------------------------------------------------------------------
+  CacheStats analyzeVertexCache(const std::vector<GLuint> &_indices, const size_t _vertexCount, const size_t _cacheSize = s_cacheSize);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to measure a mesh's current index order.
+  /// @param [in] _data is the mesh, either index size.
+  /// @return The miss ratios on a cache of s_cacheSize vertices.
+  //-----------------------------------------------------------------------------------------------------
+  CacheStats analyze(const MeshStorage &_data);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to reorder a mesh. Triangles never move between submeshes or meshlets, so the ranges and
+  /// their bounds stay valid. The index size is chosen again, but the vertex count does not change.
+  /// @param [in,out] io_data is the imported mesh, with its submesh ranges set.
+  /// @param [in] _passes are the Pass flags to run.
+  //-----------------------------------------------------------------------------------------------------
+  void optimize(MeshStorage &io_data, const unsigned int _passes);
+}
+
+#endif // MESHOPTIMIZER_H
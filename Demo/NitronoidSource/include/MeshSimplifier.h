@@ -0,0 +1,48 @@
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include <QOpenGLFunctions>
+#include <vector>
+#include <cstddef>
+#include "vec3.hpp"
+
+struct MeshStorage;
+
+//-------------------------------------------------------------------------------------------------------
+/// @brief Quadric error simplification (Garland and Heckbert 1997) by collapsing edges onto one of their
+/// vertices, so simplified triangles index the original vertex arrays and every level of detail shares
+/// one vertex buffer. Vertices on open borders, on attribute seams or between parts never move, so
+/// levels stay crack free and keep their UV and normal discontinuities.
+//-------------------------------------------------------------------------------------------------------
+namespace MeshSimplifier
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Most levels built below the full detail mesh.
+  //-----------------------------------------------------------------------------------------------------
+  constexpr size_t s_maxLevels = 4;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Largest error any level may have, as a fraction of the mesh bounds radius.
+  //-----------------------------------------------------------------------------------------------------
+  constexpr float s_maxError = 0.1f;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to simplify a triangle list.
+  /// @param [in] _indices are the triangle list indices.
+  /// @param [in] _count is the amount of indices.
+  /// @param [in] _positions are the positions of the vertices the indices refer to.
+  /// @param [in] _targetCount is the amount of indices to reduce to.
+  /// @param [in] _maxError is the largest distance any collapse may move the surface.
+  /// @param [out] o_error receives the largest distance a collapse moved the surface.
+  /// @return The simplified indices, more than _targetCount when the error limit or the locked vertices
+  /// stop it early.
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<GLuint> simplify(const GLuint* _indices, const size_t _count, const std::vector<glm::vec3> &_positions,
+                               const size_t _targetCount, const float _maxError, float &o_error);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to append levels of detail to an imported mesh, each halving the triangles of the one
+  /// before part by part. Stops early once a level no longer gets much smaller.
+  /// @param [in,out] io_data is the mesh, with level 0 set.
+  //-----------------------------------------------------------------------------------------------------
+  void buildLods(MeshStorage &io_data);
+}
+
+#endif // MESHSIMPLIFIER_H
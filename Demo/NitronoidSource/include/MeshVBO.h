@@ -12,7 +12,24 @@
 //-------------------------------------------------------------------------------------------------------
 namespace MeshAttributes
 {
-enum Attribute { VERTEX, UV, NORMAL };
+enum Attribute { VERTEX, UV, NORMAL, TANGENT };
+//-------------------------------------------------------------------------------------------------------
+/// @brief how the attributes are arranged in the vertex buffer, PLANAR stores each attribute in its own
+/// section, INTERLEAVED stores all attributes of a vertex next to each other in Attribute order.
+/// QUANTIZED is interleaved too but compressed to 16 or 12 bytes per vertex: positions as 3 unsigned
+/// normalized shorts within the mesh bounds, normals as normalized 10-10-10-2 and UVs as half floats.
+/// Tangents add 16 bytes when interleaved, and 4 when quantized as 10-10-10-2 with the handedness in w.
+//-------------------------------------------------------------------------------------------------------
+enum Layout { PLANAR, INTERLEAVED, QUANTIZED };
+//-------------------------------------------------------------------------------------------------------
+/// @brief the amount of components in each attribute.
+//-------------------------------------------------------------------------------------------------------
+constexpr int tupleSize[] = {3, 2, 3, 4};
+//-------------------------------------------------------------------------------------------------------
+/// @brief the attribute locations after the mesh's that hold the model and normal matrices of an object,
+/// four locations each with a column in each. Instanced draws read them from a per instance buffer.
+//-------------------------------------------------------------------------------------------------------
+enum InstanceAttribute { MODEL_MATRIX = 4, NORMAL_MATRIX = 8 };
 }
 
 class MeshVBO
@@ -24,9 +41,9 @@ public:
   void init();
   //-----------------------------------------------------------------------------------------------------
   /// @brief called to reset our buffers, removing data from them
-  /// @param [in] _indicesSize is the size in bytes of the data type used to store indices.
-  /// @param [in] _nIndices is the amount of elements of _indicesSize bytes that we should allocate for,
-  /// the indices in the Element Buffer Object.
+  /// @param [in] _indexType is GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, the type used to store indices.
+  /// @param [in] _nIndices is the amount of indices of _indexType that we should allocate for, in the
+  /// Element Buffer Object.
   /// @param [in] _dataSize is the size in bytes of the data type we are storing, float would be 4 (probably).
   /// @param [in] _nVert is the amount of elements of _dataSize bytes that we should allocate for the,
   /// vertices in the Vertex Buffer Object.
@@ -34,14 +51,19 @@ public:
   /// normals in the Vertex Buffer Object.
   /// @param [in] _nUV is the amount of elements of _dataSize bytes that we should allocate for the,
   /// UV's in the Vertex Buffer Object.
+  /// @param [in] _nTangent is the amount of elements of _dataSize bytes that we should allocate for the,
+  /// tangents in the Vertex Buffer Object, 0 for meshes without them.
+  /// @param [in] _layout is how the attributes will be arranged in the Vertex Buffer Object.
   //-----------------------------------------------------------------------------------------------------
   void reset(
-      const unsigned char _indicesSize,
+      const GLenum _indexType,
       const int _nIndices,
       const unsigned char _dataSize,
       const int _nVert,
       const int _nUV,
-      const int _nNorm
+      const int _nNorm,
+      const int _nTangent,
+      const MeshAttributes::Layout _layout = MeshAttributes::PLANAR
       );
   //-----------------------------------------------------------------------------------------------------
   /// @brief called to add new data into the specified section of the vertex buffer.
@@ -50,6 +72,19 @@ public:
   //-----------------------------------------------------------------------------------------------------
   void write(const void * _address, const MeshAttributes::Attribute _section);
   //-----------------------------------------------------------------------------------------------------
+  /// @brief called to replace the whole vertex buffer, used for the interleaved layout.
+  /// @param [in] _address is a pointer to the data for all attributes, arranged in the buffer's layout.
+  //-----------------------------------------------------------------------------------------------------
+  void write(const void * _address);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief called to replace a run of whole vertices, used by GeometryArena to fill its buffers one mesh
+  /// at a time. Only valid for the interleaved and quantized layouts.
+  /// @param [in] _address is a pointer to _count vertices, arranged in the buffer's layout.
+  /// @param [in] _first is the first vertex to replace.
+  /// @param [in] _count is the amount of vertices to replace.
+  //-----------------------------------------------------------------------------------------------------
+  void write(const void * _address, const int _first, const int _count);
+  //-----------------------------------------------------------------------------------------------------
   /// @brief called to get the size of each data element we are storing.
   /// @return the size of the data elements in our buffer
   //-----------------------------------------------------------------------------------------------------
@@ -70,6 +105,26 @@ public:
   //-----------------------------------------------------------------------------------------------------
   int offset(const MeshAttributes::Attribute _section) const noexcept;
   //-----------------------------------------------------------------------------------------------------
+  /// @brief called to get the distance in bytes between consecutive vertices of an attribute.
+  /// @return the stride to pass with the offsets, 0 for the tightly packed planar layout.
+  //-----------------------------------------------------------------------------------------------------
+  int stride() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief called to get the component type of an attribute, normalized when it is an integer type.
+  /// @return the type to pass with the offsets, GL_FLOAT unless the layout is quantized.
+  //-----------------------------------------------------------------------------------------------------
+  GLenum type(const MeshAttributes::Attribute _section) const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief called to get the amount of components stored for an attribute.
+  /// @return the tuple size to pass with the offsets.
+  //-----------------------------------------------------------------------------------------------------
+  int components(const MeshAttributes::Attribute _section) const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief called to get how the attributes are arranged in our buffer.
+  /// @return the layout passed to reset.
+  //-----------------------------------------------------------------------------------------------------
+  MeshAttributes::Layout layout() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
   /// @brief called to bind our buffers.
   //-----------------------------------------------------------------------------------------------------
   void use();
@@ -78,6 +133,28 @@ public:
   /// @param [in] io_indices is a pointer to the index data.
   //-----------------------------------------------------------------------------------------------------
   void setIndices(const void *_indices);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief called to replace a run of the element buffer.
+  /// @param [in] _indices is a pointer to _count indices of indexType.
+  /// @param [in] _first is the first index to replace.
+  /// @param [in] _count is the amount of indices to replace.
+  //-----------------------------------------------------------------------------------------------------
+  void setIndices(const void *_indices, const int _first, const int _count);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief called to get the type of the stored indices, for the draw calls.
+  /// @return GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+  //-----------------------------------------------------------------------------------------------------
+  GLenum indexType() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief called to get the amount of indices the element buffer holds.
+  /// @return the number of indices allocated by reset.
+  //-----------------------------------------------------------------------------------------------------
+  int indexAmount() const noexcept;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief called to get the memory our buffers take on the GPU.
+  /// @return the size in bytes of the vertex and element buffers together.
+  //-----------------------------------------------------------------------------------------------------
+  size_t byteSize() const noexcept;
 
 private:
   //-----------------------------------------------------------------------------------------------------
@@ -91,7 +168,7 @@ private:
   //-----------------------------------------------------------------------------------------------------
   /// @brief Current amount of data elements in each section of m_vbo.
   //-----------------------------------------------------------------------------------------------------
-  std::array<int, 3> m_amountOfData = {{0,0,0}};
+  std::array<int, 4> m_amountOfData = {{0,0,0,0}};
   //-----------------------------------------------------------------------------------------------------
   /// @brief Current amount of data elements in m_vbo.
   //-----------------------------------------------------------------------------------------------------
@@ -108,6 +185,18 @@ private:
   /// @brief Current size of the data type used to store indices.
   //-----------------------------------------------------------------------------------------------------
   unsigned char m_indicesSize = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Current type used to store indices.
+  //-----------------------------------------------------------------------------------------------------
+  GLenum m_indexType = GL_UNSIGNED_SHORT;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Current arrangement of the attributes in m_vbo.
+  //-----------------------------------------------------------------------------------------------------
+  MeshAttributes::Layout m_layout = MeshAttributes::PLANAR;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Current size of m_vbo in bytes.
+  //-----------------------------------------------------------------------------------------------------
+  int m_vboSize = 0;
 
 
 };
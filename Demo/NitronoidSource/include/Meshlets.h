@@ -0,0 +1,61 @@
+#ifndef MESHLETS_H
+#define MESHLETS_H
+
+#include <QOpenGLFunctions>
+#include <vector>
+#include <cstddef>
+#include "vec3.hpp"
+#include "mat4x4.hpp"
+
+struct MeshStorage;
+struct MeshLod;
+class Mesh;
+
+//-------------------------------------------------------------------------------------------------------
+/// @brief Splits each part of a mesh into meshlets, small clusters of neighbouring triangles with a
+/// bounding sphere and a cone around their normals. Before drawing, the meshlets of a level of detail are
+/// tested against the view frustum and the cone, and the ones left are merged into as few index ranges
+/// as possible. Whole clusters facing away from the camera are never submitted, and the GPU only culls
+/// single triangles at the edges of the visible ones.
+//-------------------------------------------------------------------------------------------------------
+namespace Meshlets
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Most vertices a meshlet uses.
+  //-----------------------------------------------------------------------------------------------------
+  constexpr size_t s_maxVertices = 64;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Most triangles a meshlet holds.
+  //-----------------------------------------------------------------------------------------------------
+  constexpr size_t s_maxTriangles = 124;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief A run of the index array to draw with one call.
+  //-----------------------------------------------------------------------------------------------------
+  struct DrawRange
+  {
+    GLuint firstIndex = 0;
+    GLuint indexCount = 0;
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to split every submesh into meshlets. Triangles are reordered within their submesh so
+  /// each meshlet is one range of indices, so the submesh ranges and bounds stay valid.
+  /// @param [in,out] io_data is the mesh, with its submesh ranges set.
+  //-----------------------------------------------------------------------------------------------------
+  void build(MeshStorage &io_data);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to find the index ranges of a level of detail that can be seen.
+  /// @param [in] _mesh is the mesh, submeshes without meshlets are kept whole.
+  /// @param [in] _lod is the level to draw.
+  /// @param [in] _clip is the projection times the view times the model matrix, mapping the mesh's
+  /// original positions to clip space.
+  /// @param [in] _eye is the camera position in model space.
+  /// @param [in] _backFaces is true to also drop meshlets facing away from _eye, only correct when
+  /// back faces are not drawn anyway.
+  /// @param [out] o_ranges receives the ranges to draw, merged where they follow each other.
+  /// @return The amount of indices in o_ranges.
+  //-----------------------------------------------------------------------------------------------------
+  size_t cull(const Mesh &_mesh, const MeshLod &_lod, const glm::mat4 &_clip, const glm::vec3 &_eye, const bool _backFaces,
+              std::vector<DrawRange> &o_ranges);
+}
+
+#endif // MESHLETS_H
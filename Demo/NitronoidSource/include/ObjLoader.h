@@ -0,0 +1,34 @@
+#ifndef OBJLOADER_H
+#define OBJLOADER_H
+
+#include <string>
+#include <functional>
+#include "Mesh.h"
+
+//-------------------------------------------------------------------------------------------------------
+/// @brief Native Wavefront OBJ importer. The file is mapped, split into line blocks that are parsed in
+/// parallel on the library thread pool, and face corners are welded into shared vertices with a hash table.
+/// Polygons are fan triangulated, UVs are flipped and missing normals are generated smooth, matching what
+/// Mesh::load asks Assimp for. Object, group and material lines start a new submesh. Anything it does
+/// not understand makes it fail, so the caller can fall back.
+//-------------------------------------------------------------------------------------------------------
+namespace ObjLoader
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to check if a file should be read by this importer.
+  /// @param [in] _fname is the path to the mesh file.
+  /// @return true if the file has an .obj extension.
+  //-----------------------------------------------------------------------------------------------------
+  bool handles(const std::string &_fname);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to import an OBJ file.
+  /// @param [in] _fname is the path to the OBJ file.
+  /// @param [out] o_data receives the welded arrays and submesh ranges, bounds and content hash are left
+  /// to the caller.
+  /// @param [in] _progress is called with the completed fraction, returning false aborts the import.
+  /// @return false if the file is missing, malformed, uses unsupported features or the import was aborted.
+  //-----------------------------------------------------------------------------------------------------
+  bool load(const std::string &_fname, MeshStorage &o_data, const std::function<bool(float)> &_progress);
+}
+
+#endif // OBJLOADER_H
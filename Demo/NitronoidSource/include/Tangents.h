@@ -0,0 +1,25 @@
+#ifndef TANGENTS_H
+#define TANGENTS_H
+
+struct MeshStorage;
+
+//-------------------------------------------------------------------------------------------------------
+/// @brief Generates the tangent frames normal maps are sampled in, following MikkTSpace (Mikkelsen 2008)
+/// so that maps baked by tools using it light the same here. Each triangle gets a tangent from its UV
+/// gradients. Each vertex sums the tangents of its triangles projected into the plane of its normal,
+/// weighted by the triangle's angle at the vertex. Triangles are processed four at a time with SSE when
+/// the compiler targets it, and both triangles and vertices are split across the ThreadPool.
+//-------------------------------------------------------------------------------------------------------
+namespace Tangents
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to fill the tangents of a mesh from the triangles of level 0, coarser levels share its
+  /// vertices. MikkTSpace splits vertices where triangles with mirrored UVs meet, here the vertices are
+  /// fixed, so such a vertex takes the handedness its triangles cover the larger angle with. Triangles
+  /// without UV area are left out, vertices only they use get any tangent perpendicular to the normal.
+  /// @param [in,out] io_data is the mesh, tangents is left empty when it has no UVs or normals.
+  //-----------------------------------------------------------------------------------------------------
+  void generate(MeshStorage &io_data);
+}
+
+#endif // TANGENTS_H
@@ -13,23 +13,39 @@ void DemoScene::writeMeshAttributes()
   const auto& mesh = m_meshes[m_meshIndex];
 
   using namespace MeshAttributes;
-  for (const auto buff : {VERTEX, UV, NORMAL})
+  if (mesh.getLayout() == INTERLEAVED)
   {
-    m_meshVBO.write(mesh.getAttribData(buff), buff);
+    m_meshVBO.write(mesh.getInterleavedData());
+  }
+  else if (mesh.getLayout() == QUANTIZED)
+  {
+    m_meshVBO.write(mesh.getQuantizedData());
+  }
+  else
+  {
+    for (const auto buff : {VERTEX, UV, NORMAL, TANGENT})
+    {
+      m_meshVBO.write(mesh.getAttribData(buff), buff);
+    }
   }
   m_meshVBO.setIndices(mesh.getIndicesData());
 }
 //-----------------------------------------------------------------------------------------------------
 void DemoScene::setAttributeBuffers()
 {
-  static constexpr int tupleSize[] = {3,2,3};
   auto prog = m_shaderLib->getCurrentShader();
 
   using namespace MeshAttributes;
-  for (const auto buff : {VERTEX, UV, NORMAL})
+  for (const auto buff : {VERTEX, UV, NORMAL, TANGENT})
   {
+    // Attributes the mesh doesn't have read a constant instead of another attribute's data
+    if (m_meshVBO.dataAmount(buff) == 0)
+    {
+      prog->disableAttributeArray(buff);
+      continue;
+    }
     prog->enableAttributeArray(buff);
-    prog->setAttributeBuffer(buff, GL_FLOAT, m_meshVBO.offset(buff), tupleSize[buff]);
+    prog->setAttributeBuffer(buff, m_meshVBO.type(buff), m_meshVBO.offset(buff), m_meshVBO.components(buff), m_meshVBO.stride());
   }
 
 }
@@ -50,6 +66,10 @@ void DemoScene::init()
 //-----------------------------------------------------------------------------------------------------
 void DemoScene::initGeo()
 {
+  // The bump material needs tangents, any mesh may be drawn with it
+  for (auto& mesh : m_meshes)
+    mesh.setOptimization(MeshOptimizer::LOD | MeshOptimizer::MESHLETS | MeshOptimizer::VERTEX_CACHE | MeshOptimizer::VERTEX_FETCH |
+                         MeshOptimizer::TANGENTS);
   m_meshes[0].load("models/cube.obj");
   m_meshes[1].load("models/plane.obj");
   m_meshes[2].load("models/Face.obj");
@@ -102,12 +122,14 @@ void DemoScene::generateNewGeometry()
   m_meshIndex = (m_meshIndex + 1) % m_meshes.size();
   auto& mesh = m_meshes[m_meshIndex];
   m_meshVBO.reset(
-        sizeof(GLushort),
+        mesh.getIndexType(),
         mesh.getNIndicesData(),
         sizeof(GLfloat),
         mesh.getNVertData(),
         mesh.getNUVData(),
-        mesh.getNNormData()
+        mesh.getNNormData(),
+        mesh.getNTangentData(),
+        mesh.getLayout()
         );
   writeMeshAttributes();
   setAttributeBuffers();
@@ -135,7 +157,8 @@ void DemoScene::renderScene()
   m_materials[m_currentMaterial]->update();
 
   m_meshVBO.use();
-  glDrawElements(GL_TRIANGLES, m_meshes[m_meshIndex].getNIndicesData(), GL_UNSIGNED_SHORT, nullptr);
+  // Level 0 comes first in the index buffer, the coarser levels after it are not drawn here
+  glDrawElements(GL_TRIANGLES, m_meshes[m_meshIndex].getLodIndexCount(0), m_meshVBO.indexType(), nullptr);
 //  glDrawArrays(GL_TRIANGLES, 0, m_meshes[m_meshIndex].getNVertData()/3);
 }
 //-----------------------------------------------------------------------------------------------------
@@ -0,0 +1,83 @@
+#include "DrawBatches.h"
+#include <algorithm>
+#include <tuple>
+
+namespace
+{
+auto order(const DrawBatches::Key &_key)
+{
+  return std::make_tuple(_key.pass, _key.material, _key.cullBackFaces, _key.geo, _key.level);
+}
+}
+
+void DrawBatches::clear()
+{
+  m_entries.clear();
+  m_added.clear();
+  m_ranges.clear();
+  m_instances.clear();
+  m_batches.clear();
+}
+
+void DrawBatches::add(const Key &_key, const Instance &_instance, const std::vector<Meshlets::DrawRange> &_ranges)
+{
+  if (_ranges.empty())
+    return;
+  Entry entry;
+  entry.key = _key;
+  entry.instance = m_added.size();
+  entry.firstRange = m_ranges.size();
+  entry.rangeCount = _ranges.size();
+  m_entries.push_back(entry);
+  m_added.push_back(_instance);
+  m_ranges.insert(m_ranges.end(), _ranges.begin(), _ranges.end());
+}
+
+void DrawBatches::build()
+{
+  // Stable, so objects with the same key keep the order they were added in
+  std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry &_a, const Entry &_b)
+  {
+    return order(_a.key) < order(_b.key);
+  });
+  m_instances.clear();
+  m_batches.clear();
+  for (const Entry &entry : m_entries)
+  {
+    if (m_batches.empty() || order(m_batches.back().key) != order(entry.key))
+    {
+      Batch batch;
+      batch.key = entry.key;
+      batch.firstInstance = static_cast<GLuint>(m_instances.size());
+      batch.firstRange = entry.firstRange;
+      batch.rangeCount = entry.rangeCount;
+      m_batches.push_back(batch);
+    }
+    else
+    {
+      m_batches.back().rangeCount = 0;
+    }
+    ++m_batches.back().instanceCount;
+    m_instances.push_back(m_added[entry.instance]);
+  }
+}
+
+const std::vector<DrawBatches::Batch>& DrawBatches::batches() const noexcept
+{
+  return m_batches;
+}
+
+const std::vector<DrawBatches::Instance>& DrawBatches::instances() const noexcept
+{
+  return m_instances;
+}
+
+const Meshlets::DrawRange& DrawBatches::range(const size_t _index) const
+{
+  return m_ranges[_index];
+}
+
+size_t DrawBatches::separateDraws() const noexcept
+{
+  return m_ranges.size();
+}
@@ -0,0 +1,244 @@
+#include "GeometryArena.h"
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+// A run of free vertices or indices in a page
+struct FreeRange
+{
+  int first;
+  int count;
+};
+
+// Takes _count elements from the first free range long enough, the lists are short so first fit is cheap
+bool takeRange(std::vector<FreeRange> &io_free, const int _count, int &o_first)
+{
+  auto range = std::find_if(io_free.begin(), io_free.end(), [_count](const FreeRange &_range)
+  {
+    return _range.count >= _count;
+  });
+  if (range == io_free.end())
+    return false;
+  o_first = range->first;
+  range->first += _count;
+  range->count -= _count;
+  if (range->count == 0)
+    io_free.erase(range);
+  return true;
+}
+
+// Puts a run back in order, merged with the free ranges either side so space doesn't fragment
+void giveRange(std::vector<FreeRange> &io_free, const int _first, const int _count)
+{
+  if (_count == 0)
+    return;
+  auto next = std::find_if(io_free.begin(), io_free.end(), [_first](const FreeRange &_range)
+  {
+    return _range.first > _first;
+  });
+  next = io_free.insert(next, {_first, _count});
+  if (next + 1 != io_free.end() && next->first + next->count == (next + 1)->first)
+  {
+    next->count += (next + 1)->count;
+    io_free.erase(next + 1);
+  }
+  if (next != io_free.begin() && (next - 1)->first + (next - 1)->count == next->first)
+  {
+    (next - 1)->count += next->count;
+    io_free.erase(next);
+  }
+}
+}
+
+// Taken by reference in std::max, so they need a definition before C++17
+constexpr int GeometryArena::s_pageVertices;
+constexpr int GeometryArena::s_pageIndices;
+
+//-------------------------------------------------------------------------------------------------------
+/// @brief One pair of buffers and the space left in them, all its meshes have one format.
+//-------------------------------------------------------------------------------------------------------
+class GeometryArena::Page
+{
+public:
+  const GeometryArena* arena = nullptr;
+  MeshVBO buffers;
+  MeshAttributes::Layout layout = MeshAttributes::INTERLEAVED;
+  std::array<bool, 4> attributes = {{false, false, false, false}};
+  GLenum indexType = GL_UNSIGNED_SHORT;
+  int vertexSize = 0;
+  int indexSize = 0;
+  int vertexCapacity = 0;
+  int indexCapacity = 0;
+  // Allocations may be dropped on any thread, the lists are only touched under the lock
+  std::mutex lock;
+  std::vector<FreeRange> freeVertices;
+  std::vector<FreeRange> freeIndices;
+  size_t usedBytes = 0;
+};
+
+//-------------------------------------------------------------------------------------------------------
+GeometryArena::Allocation::Allocation(const std::shared_ptr<Page> &_page, const int _firstVertex, const int _firstIndex, const int _nIndices,
+                                      const std::array<int, 4> &_amountOfData) :
+  m_page(_page),
+  m_firstVertex(_firstVertex),
+  m_firstIndex(_firstIndex),
+  m_numIndices(_nIndices),
+  m_amountOfData(_amountOfData)
+{
+}
+//-------------------------------------------------------------------------------------------------------
+GeometryArena::Allocation::~Allocation()
+{
+  std::lock_guard<std::mutex> guard(m_page->lock);
+  giveRange(m_page->freeVertices, m_firstVertex, m_amountOfData[MeshAttributes::VERTEX] / 3);
+  giveRange(m_page->freeIndices, m_firstIndex, m_numIndices);
+  m_page->usedBytes -= byteSize();
+}
+//-------------------------------------------------------------------------------------------------------
+MeshVBO& GeometryArena::Allocation::buffers() const noexcept
+{
+  return m_page->buffers;
+}
+//-------------------------------------------------------------------------------------------------------
+const GeometryArena* GeometryArena::Allocation::arena() const noexcept
+{
+  return m_page->arena;
+}
+//-------------------------------------------------------------------------------------------------------
+GLint GeometryArena::Allocation::baseVertex() const noexcept
+{
+  return m_firstVertex;
+}
+//-------------------------------------------------------------------------------------------------------
+GLuint GeometryArena::Allocation::firstIndex() const noexcept
+{
+  return static_cast<GLuint>(m_firstIndex);
+}
+//-------------------------------------------------------------------------------------------------------
+const void* GeometryArena::Allocation::indexOffset(const GLuint _index) const noexcept
+{
+  return reinterpret_cast<const void*>((static_cast<size_t>(m_firstIndex) + _index) * static_cast<size_t>(m_page->indexSize));
+}
+//-------------------------------------------------------------------------------------------------------
+int GeometryArena::Allocation::indexAmount() const noexcept
+{
+  return m_numIndices;
+}
+//-------------------------------------------------------------------------------------------------------
+int GeometryArena::Allocation::dataAmount(const MeshAttributes::Attribute _section) const noexcept
+{
+  return m_amountOfData[_section];
+}
+//-------------------------------------------------------------------------------------------------------
+GLenum GeometryArena::Allocation::indexType() const noexcept
+{
+  return m_page->indexType;
+}
+//-------------------------------------------------------------------------------------------------------
+MeshAttributes::Layout GeometryArena::Allocation::layout() const noexcept
+{
+  return m_page->layout;
+}
+//-------------------------------------------------------------------------------------------------------
+size_t GeometryArena::Allocation::byteSize() const noexcept
+{
+  return static_cast<size_t>(m_amountOfData[MeshAttributes::VERTEX] / 3) * static_cast<size_t>(m_page->vertexSize) +
+         static_cast<size_t>(m_numIndices) * static_cast<size_t>(m_page->indexSize);
+}
+
+//-------------------------------------------------------------------------------------------------------
+std::shared_ptr<GeometryArena::Allocation> GeometryArena::upload(const GLenum _indexType, const void *_indices, const int _nIndices,
+                                                                 const void *_vertices, const int _nVert, const int _nUV,
+                                                                 const int _nNorm, const int _nTangent,
+                                                                 const MeshAttributes::Layout _layout)
+{
+  using namespace MeshAttributes;
+  if (_layout == PLANAR || _nIndices == 0 || _nVert == 0 || _indices == nullptr || _vertices == nullptr)
+    return nullptr;
+  const int nVertices = _nVert / 3;
+  const std::array<int, 4> amountOfData = {{_nVert, _nUV, _nNorm, _nTangent}};
+  const std::array<bool, 4> attributes = {{true, _nUV != 0, _nNorm != 0, _nTangent != 0}};
+
+  // The first page of the format with room for both runs, they are taken together or not at all
+  std::shared_ptr<Page> page;
+  int firstVertex = 0;
+  int firstIndex = 0;
+  for (const auto &candidate : m_pages)
+  {
+    if (candidate->layout != _layout || candidate->attributes != attributes || candidate->indexType != _indexType)
+      continue;
+    std::lock_guard<std::mutex> guard(candidate->lock);
+    if (!takeRange(candidate->freeVertices, nVertices, firstVertex))
+      continue;
+    if (!takeRange(candidate->freeIndices, _nIndices, firstIndex))
+    {
+      giveRange(candidate->freeVertices, firstVertex, nVertices);
+      continue;
+    }
+    page = candidate;
+    break;
+  }
+  if (page == nullptr)
+  {
+    page = std::make_shared<Page>();
+    page->arena = this;
+    page->layout = _layout;
+    page->attributes = attributes;
+    page->indexType = _indexType;
+    page->indexSize = _indexType == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort);
+    page->vertexCapacity = std::max(s_pageVertices, nVertices);
+    page->indexCapacity = std::max(s_pageIndices, _nIndices);
+    page->buffers.init();
+    page->buffers.reset(_indexType, page->indexCapacity, sizeof(GLfloat), page->vertexCapacity * 3,
+                        attributes[UV] ? page->vertexCapacity * 2 : 0, attributes[NORMAL] ? page->vertexCapacity * 3 : 0,
+                        attributes[TANGENT] ? page->vertexCapacity * 4 : 0, _layout);
+    page->vertexSize = page->buffers.stride();
+    firstVertex = 0;
+    firstIndex = 0;
+    if (nVertices < page->vertexCapacity)
+      page->freeVertices.push_back({nVertices, page->vertexCapacity - nVertices});
+    if (_nIndices < page->indexCapacity)
+      page->freeIndices.push_back({_nIndices, page->indexCapacity - _nIndices});
+    m_pages.push_back(page);
+  }
+
+  page->buffers.write(_vertices, firstVertex, nVertices);
+  page->buffers.setIndices(_indices, firstIndex, _nIndices);
+  auto allocation = std::make_shared<Allocation>(page, firstVertex, firstIndex, _nIndices, amountOfData);
+  {
+    std::lock_guard<std::mutex> guard(page->lock);
+    page->usedBytes += allocation->byteSize();
+  }
+  m_uploadedBytes += allocation->byteSize();
+  return allocation;
+}
+//-------------------------------------------------------------------------------------------------------
+size_t GeometryArena::pageCount() const noexcept
+{
+  return m_pages.size();
+}
+//-------------------------------------------------------------------------------------------------------
+size_t GeometryArena::byteSize() const noexcept
+{
+  size_t total = 0;
+  for (const auto &page : m_pages)
+    total += page->buffers.byteSize();
+  return total;
+}
+//-------------------------------------------------------------------------------------------------------
+size_t GeometryArena::usedBytes() const noexcept
+{
+  size_t total = 0;
+  for (const auto &page : m_pages)
+  {
+    std::lock_guard<std::mutex> guard(page->lock);
+    total += page->usedBytes;
+  }
+  return total;
+}
+//-------------------------------------------------------------------------------------------------------
+size_t GeometryArena::uploadedBytes() const noexcept
+{
+  return m_uploadedBytes;
+}
@@ -0,0 +1,56 @@
+#include "IndirectDraws.h"
+#include "Mesh.h"
+
+void IndirectDraws::clear()
+{
+  m_commands.clear();
+  m_buckets.clear();
+}
+
+void IndirectDraws::add(const DrawBatches &_batches, const DrawBatches::Batch &_batch, const Mesh &_mesh, const GeometryArena::Allocation &_range)
+{
+  // A new bucket whenever the state a multi draw can't change does
+  if (m_buckets.empty() || m_buckets.back().key.pass != _batch.key.pass || m_buckets.back().key.material != _batch.key.material ||
+      m_buckets.back().key.cullBackFaces != _batch.key.cullBackFaces || &m_buckets.back().range->buffers() != &_range.buffers())
+  {
+    Bucket bucket;
+    bucket.key = _batch.key;
+    bucket.range = &_range;
+    bucket.firstCommand = m_commands.size();
+    m_buckets.push_back(bucket);
+  }
+  Bucket &bucket = m_buckets.back();
+
+  // Mesh ranges start at 0, the commands index the whole page
+  Command command;
+  command.instanceCount = _batch.instanceCount;
+  command.baseVertex = _range.baseVertex();
+  command.baseInstance = _batch.firstInstance;
+  if (_batch.rangeCount == 0)
+  {
+    // Levels are packed in order, so the whole level is one range of the index buffer
+    command.firstIndex = _range.firstIndex() + _mesh.getSubMesh(_mesh.getLod(_batch.key.level).firstSubMesh).firstIndex;
+    command.count = _mesh.getLodIndexCount(_batch.key.level);
+    m_commands.push_back(command);
+    bucket.indices += static_cast<size_t>(command.count) * command.instanceCount;
+  }
+  for (size_t i = _batch.firstRange; i < _batch.firstRange + _batch.rangeCount; ++i)
+  {
+    const Meshlets::DrawRange& range = _batches.range(i);
+    command.firstIndex = _range.firstIndex() + range.firstIndex;
+    command.count = range.indexCount;
+    m_commands.push_back(command);
+    bucket.indices += range.indexCount;
+  }
+  bucket.commandCount = m_commands.size() - bucket.firstCommand;
+}
+
+const std::vector<IndirectDraws::Command>& IndirectDraws::commands() const noexcept
+{
+  return m_commands;
+}
+
+const std::vector<IndirectDraws::Bucket>& IndirectDraws::buckets() const noexcept
+{
+  return m_buckets;
+}
@@ -1,4 +1,5 @@
 #include "Material.h"
+#include "Scene.h"
 
 //-----------------------------------------------------------------------------------------------------
 Material::~Material() = default;
@@ -16,3 +17,14 @@ void Material::setShaderName(const std::string &_name)
 //-----------------------------------------------------------------------------------------------------
 void Material::handleKey(QKeyEvent*, QOpenGLContext*)
 {}
+//-----------------------------------------------------------------------------------------------------
+void Material::setMatrices(QOpenGLShaderProgram *io_shader)
+{
+  // Convert from glm to Qt, transposed as they use different majors
+  const glm::mat4 viewProjection = m_cam->projMatrix() * m_cam->viewMatrix();
+  io_shader->setUniformValue("VP", QMatrix4x4(glm::value_ptr(viewProjection)).transposed());
+  // Attribute values are column major like glm, one column per location
+  using namespace SceneMatrices;
+  io_shader->setAttributeValue(MeshAttributes::MODEL_MATRIX, glm::value_ptr((*m_matrices)[MODEL_VIEW]), 4, 4);
+  io_shader->setAttributeValue(MeshAttributes::NORMAL_MATRIX, glm::value_ptr((*m_matrices)[NORMAL]), 4, 4);
+}
@@ -74,19 +74,8 @@ void MaterialEnvMap::update()
   auto eye = m_cam->getCameraEye();
   shaderPtr->setUniformValue("camPos", QVector3D{eye.x, eye.y, eye.z});
 
-  // Scope the using declaration
-  {
-    using namespace SceneMatrices;
-    static constexpr std::array<const char*, 3> shaderUniforms = {{"M", "MVP", "N"}};
-    // Send all our matrices to the GPU
-    for (const auto matrixId : {MODEL_VIEW, PROJECTION, NORMAL})
-    {
-      // Convert from glm to Qt
-      QMatrix4x4 qmat(glm::value_ptr((*m_matrices)[matrixId]));
-      // Need to transpose the matrix as they both use different majors
-      shaderPtr->setUniformValue(shaderUniforms[matrixId], qmat.transposed());
-    }
-  }
+  // Send all our matrices to the GPU
+  setMatrices(shaderPtr);
 }
 
 const char* MaterialEnvMap::shaderFileName() const
@@ -20,19 +20,8 @@ void MaterialFractal::update()
   m_time += (duration_cast<milliseconds>(now - m_last).count() * m_updateTime);
   m_last = now;
   shaderPtr->setUniformValue("t", m_time / 1000.0f);
-  // Scope the using declaration
-  {
-    using namespace SceneMatrices;
-    static constexpr std::array<const char*, 3> shaderUniforms = {{"M", "MVP", "N"}};
-    // Send all our matrices to the GPU
-    for (const auto matrixId : {MODEL_VIEW, PROJECTION, NORMAL})
-    {
-      // Convert from glm to Qt
-      QMatrix4x4 qmat(glm::value_ptr((*m_matrices)[matrixId]));
-      // Need to transpose the matrix as they both use different majors
-      shaderPtr->setUniformValue(shaderUniforms[matrixId], qmat.transposed());
-    }
-  }
+  // Send all our matrices to the GPU
+  setMatrices(shaderPtr);
 }
 
 const char* MaterialFractal::shaderFileName() const
@@ -1,93 +1,624 @@
 #include "Mesh.h"
+#include "MeshCache.h"
+#include "ObjLoader.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <assimp/ProgressHandler.hpp>
+#include <glm.hpp>
+#include <gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
+namespace
+{
+// Forwards Assimp's import progress to a mesh load callback
+class ImportProgress : public Assimp::ProgressHandler
+{
+public:
+  explicit ImportProgress(const std::function<bool(float)> &_progress) : m_progress(_progress) {}
+  bool Update(float _percentage) override
+  {
+    return m_progress(_percentage < 0.0f ? 0.0f : _percentage);
+  }
+private:
+  const std::function<bool(float)> &m_progress;
+};
 
-void Mesh::load(const std::string &_fname)
+// FNV-1a over the raw bytes of an array, continuing from _hash
+template<typename T>
+size_t hashArray(const std::vector<T> &_array, size_t _hash)
+{
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(_array.data());
+  const size_t count = _array.size() * sizeof(T);
+  for (size_t i = 0; i < count; ++i)
+  {
+    _hash ^= bytes[i];
+    _hash *= 1099511628211ull;
+  }
+  // The length keeps arrays that only differ in where one ends and the next starts apart
+  _hash ^= count;
+  _hash *= 1099511628211ull;
+  return _hash;
+}
+
+// Post-processing asked of Assimp, part of the cache entry name
+constexpr unsigned int s_importFlags = aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_FlipUVs;
+
+// Imports every mesh of any format Assimp reads into o_data, packed one after the other
+bool importAssimp(const std::string &_fname, const unsigned int _importFlags, const std::function<bool(float)> &_progress, MeshStorage &o_data)
 {
   Assimp::Importer importer;
+  // The importer takes ownership of the handler
+  importer.SetProgressHandler(new ImportProgress(_progress));
   // And have it read the given file with some example postprocessing
   // Usually - if speed is not the most important aspect for you - you'll
   // propably to request more postprocessing than we do in this example.
-  const aiScene* scene = importer.ReadFile(
-        _fname,
-        aiProcessPreset_TargetRealtime_MaxQuality |
-        aiProcess_FlipUVs);
-  const aiMesh* mesh = scene->mMeshes[0];
+  const aiScene* scene = importer.ReadFile(_fname, _importFlags);
+  // Missing, unreadable or aborted imports leave the mesh empty
+  if (scene == nullptr || scene->mNumMeshes == 0)
+    return false;
 
-  // Calculate the amount of vertices we will store (3 per face)
-  size_t numVerts = mesh->mNumVertices;
+  // Calculate the amount of vertices and indices we will store over all meshes
+  size_t numVerts = 0;
+  size_t numIndices = 0;
+  // UVs are padded with zeros for meshes without them if any mesh has them
+  bool hasTexCoords = false;
+  for (size_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+  {
+    const aiMesh* mesh = scene->mMeshes[meshIndex];
+    numVerts += mesh->mNumVertices;
+    numIndices += mesh->mNumFaces * 3;
+    hasTexCoords |= mesh->HasTextureCoords(0);
+  }
 
   // Reserve memory in vectors to accomodate the incomming data
-  m_vertices.reserve(numVerts);
-  m_normals.reserve(numVerts);
-  m_uvs.reserve(numVerts);
+  o_data.vertices.reserve(numVerts);
+  o_data.normals.reserve(numVerts);
+  if (hasTexCoords)
+    o_data.uvs.reserve(numVerts);
+  o_data.subMeshes.reserve(scene->mNumMeshes);
+  std::vector<GLuint> indices;
+  indices.reserve(numIndices);
 
-  // Get access to the information we will store
-  auto& vertices = mesh->mVertices;
-  auto& normals = mesh->mNormals;
-  auto& texCoords = mesh->mTextureCoords[0];
-  // Some meshes don't have UV's
-  bool hasTexCoords = mesh->HasTextureCoords(0);
+  for (size_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+  {
+    const aiMesh* mesh = scene->mMeshes[meshIndex];
+    // Indices of this mesh are offset by the vertices already stored
+    const GLuint baseVertex = static_cast<GLuint>(o_data.vertices.size());
+
+    // Get access to the information we will store
+    auto& vertices = mesh->mVertices;
+    auto& normals = mesh->mNormals;
+    auto& texCoords = mesh->mTextureCoords[0];
+    // Some meshes don't have UV's
+    const bool meshTexCoords = mesh->HasTextureCoords(0);
+
+    for (size_t i = 0; i < mesh->mNumVertices; ++i)
+    {
+      auto& vert = vertices[i];
+      o_data.vertices.emplace_back(vert.x, vert.y, vert.z);
+
+      auto& norm = normals[i];
+      o_data.normals.emplace_back(norm.x, norm.y, norm.z);
+
+      if (!hasTexCoords) continue;
+      // UV's only use the first two members
+      const auto& uv = meshTexCoords ? texCoords[i] : aiVector3D(0.0f, 0.0f, 0.0f);
+      o_data.uvs.emplace_back(uv.x, uv.y);
+    }
 
-  for (size_t i = 0; i < numVerts; ++i)
+    SubMesh subMesh;
+    subMesh.firstIndex = static_cast<GLuint>(indices.size());
+    // We iterate through faces not vertices,
+    // as the verts will be duplicated when used by more than one face.
+    for (size_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex)
+    {
+      auto& face = mesh->mFaces[faceIndex];
+      // Iterate over the vertices of this face, points and lines left by the import are skipped
+      if (face.mNumIndices != 3)
+        continue;
+      for (size_t i = 0; i < face.mNumIndices; ++i)
+        indices.push_back(baseVertex + face.mIndices[i]);
+    }
+    subMesh.indexCount = static_cast<GLuint>(indices.size()) - subMesh.firstIndex;
+    if (subMesh.indexCount != 0)
+      o_data.subMeshes.push_back(subMesh);
+  }
+  o_data.setIndices(std::move(indices));
+  return true;
+}
+
+// Fills in the bounds of the whole mesh and of each part, a mesh without parts gets one covering everything
+void computeBounds(MeshStorage &io_data)
+{
+  const size_t indexCount = io_data.indices.size() + io_data.indices32.size();
+  if (io_data.subMeshes.empty() && indexCount != 0)
   {
-    auto& vert = vertices[i];
-    m_vertices.insert(m_vertices.end(), {vert.x,vert.y,vert.z});
+    io_data.subMeshes.emplace_back();
+    io_data.subMeshes.back().indexCount = static_cast<GLuint>(indexCount);
+  }
+  // Level 0 is the mesh as imported, coarser levels are appended by the optimizer
+  if (io_data.lods.empty() && !io_data.subMeshes.empty())
+  {
+    io_data.lods.emplace_back();
+    io_data.lods.back().subMeshCount = static_cast<GLuint>(io_data.subMeshes.size());
+  }
+  if (io_data.vertices.empty())
+    return;
+  io_data.min = io_data.max = io_data.vertices[0];
+  for (const auto& vert : io_data.vertices)
+  {
+    io_data.min = glm::min(io_data.min, vert);
+    io_data.max = glm::max(io_data.max, vert);
+  }
+  // Ritter's sphere, grown from the two vertices furthest apart along a quick search, unless the sphere
+  // around the box centre happens to be smaller
+  auto furthest = [&io_data](const glm::vec3 &_from)
+  {
+    const glm::vec3* ret = &io_data.vertices[0];
+    float best = 0.0f;
+    for (const auto& vert : io_data.vertices)
+    {
+      const float distance = glm::dot(vert - _from, vert - _from);
+      if (distance > best)
+      {
+        best = distance;
+        ret = &vert;
+      }
+    }
+    return *ret;
+  };
+  const glm::vec3 first = furthest(io_data.vertices[0]);
+  const glm::vec3 second = furthest(first);
+  glm::vec3 centre = (first + second) * 0.5f;
+  float radius = glm::length(second - first) * 0.5f;
+  for (const auto& vert : io_data.vertices)
+  {
+    const float distance = glm::length(vert - centre);
+    if (distance > radius)
+    {
+      const float grown = (radius + distance) * 0.5f;
+      centre += (vert - centre) * ((distance - grown) / distance);
+      radius = grown;
+    }
+  }
+  const glm::vec3 boxCentre = (io_data.min + io_data.max) * 0.5f;
+  float boxRadius = 0.0f;
+  for (const auto& vert : io_data.vertices)
+    boxRadius = std::max(boxRadius, glm::length(vert - boxCentre));
+  io_data.centre = boxRadius < radius ? boxCentre : centre;
+  io_data.radius = std::min(boxRadius, radius);
+  for (auto& subMesh : io_data.subMeshes)
+  {
+    subMesh.min = io_data.max;
+    subMesh.max = io_data.min;
+    for (GLuint i = subMesh.firstIndex; i < subMesh.firstIndex + subMesh.indexCount; ++i)
+    {
+      const auto& vert = io_data.vertices[io_data.indices32.empty() ? io_data.indices[i] : io_data.indices32[i]];
+      subMesh.min = glm::min(subMesh.min, vert);
+      subMesh.max = glm::max(subMesh.max, vert);
+    }
+  }
+}
 
-    auto& norm = normals[i];
-    m_normals.insert(m_normals.end(), {norm.x,norm.y,norm.z});
+// Builds the interleaved copy of the vertex data if it is missing, in MeshAttributes order
+void interleave(MeshStorage &io_data)
+{
+  if (!io_data.interleaved.empty() || io_data.vertices.empty())
+    return;
+  const bool hasUVs = !io_data.uvs.empty();
+  const bool hasTangents = !io_data.tangents.empty();
+  io_data.interleaved.reserve(io_data.vertices.size() * ((hasUVs ? 8 : 6) + (hasTangents ? 4 : 0)));
+  for (size_t i = 0; i < io_data.vertices.size(); ++i)
+  {
+    const auto& vert = io_data.vertices[i];
+    const auto& norm = io_data.normals[i];
+    io_data.interleaved.insert(io_data.interleaved.end(), {vert.x, vert.y, vert.z});
+    if (hasUVs)
+      io_data.interleaved.insert(io_data.interleaved.end(), {io_data.uvs[i].x, io_data.uvs[i].y});
+    io_data.interleaved.insert(io_data.interleaved.end(), {norm.x, norm.y, norm.z});
+    if (hasTangents)
+    {
+      const auto& tangent = io_data.tangents[i];
+      io_data.interleaved.insert(io_data.interleaved.end(), {tangent.x, tangent.y, tangent.z, tangent.w});
+    }
+  }
+}
 
-    if (!hasTexCoords) continue;
-    // UV's only use the first two members
-    const auto& uv = hasTexCoords ? texCoords[i] : aiVector3D(0.0f, 0.0f, 0.0f);
-    m_uvs.insert(m_uvs.end(), {uv.x, uv.y});
+// IEEE half from float, rounded to nearest even, out of range values become infinity
+GLushort floatToHalf(const float _value)
+{
+  GLuint bits;
+  std::memcpy(&bits, &_value, sizeof(bits));
+  const GLuint sign = (bits >> 16) & 0x8000u;
+  const int exponent = static_cast<int>((bits >> 23) & 0xFFu) - 127 + 15;
+  GLuint mantissa = bits & 0x7FFFFFu;
+  if (exponent >= 31)
+    return static_cast<GLushort>(sign | 0x7C00u | (((bits >> 23) & 0xFFu) == 0xFFu && mantissa != 0 ? 0x200u : 0u));
+  if (exponent <= 0)
+  {
+    // Subnormal halves, anything smaller than half the smallest one is 0
+    if (exponent < -10)
+      return static_cast<GLushort>(sign);
+    mantissa |= 0x800000u;
+    const int shift = 14 - exponent;
+    GLuint half = mantissa >> shift;
+    const GLuint rest = mantissa & ((1u << shift) - 1);
+    const GLuint midpoint = 1u << (shift - 1);
+    if (rest > midpoint || (rest == midpoint && (half & 1u)))
+      ++half;
+    return static_cast<GLushort>(sign | half);
   }
+  GLuint half = (static_cast<GLuint>(exponent) << 10) | (mantissa >> 13);
+  const GLuint rest = mantissa & 0x1FFFu;
+  // A carry out of the mantissa correctly moves to the next exponent
+  if (rest > 0x1000u || (rest == 0x1000u && (half & 1u)))
+    ++half;
+  return static_cast<GLushort>(sign | half);
+}
+
+float halfToFloat(const GLushort _half)
+{
+  const GLuint exponent = (_half >> 10) & 0x1Fu;
+  const float mantissa = static_cast<float>(_half & 0x3FFu);
+  float value = exponent == 0 ? std::ldexp(mantissa, -24) :
+                exponent == 31 ? (mantissa == 0.0f ? INFINITY : NAN) :
+                std::ldexp(1024.0f + mantissa, static_cast<int>(exponent) - 25);
+  return (_half & 0x8000u) ? -value : value;
+}
+
+// Signed normalized 10 bit value, decoded the GL 4.2 way as max(v / 511, -1)
+GLuint toSnorm10(const float _value)
+{
+  const int value = static_cast<int>(std::round(glm::clamp(_value, -1.0f, 1.0f) * 511.0f));
+  return static_cast<GLuint>(value) & 0x3FFu;
+}
+
+float fromSnorm10(const GLuint _bits)
+{
+  const GLuint bits = _bits & 0x3FFu;
+  const int value = (bits & 0x200u) ? static_cast<int>(bits) - 1024 : static_cast<int>(bits);
+  return std::max(static_cast<float>(value) / 511.0f, -1.0f);
+}
+
+// Builds the quantized copy of the vertex data if it is missing, and measures what it lost
+void quantize(MeshStorage &io_data)
+{
+  if (!io_data.quantized.empty() || io_data.vertices.empty())
+    return;
+  const bool hasUVs = !io_data.uvs.empty();
+  const bool hasTangents = !io_data.tangents.empty();
+  // Flat axes keep a unit scale so the position matrix stays invertible
+  glm::vec3 extent = io_data.max - io_data.min;
+  for (int axis = 0; axis < 3; ++axis)
+    extent[axis] = extent[axis] > 0.0f ? extent[axis] : 1.0f;
+  QuantizationError error;
+  io_data.quantized.reserve(io_data.vertices.size() * ((hasUVs ? 4 : 3) + (hasTangents ? 1 : 0)));
+  for (size_t i = 0; i < io_data.vertices.size(); ++i)
+  {
+    const glm::vec3& vert = io_data.vertices[i];
+    GLuint position[3];
+    glm::vec3 decoded;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      const float fraction = glm::clamp((vert[axis] - io_data.min[axis]) / extent[axis], 0.0f, 1.0f);
+      position[axis] = static_cast<GLuint>(std::round(fraction * 65535.0f));
+      decoded[axis] = io_data.min[axis] + static_cast<float>(position[axis]) / 65535.0f * extent[axis];
+    }
+    error.position = std::max(error.position, glm::length(decoded - vert));
+    // The last two bits hold w = 1
+    const glm::vec3 norm = glm::length(io_data.normals[i]) > 0.0f ? glm::normalize(io_data.normals[i]) : glm::vec3(0.0f, 0.0f, 1.0f);
+    const GLuint normal = toSnorm10(norm.x) | (toSnorm10(norm.y) << 10) | (toSnorm10(norm.z) << 20) | (1u << 30);
+    const glm::vec3 normalDecoded(fromSnorm10(normal), fromSnorm10(normal >> 10), fromSnorm10(normal >> 20));
+    const float cosine = glm::clamp(glm::dot(norm, glm::normalize(normalDecoded)), -1.0f, 1.0f);
+    error.normal = std::max(error.normal, glm::degrees(std::acos(cosine)));
+    io_data.quantized.insert(io_data.quantized.end(), {position[0] | (position[1] << 16), position[2], normal});
+    if (hasUVs)
+    {
+      const glm::vec2& uv = io_data.uvs[i];
+      const GLushort u = floatToHalf(uv.x);
+      const GLushort v = floatToHalf(uv.y);
+      error.uv = std::max({error.uv, std::abs(halfToFloat(u) - uv.x), std::abs(halfToFloat(v) - uv.y)});
+      io_data.quantized.push_back(u | (static_cast<GLuint>(v) << 16));
+    }
+    if (hasTangents)
+    {
+      // The handedness goes in the two w bits, 1 or -1
+      const glm::vec4& tangent = io_data.tangents[i];
+      io_data.quantized.push_back(toSnorm10(tangent.x) | (toSnorm10(tangent.y) << 10) | (toSnorm10(tangent.z) << 20) |
+                                  ((tangent.w < 0.0f ? 3u : 1u) << 30));
+    }
+  }
+  io_data.quantizationError = error;
+}
+
+// Builds the copy of the vertex data a layout uploads, planar uses the arrays as they are
+void prepareLayout(MeshStorage &io_data, const MeshAttributes::Layout _layout)
+{
+  if (_layout == MeshAttributes::INTERLEAVED)
+    interleave(io_data);
+  else if (_layout == MeshAttributes::QUANTIZED)
+    quantize(io_data);
+}
+
+// Imports a file into empty storage and prepares it the way loads do, bounds, optimizer passes and hash
+bool importStorage(const std::string &_fname, const bool _nativeObj, const unsigned int _passes, const std::function<bool(float)> &_progress,
+                   MeshStorage &o_data)
+{
+  // OBJ files go through the native importer, Assimp takes everything it can't read
+  bool imported = false;
+  if (_nativeObj && ObjLoader::handles(_fname))
+  {
+    imported = ObjLoader::load(_fname, o_data, _progress);
+    if (!imported)
+      o_data = MeshStorage();
+  }
+  if (!imported && !importAssimp(_fname, s_importFlags, _progress, o_data))
+    return false;
+  computeBounds(o_data);
+  // Optimized once here, cached meshes are stored in the optimized order
+  if (_passes != 0)
+    MeshOptimizer::optimize(o_data, _passes);
+
+  size_t hash = 14695981039346656037ull;
+  hash = hashArray(o_data.vertices, hash);
+  hash = hashArray(o_data.normals, hash);
+  hash = hashArray(o_data.uvs, hash);
+  hash = hashArray(o_data.indices, hash);
+  hash = hashArray(o_data.indices32, hash);
+  hash = hashArray(o_data.subMeshes, hash);
+  hash = hashArray(o_data.lods, hash);
+  hash = hashArray(o_data.meshlets, hash);
+  hash = hashArray(o_data.tangents, hash);
+  o_data.hash = hash == 0 ? 1 : hash;
+  return true;
+}
+}
+
 
-  // Get the number of faces on the mesh
-  size_t numFaces = mesh->mNumFaces;
-  // We iterate through faces not vertices,
-  // as the verts will be duplicated when used by more than one face.
-  for (size_t faceIndex = 0; faceIndex < numFaces; ++faceIndex)
+void Mesh::load(const std::string &_fname)
+{
+  load(_fname, [](float){ return true; });
+}
+
+bool Mesh::load(const std::string &_fname, const std::function<bool(float)> &_progress)
+{
+  m_source = _fname;
+  m_fromCache = false;
+  // A model imported before with the same importer, flags and passes is read straight from the cache
+  const std::string cacheEntry = m_useCache ? MeshCache::entryPath(_fname, m_nativeObj, s_importFlags, m_optimization) : std::string();
+  if (!cacheEntry.empty())
   {
-    auto& face = mesh->mFaces[faceIndex];
-    // Iterate over the vertices of this face
-    for (size_t i = 0; i < face.mNumIndices; ++i)
+    auto cached = std::make_shared<MeshStorage>();
+    if (MeshCache::read(cacheEntry, *cached))
     {
-      // Get the index of the vertex, we use this for it's normals and UV's too
-      size_t vertInFace = face.mIndices[i];
-      m_indices.push_back(vertInFace);
+      m_data = cached;
+      m_fromCache = true;
+      prepareLayout(*m_data, m_layout);
+      return _progress(1.0f);
     }
   }
+
+  // Filled into fresh storage, other meshes may still share the current one
+  auto data = std::make_shared<MeshStorage>();
+  if (!importStorage(_fname, m_nativeObj, m_optimization, _progress, *data))
+    return false;
+  // Aborted imports are not cached
+  const bool finished = _progress(1.0f);
+  if (finished && !cacheEntry.empty())
+    MeshCache::write(cacheEntry, *data);
+  prepareLayout(*data, m_layout);
+  m_data = data;
+  return finished;
+}
+
+const GeometryArena::Allocation* MeshStorage::uploaded() const noexcept
+{
+  for (const auto& range : gpu)
+  {
+    if (range != nullptr)
+      return range.get();
+  }
+  return nullptr;
+}
+
+void MeshStorage::setIndices(std::vector<GLuint> &&_indices)
+{
+  // Index 65535 is still addressable, so 65536 vertices fit in 16 bits
+  if (vertices.size() <= 65536)
+  {
+    indices.assign(_indices.begin(), _indices.end());
+    indices32.clear();
+  }
+  else
+  {
+    indices.clear();
+    indices32 = std::move(_indices);
+  }
 }
 
 void Mesh::reset()
 {
-  m_indices.clear();
-  m_vertices.clear();
-  m_normals.clear();
-  m_uvs.clear();
+  // Only drops this mesh's share, the arrays are freed with their last user
+  m_data = std::make_shared<MeshStorage>();
 }
 
-const GLushort *Mesh::getIndicesData() const noexcept
+size_t Mesh::residentBytes() const
 {
-  return &m_indices[0];
+  return m_data->indices.capacity() * sizeof(GLushort) + m_data->indices32.capacity() * sizeof(GLuint) +
+         m_data->subMeshes.capacity() * sizeof(SubMesh) + m_data->lods.capacity() * sizeof(MeshLod) +
+         m_data->meshlets.capacity() * sizeof(Meshlet) +
+         (m_data->vertices.capacity() + m_data->normals.capacity()) * sizeof(glm::vec3) +
+         m_data->uvs.capacity() * sizeof(glm::vec2) + m_data->tangents.capacity() * sizeof(glm::vec4) +
+         m_data->interleaved.capacity() * sizeof(GLfloat) +
+         m_data->quantized.capacity() * sizeof(GLuint);
+}
+
+size_t Mesh::contentHash() const
+{
+  return m_data->hash;
+}
+
+bool Mesh::shareStorage(const BaseMesh &_other)
+{
+  auto other = dynamic_cast<const Mesh*>(&_other);
+  if (other == nullptr || other->m_data->hash != m_data->hash)
+    return false;
+  // A matching hash is not proof, the arrays are compared before aliasing. Released arrays can't be, the
+  // hash and the ranges have to do then
+  const MeshStorage& a = *m_data;
+  const MeshStorage& b = *other->m_data;
+  const bool compareArrays = !a.released && !b.released;
+  if ((compareArrays && (a.vertices != b.vertices || a.normals != b.normals || a.uvs != b.uvs || a.tangents != b.tangents ||
+                         a.indices != b.indices || a.indices32 != b.indices32)) ||
+      !std::equal(a.subMeshes.begin(), a.subMeshes.end(), b.subMeshes.begin(), b.subMeshes.end(), [](const SubMesh &_a, const SubMesh &_b)
+      {
+        return _a.firstIndex == _b.firstIndex && _a.indexCount == _b.indexCount &&
+               _a.firstMeshlet == _b.firstMeshlet && _a.meshletCount == _b.meshletCount;
+      }) ||
+      !std::equal(a.lods.begin(), a.lods.end(), b.lods.begin(), b.lods.end(), [](const MeshLod &_a, const MeshLod &_b)
+      {
+        return _a.firstSubMesh == _b.firstSubMesh && _a.subMeshCount == _b.subMeshCount;
+      }) ||
+      !std::equal(a.meshlets.begin(), a.meshlets.end(), b.meshlets.begin(), b.meshlets.end(), [](const Meshlet &_a, const Meshlet &_b)
+      {
+        return _a.firstIndex == _b.firstIndex && _a.indexCount == _b.indexCount;
+      }))
+    return false;
+  m_data = other->m_data;
+  prepareLayout(*m_data, m_layout);
+  return true;
+}
+
+const void* Mesh::storageID() const
+{
+  return m_data.get();
+}
+
+size_t Mesh::gpuBytes() const
+{
+  size_t bytes = 0;
+  for (const auto& range : m_data->gpu)
+    bytes += range == nullptr ? 0 : range->byteSize();
+  return bytes;
+}
+
+const GeometryArena::Allocation* Mesh::upload(GeometryArena &io_arena)
+{
+  using namespace MeshAttributes;
+  // Meshes sharing the storage share its range for each layout, so meshes asking for different layouts
+  // don't replace each other's upload every frame. It is only uploaded again for another arena.
+  const Layout layout = m_layout == PLANAR ? INTERLEAVED : m_layout;
+  auto& range = m_data->gpu[layout];
+  if (range != nullptr && range->arena() == &io_arena)
+    return range.get();
+  if (!fetchArrays() || getNIndicesData() == 0)
+    return nullptr;
+  prepareLayout(*m_data, layout);
+  const void* vertices = layout == INTERLEAVED ? static_cast<const void*>(getInterleavedData()) : getQuantizedData();
+  auto gpu = io_arena.upload(getIndexType(), getIndicesData(), getNIndicesData(), vertices, getNVertData(), getNUVData(),
+                             getNNormData(), getNTangentData(), layout);
+  if (gpu == nullptr)
+    return nullptr;
+  range = std::move(gpu);
+  if (m_residency == GPU_ONLY)
+    releaseArrays();
+  return range.get();
+}
+
+void Mesh::releaseArrays()
+{
+  // Without buffers the arrays are the only copy of the mesh
+  if (m_data->uploaded() == nullptr || m_data->released)
+    return;
+  MeshStorage& data = *m_data;
+  data.released = true;
+  // Swapped with empty vectors, clear would keep the capacity
+  std::vector<glm::vec3>().swap(data.vertices);
+  std::vector<glm::vec3>().swap(data.normals);
+  std::vector<glm::vec2>().swap(data.uvs);
+  std::vector<glm::vec4>().swap(data.tangents);
+  std::vector<GLushort>().swap(data.indices);
+  std::vector<GLuint>().swap(data.indices32);
+  std::vector<GLfloat>().swap(data.interleaved);
+  std::vector<GLuint>().swap(data.quantized);
+}
+
+bool Mesh::fetchArrays()
+{
+  if (!m_data->released)
+    return true;
+  // The cache entry holds exactly what the import made, importing again is the fallback
+  MeshStorage fetched;
+  const std::string cacheEntry = m_useCache ? MeshCache::entryPath(m_source, m_nativeObj, s_importFlags, m_optimization) : std::string();
+  if ((cacheEntry.empty() || !MeshCache::read(cacheEntry, fetched)) &&
+      (m_source.empty() || !importStorage(m_source, m_nativeObj, m_optimization, [](float){ return true; }, fetched)))
+    return false;
+  // The file may have changed since it was loaded
+  if (fetched.hash != m_data->hash)
+    return false;
+  MeshStorage& data = *m_data;
+  data.vertices = std::move(fetched.vertices);
+  data.normals = std::move(fetched.normals);
+  data.uvs = std::move(fetched.uvs);
+  data.tangents = std::move(fetched.tangents);
+  data.indices = std::move(fetched.indices);
+  data.indices32 = std::move(fetched.indices32);
+  data.released = false;
+  return true;
+}
+
+bool Mesh::hasArrays() const noexcept
+{
+  return !m_data->released;
+}
+
+BaseMesh::Bounds Mesh::getBounds() const
+{
+  Bounds ret;
+  // Counted from the buffers once the arrays are released
+  ret.empty = getNVertData() == 0;
+  ret.min = m_data->min;
+  ret.max = m_data->max;
+  ret.centre = m_data->centre;
+  ret.radius = m_data->radius;
+  return ret;
+}
+
+const void *Mesh::getIndicesData() const noexcept
+{
+  if (!m_data->indices32.empty())
+    return m_data->indices32.data();
+  return m_data->indices.data();
+}
+
+GLenum Mesh::getIndexType() const noexcept
+{
+  if (m_data->released)
+    return m_data->uploaded()->indexType();
+  return m_data->indices32.empty() ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
 }
 
 const GLfloat* Mesh::getVertexData() const noexcept
 {
-  return &m_vertices[0].x;
+  return reinterpret_cast<const GLfloat*>(m_data->vertices.data());
 }
 
 const GLfloat* Mesh::getNormalsData() const noexcept
 {
-  return &m_normals[0].x;
+  return reinterpret_cast<const GLfloat*>(m_data->normals.data());
 }
 
 const GLfloat *Mesh::getUVsData() const noexcept
 {
-  return &m_uvs[0].x;
+  return reinterpret_cast<const GLfloat*>(m_data->uvs.data());
+}
+
+const GLfloat *Mesh::getTangentsData() const noexcept
+{
+  return reinterpret_cast<const GLfloat*>(m_data->tangents.data());
 }
 
 const GLfloat *Mesh::getAttribData(const MeshAttributes::Attribute _attrib) const noexcept
@@ -96,35 +627,164 @@ const GLfloat *Mesh::getAttribData(const MeshAttributes::Attribute _attrib) cons
   const GLfloat * data = nullptr;
   switch (_attrib)
   {
-    case VERTEX: data = getVertexData(); break;
-    case NORMAL: data = getNormalsData(); break;
-    case UV:     data = getUVsData(); break;
+    case VERTEX:  data = getVertexData(); break;
+    case NORMAL:  data = getNormalsData(); break;
+    case UV:      data = getUVsData(); break;
+    case TANGENT: data = getTangentsData(); break;
     default: break;
   }
   return data;
 }
 
+const GLfloat *Mesh::getInterleavedData() const noexcept
+{
+  return m_data->interleaved.empty() ? nullptr : m_data->interleaved.data();
+}
+
+const GLuint *Mesh::getQuantizedData() const noexcept
+{
+  return m_data->quantized.empty() ? nullptr : m_data->quantized.data();
+}
+
+QuantizationError Mesh::getQuantizationError() const noexcept
+{
+  return m_layout == MeshAttributes::QUANTIZED ? m_data->quantizationError : QuantizationError();
+}
+
+glm::mat4 Mesh::getPositionMatrix() const noexcept
+{
+  if (m_layout != MeshAttributes::QUANTIZED)
+    return glm::mat4(1.0f);
+  // Matches the extent used by quantize
+  glm::vec3 extent = m_data->max - m_data->min;
+  for (int axis = 0; axis < 3; ++axis)
+    extent[axis] = extent[axis] > 0.0f ? extent[axis] : 1.0f;
+  return glm::scale(glm::translate(glm::mat4(1.0f), m_data->min), extent);
+}
+
+void Mesh::setLayout(const MeshAttributes::Layout _layout)
+{
+  m_layout = _layout;
+  prepareLayout(*m_data, m_layout);
+}
+
+MeshAttributes::Layout Mesh::getLayout() const noexcept
+{
+  return m_layout;
+}
+
 int Mesh::getNIndicesData() const noexcept
 {
-  return static_cast<int>(m_indices.size());
+  // Released arrays are counted from the buffers they were uploaded to
+  if (m_data->released)
+    return m_data->uploaded()->indexAmount();
+  return static_cast<int>(m_data->indices.size() + m_data->indices32.size());
 }
 
 int Mesh::getNVertData() const noexcept
 {
-  return static_cast<int>(m_vertices.size()) * 3;
+  if (m_data->released)
+    return m_data->uploaded()->dataAmount(MeshAttributes::VERTEX);
+  return static_cast<int>(m_data->vertices.size()) * 3;
 }
 
 int Mesh::getNNormData() const noexcept
 {
-  return static_cast<int>(m_normals.size()) * 3;
+  if (m_data->released)
+    return m_data->uploaded()->dataAmount(MeshAttributes::NORMAL);
+  return static_cast<int>(m_data->normals.size()) * 3;
 }
 
 int Mesh::getNUVData() const noexcept
 {
-  return static_cast<int>(m_uvs.size()) * 2;
+  if (m_data->released)
+    return m_data->uploaded()->dataAmount(MeshAttributes::UV);
+  return static_cast<int>(m_data->uvs.size()) * 2;
+}
+
+int Mesh::getNTangentData() const noexcept
+{
+  if (m_data->released)
+    return m_data->uploaded()->dataAmount(MeshAttributes::TANGENT);
+  return static_cast<int>(m_data->tangents.size()) * 4;
+}
+
+bool Mesh::loadedFromCache() const noexcept
+{
+  return m_fromCache;
+}
+
+size_t Mesh::getSubMeshCount() const noexcept
+{
+  return m_data->subMeshes.size();
+}
+
+const SubMesh& Mesh::getSubMesh(const size_t _index) const
+{
+  return m_data->subMeshes[_index];
+}
+
+size_t Mesh::getLodCount() const noexcept
+{
+  return m_data->lods.size();
+}
+
+const MeshLod& Mesh::getLod(const size_t _level) const
+{
+  return m_data->lods[_level];
+}
+
+GLuint Mesh::getLodIndexCount(const size_t _level) const
+{
+  const MeshLod& lod = m_data->lods[_level];
+  if (lod.subMeshCount == 0)
+    return 0;
+  const SubMesh& first = m_data->subMeshes[lod.firstSubMesh];
+  const SubMesh& last = m_data->subMeshes[lod.firstSubMesh + lod.subMeshCount - 1];
+  return last.firstIndex + last.indexCount - first.firstIndex;
+}
+
+const Meshlet& Mesh::getMeshlet(const size_t _index) const
+{
+  return m_data->meshlets[_index];
+}
+
+const glm::vec3& Mesh::getMin() const noexcept
+{
+  return m_data->min;
+}
+
+const glm::vec3& Mesh::getMax() const noexcept
+{
+  return m_data->max;
+}
+
+void Mesh::setUseCache(const bool _use) noexcept
+{
+  m_useCache = _use;
+}
+
+void Mesh::setNativeObj(const bool _use) noexcept
+{
+  m_nativeObj = _use;
+}
+
+void Mesh::setOptimization(const unsigned int _passes) noexcept
+{
+  m_optimization = _passes;
+}
+
+void Mesh::setResidency(const Residency _mode) noexcept
+{
+  m_residency = _mode;
+}
+
+Mesh::Residency Mesh::getResidency() const noexcept
+{
+  return m_residency;
 }
 
 int Mesh::getNData() const noexcept
 {
-  return getNVertData() + getNNormData() + getNUVData();
+  return getNVertData() + getNNormData() + getNUVData() + getNTangentData();
 }
@@ -0,0 +1,199 @@
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QCryptographicHash>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+// Entry layout, native byte order since entries never leave the machine that wrote them:
+// magic, version, vertex/normal/UV/16 bit index/32 bit index/submesh/LOD/meshlet/tangent counts, min, max, sphere centre
+// and radius, content hash, then the arrays back to back
+constexpr char s_magic[4] = {'M','L','E','M'};
+constexpr quint32 s_version = 7;
+constexpr size_t s_headerSize = 4 + 4 + 9 * 4 + 10 * 4 + 8;
+
+template<typename T>
+void appendArray(QByteArray &io_blob, const std::vector<T> &_array)
+{
+  io_blob.append(reinterpret_cast<const char*>(_array.data()), static_cast<int>(_array.size() * sizeof(T)));
+}
+
+// Every range in the entry must lie inside the arrays it points into, anything else is a stale or damaged entry
+bool validRanges(const MeshStorage &_data)
+{
+  const quint64 vertexCount = _data.vertices.size();
+  for (const size_t attribute : {_data.normals.size(), _data.uvs.size(), _data.tangents.size()})
+  {
+    if (attribute != 0 && attribute != vertexCount)
+      return false;
+  }
+  if (!_data.indices.empty() && !_data.indices32.empty())
+    return false;
+  const quint64 indexCount = _data.indices.size() + _data.indices32.size();
+  if (indexCount != 0 && _data.lods.empty())
+    return false;
+  for (const auto index : _data.indices)
+  {
+    if (index >= vertexCount)
+      return false;
+  }
+  for (const auto index : _data.indices32)
+  {
+    if (index >= vertexCount)
+      return false;
+  }
+  for (const auto &subMesh : _data.subMeshes)
+  {
+    if (quint64(subMesh.firstIndex) + subMesh.indexCount > indexCount ||
+        quint64(subMesh.firstMeshlet) + subMesh.meshletCount > _data.meshlets.size())
+      return false;
+  }
+  for (const auto &meshlet : _data.meshlets)
+  {
+    if (quint64(meshlet.firstIndex) + meshlet.indexCount > indexCount)
+      return false;
+  }
+  for (const auto &lod : _data.lods)
+  {
+    if (quint64(lod.firstSubMesh) + lod.subMeshCount > _data.subMeshes.size())
+      return false;
+    // A level is drawn as one range, from its first part to the end of its last
+    for (GLuint i = 1; i < lod.subMeshCount; ++i)
+    {
+      const SubMesh& previous = _data.subMeshes[lod.firstSubMesh + i - 1];
+      if (_data.subMeshes[lod.firstSubMesh + i].firstIndex < previous.firstIndex + previous.indexCount)
+        return false;
+    }
+  }
+  return true;
+}
+
+template<typename T>
+const uchar* readArray(const uchar* _it, const quint32 _count, std::vector<T> &o_array)
+{
+  o_array.resize(_count);
+  std::memcpy(o_array.data(), _it, _count * sizeof(T));
+  return _it + _count * sizeof(T);
+}
+}
+
+std::string MeshCache::entryPath(const std::string &_fname, const bool _nativeObj, const unsigned int _importFlags, const unsigned int _passes)
+{
+  QFile model(QString::fromStdString(_fname));
+  if (!model.open(QIODevice::ReadOnly))
+    return std::string();
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  const qint64 size = model.size();
+  uchar* mapped = size > 0 ? model.map(0, size) : nullptr;
+  if (mapped != nullptr)
+  {
+    hash.addData(reinterpret_cast<const char*>(mapped), static_cast<int>(size));
+    model.unmap(mapped);
+  }
+  else
+  {
+    hash.addData(model.readAll());
+  }
+  model.close();
+  // The importers weld and order vertices differently, so each gets its own entries
+  const bool native = _nativeObj && ObjLoader::handles(_fname);
+  const QString name = QString::fromLatin1(hash.result().toHex()) + (native ? "_native_" : "_assimp_") +
+                       QString::number(_importFlags, 16) + "_" + QString::number(_passes, 16) + ".mlem";
+  return (QFileInfo(model).absolutePath() + "/cache/" + name).toStdString();
+}
+
+bool MeshCache::read(const std::string &_entry, MeshStorage &o_data)
+{
+  QFile file(QString::fromStdString(_entry));
+  if (!file.open(QIODevice::ReadOnly) || file.size() < static_cast<qint64>(s_headerSize))
+    return false;
+  const quint64 size = static_cast<quint64>(file.size());
+  const uchar* blob = file.map(0, file.size());
+  if (blob == nullptr || std::memcmp(blob, s_magic, 4) != 0)
+    return false;
+  quint32 header[10];
+  float bounds[10];
+  quint64 hash;
+  std::memcpy(header, blob + 4, sizeof(header));
+  std::memcpy(bounds, blob + 44, sizeof(bounds));
+  std::memcpy(&hash, blob + 84, sizeof(hash));
+  const quint64 expected = s_headerSize + quint64(header[1]) * sizeof(glm::vec3) + quint64(header[2]) * sizeof(glm::vec3) +
+                           quint64(header[3]) * sizeof(glm::vec2) + quint64(header[4]) * sizeof(GLushort) +
+                           quint64(header[5]) * sizeof(GLuint) + quint64(header[6]) * sizeof(SubMesh) + quint64(header[7]) * sizeof(MeshLod) +
+                           quint64(header[8]) * sizeof(Meshlet) + quint64(header[9]) * sizeof(glm::vec4);
+  if (header[0] != s_version || expected != size)
+    return false;
+  // Read aside and checked before anything reaches o_data
+  MeshStorage data;
+  const uchar* it = blob + s_headerSize;
+  it = readArray(it, header[1], data.vertices);
+  it = readArray(it, header[2], data.normals);
+  it = readArray(it, header[3], data.uvs);
+  it = readArray(it, header[4], data.indices);
+  it = readArray(it, header[5], data.indices32);
+  it = readArray(it, header[6], data.subMeshes);
+  it = readArray(it, header[7], data.lods);
+  it = readArray(it, header[8], data.meshlets);
+  readArray(it, header[9], data.tangents);
+  if (!validRanges(data))
+    return false;
+  o_data.vertices = std::move(data.vertices);
+  o_data.normals = std::move(data.normals);
+  o_data.uvs = std::move(data.uvs);
+  o_data.indices = std::move(data.indices);
+  o_data.indices32 = std::move(data.indices32);
+  o_data.subMeshes = std::move(data.subMeshes);
+  o_data.lods = std::move(data.lods);
+  o_data.meshlets = std::move(data.meshlets);
+  o_data.tangents = std::move(data.tangents);
+  o_data.min = glm::vec3(bounds[0], bounds[1], bounds[2]);
+  o_data.max = glm::vec3(bounds[3], bounds[4], bounds[5]);
+  o_data.centre = glm::vec3(bounds[6], bounds[7], bounds[8]);
+  o_data.radius = bounds[9];
+  o_data.hash = static_cast<size_t>(hash);
+  return true;
+}
+
+bool MeshCache::write(const std::string &_entry, const MeshStorage &_data)
+{
+  QByteArray blob(s_magic, 4);
+  const quint32 header[10] = {s_version,
+                             static_cast<quint32>(_data.vertices.size()),
+                             static_cast<quint32>(_data.normals.size()),
+                             static_cast<quint32>(_data.uvs.size()),
+                             static_cast<quint32>(_data.indices.size()),
+                             static_cast<quint32>(_data.indices32.size()),
+                             static_cast<quint32>(_data.subMeshes.size()),
+                             static_cast<quint32>(_data.lods.size()),
+                             static_cast<quint32>(_data.meshlets.size()),
+                             static_cast<quint32>(_data.tangents.size())};
+  const float bounds[10] = {_data.min.x, _data.min.y, _data.min.z, _data.max.x, _data.max.y, _data.max.z,
+                            _data.centre.x, _data.centre.y, _data.centre.z, _data.radius};
+  const quint64 hash = _data.hash;
+  blob.append(reinterpret_cast<const char*>(header), sizeof(header));
+  blob.append(reinterpret_cast<const char*>(bounds), sizeof(bounds));
+  blob.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+  appendArray(blob, _data.vertices);
+  appendArray(blob, _data.normals);
+  appendArray(blob, _data.uvs);
+  appendArray(blob, _data.indices);
+  appendArray(blob, _data.indices32);
+  appendArray(blob, _data.subMeshes);
+  appendArray(blob, _data.lods);
+  appendArray(blob, _data.meshlets);
+  appendArray(blob, _data.tangents);
+
+  const QString path = QString::fromStdString(_entry);
+  QDir().mkpath(QFileInfo(path).absolutePath());
+  // Written to a temporary file and renamed on commit, so concurrent writers and readers never see half an entry
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+  file.write(blob);
+  return file.commit();
+}
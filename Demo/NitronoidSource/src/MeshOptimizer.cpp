@@ -0,0 +1,372 @@
+#include "MeshOptimizer.h"
+#include "Mesh.h"
+#include "MeshSimplifier.h"
+#include "Meshlets.h"
+#include "Tangents.h"
+#include <glm.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+// Overdraw clusters are split again where their cache use is already within this factor of the whole
+// cluster's, more clusters sort better but every split costs a few misses
+constexpr float s_overdrawThreshold = 1.05f;
+
+// FIFO cache made of insertion times, a vertex is cached while fewer than the cache size went in after it
+class FifoCache
+{
+public:
+  FifoCache(const size_t _vertexCount, const size_t _size) : m_stamps(_vertexCount, 0), m_time(_size + 1), m_size(_size) {}
+  bool cached(const GLuint _vertex) const
+  {
+    return m_time - m_stamps[_vertex] <= m_size;
+  }
+  // Returns true on a miss
+  bool access(const GLuint _vertex)
+  {
+    if (cached(_vertex))
+      return false;
+    m_stamps[_vertex] = m_time++;
+    return true;
+  }
+  size_t age(const GLuint _vertex) const
+  {
+    return m_time - m_stamps[_vertex];
+  }
+  void flush()
+  {
+    m_time += m_size + 1;
+  }
+private:
+  std::vector<size_t> m_stamps;
+  size_t m_time;
+  size_t m_size;
+};
+
+std::vector<GLuint> indices32(const MeshStorage &_data)
+{
+  if (!_data.indices32.empty())
+    return _data.indices32;
+  return std::vector<GLuint>(_data.indices.begin(), _data.indices.end());
+}
+
+// Triangles using each vertex, the ones of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1]]
+struct Adjacency
+{
+  std::vector<GLuint> offsets;
+  std::vector<GLuint> triangles;
+};
+
+Adjacency buildAdjacency(const GLuint* _indices, const size_t _count, const size_t _vertexCount)
+{
+  Adjacency adjacency;
+  adjacency.offsets.assign(_vertexCount + 1, 0);
+  for (size_t i = 0; i < _count; ++i)
+    ++adjacency.offsets[_indices[i] + 1];
+  std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+  std::vector<GLuint> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+  adjacency.triangles.resize(_count);
+  for (size_t i = 0; i < _count; ++i)
+    adjacency.triangles[fill[_indices[i]]++] = static_cast<GLuint>(i / 3);
+  return adjacency;
+}
+
+// Tipsify, emits fans around one vertex at a time and moves on to the neighbour that is still cached and
+// will not be evicted before its remaining triangles are emitted. o_clusters receives the first triangle of
+// every run that starts on a vertex that is no longer cached.
+void tipsify(const GLuint* _indices, const size_t _count, const size_t _vertexCount, GLuint* o_indices, std::vector<size_t> &o_clusters)
+{
+  using MeshOptimizer::s_cacheSize;
+  const Adjacency adjacency = buildAdjacency(_indices, _count, _vertexCount);
+  std::vector<GLuint> live(_vertexCount);
+  for (size_t v = 0; v < _vertexCount; ++v)
+    live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+  std::vector<bool> emitted(_count / 3, false);
+  std::vector<GLuint> deadEnds;
+  std::vector<GLuint> candidates;
+  deadEnds.reserve(_count);
+  FifoCache cache(_vertexCount, s_cacheSize);
+  size_t written = 0;
+  size_t scan = 0;
+  long fan = 0;
+  o_clusters.push_back(0);
+  while (fan >= 0)
+  {
+    candidates.clear();
+    for (GLuint i = adjacency.offsets[fan]; i < adjacency.offsets[fan + 1]; ++i)
+    {
+      const GLuint triangle = adjacency.triangles[i];
+      if (emitted[triangle])
+        continue;
+      emitted[triangle] = true;
+      for (size_t corner = triangle * 3; corner < triangle * 3 + 3; ++corner)
+      {
+        const GLuint v = _indices[corner];
+        o_indices[written++] = v;
+        deadEnds.push_back(v);
+        candidates.push_back(v);
+        --live[v];
+        cache.access(v);
+      }
+    }
+    // The oldest candidate that survives its own remaining triangles, which need at most 2 new vertices each
+    long next = -1;
+    size_t bestPriority = 0;
+    for (const GLuint v : candidates)
+    {
+      if (live[v] == 0)
+        continue;
+      const size_t priority = cache.age(v) + 2 * live[v] <= s_cacheSize ? cache.age(v) : 0;
+      if (next < 0 || priority > bestPriority)
+      {
+        next = v;
+        bestPriority = priority;
+      }
+    }
+    if (next < 0)
+    {
+      // Dead end, back up to a recently used vertex, then to any vertex with triangles left
+      while (next < 0 && !deadEnds.empty())
+      {
+        const GLuint v = deadEnds.back();
+        deadEnds.pop_back();
+        if (live[v] > 0)
+          next = v;
+      }
+      for (; next < 0 && scan < _vertexCount; ++scan)
+      {
+        if (live[scan] > 0)
+          next = static_cast<long>(scan);
+      }
+      if (next >= 0 && !cache.cached(static_cast<GLuint>(next)))
+        o_clusters.push_back(written / 3);
+    }
+    fan = next;
+  }
+}
+
+// Splits each cluster further wherever the cache use since the last split is already as good as the whole
+// cluster's, following Sander et al.
+void splitClusters(const std::vector<GLuint> &_indices, const size_t _vertexCount, std::vector<size_t> &io_clusters)
+{
+  using MeshOptimizer::s_cacheSize;
+  const size_t triangles = _indices.size() / 3;
+  std::vector<size_t> clusters;
+  FifoCache cache(_vertexCount, s_cacheSize);
+  for (size_t c = 0; c < io_clusters.size(); ++c)
+  {
+    const size_t begin = io_clusters[c];
+    const size_t end = c + 1 < io_clusters.size() ? io_clusters[c + 1] : triangles;
+    size_t misses = 0;
+    cache.flush();
+    for (size_t i = begin * 3; i < end * 3; ++i)
+      misses += cache.access(_indices[i]);
+    const float target = static_cast<float>(misses) / static_cast<float>(end - begin) * s_overdrawThreshold;
+
+    clusters.push_back(begin);
+    size_t start = begin;
+    misses = 0;
+    cache.flush();
+    for (size_t t = begin; t + 1 < end; ++t)
+    {
+      for (size_t i = t * 3; i < t * 3 + 3; ++i)
+        misses += cache.access(_indices[i]);
+      if (static_cast<float>(misses) <= target * static_cast<float>(t + 1 - start))
+      {
+        start = t + 1;
+        clusters.push_back(start);
+        misses = 0;
+        cache.flush();
+      }
+    }
+  }
+  io_clusters.swap(clusters);
+}
+
+// Orders clusters so the ones facing out from the centre of the part are drawn first, they are the most
+// likely to cover the others
+void sortClusters(std::vector<GLuint> &io_indices, const std::vector<size_t> &_clusters, const std::vector<glm::vec3> &_positions)
+{
+  const size_t triangles = io_indices.size() / 3;
+  std::vector<glm::vec3> centroids(_clusters.size());
+  std::vector<glm::vec3> normals(_clusters.size());
+  glm::vec3 centre(0.0f);
+  float totalArea = 0.0f;
+  for (size_t cluster = 0; cluster < _clusters.size(); ++cluster)
+  {
+    const size_t end = cluster + 1 < _clusters.size() ? _clusters[cluster + 1] : triangles;
+    glm::vec3 centroid(0.0f);
+    glm::vec3 normal(0.0f);
+    float area = 0.0f;
+    for (size_t t = _clusters[cluster]; t < end; ++t)
+    {
+      const glm::vec3& a = _positions[io_indices[t * 3]];
+      const glm::vec3& b = _positions[io_indices[t * 3 + 1]];
+      const glm::vec3& c = _positions[io_indices[t * 3 + 2]];
+      const glm::vec3 cross = glm::cross(b - a, c - a);
+      const float triangleArea = glm::length(cross);
+      centroid += (a + b + c) * (triangleArea / 3.0f);
+      normal += cross;
+      area += triangleArea;
+    }
+    centroids[cluster] = area > 0.0f ? centroid / area : centroid;
+    normals[cluster] = glm::length(normal) > 0.0f ? glm::normalize(normal) : normal;
+    centre += centroid;
+    totalArea += area;
+  }
+  if (totalArea > 0.0f)
+    centre /= totalArea;
+
+  std::vector<float> keys(_clusters.size());
+  for (size_t cluster = 0; cluster < _clusters.size(); ++cluster)
+    keys[cluster] = glm::dot(centroids[cluster] - centre, normals[cluster]);
+  std::vector<size_t> order(_clusters.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&keys](const size_t _a, const size_t _b){ return keys[_a] > keys[_b]; });
+
+  std::vector<GLuint> sorted;
+  sorted.reserve(io_indices.size());
+  for (const size_t cluster : order)
+  {
+    const size_t end = cluster + 1 < _clusters.size() ? _clusters[cluster + 1] : triangles;
+    sorted.insert(sorted.end(), io_indices.begin() + static_cast<long>(_clusters[cluster] * 3), io_indices.begin() + static_cast<long>(end * 3));
+  }
+  io_indices.swap(sorted);
+}
+
+template<typename T>
+void reorder(std::vector<T> &io_array, const std::vector<GLuint> &_remap)
+{
+  if (io_array.empty())
+    return;
+  std::vector<T> reordered(io_array.size());
+  for (size_t v = 0; v < io_array.size(); ++v)
+    reordered[_remap[v]] = io_array[v];
+  io_array.swap(reordered);
+}
+
+// Numbers vertices in the order the triangles first use them, unused vertices go last
+void remapVertices(MeshStorage &io_data, std::vector<GLuint> &io_indices)
+{
+  const GLuint unused = ~0u;
+  std::vector<GLuint> remap(io_data.vertices.size(), unused);
+  GLuint next = 0;
+  for (GLuint& index : io_indices)
+  {
+    if (remap[index] == unused)
+      remap[index] = next++;
+    index = remap[index];
+  }
+  for (GLuint& target : remap)
+  {
+    if (target == unused)
+      target = next++;
+  }
+  reorder(io_data.vertices, remap);
+  reorder(io_data.normals, remap);
+  reorder(io_data.uvs, remap);
+  reorder(io_data.tangents, remap);
+}
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::analyzeVertexCache(const std::vector<GLuint> &_indices, const size_t _vertexCount, const size_t _cacheSize)
+{
+  CacheStats stats;
+  if (_indices.empty())
+    return stats;
+  FifoCache cache(_vertexCount, _cacheSize);
+  std::vector<bool> used(_vertexCount, false);
+  size_t misses = 0;
+  size_t vertices = 0;
+  for (const GLuint index : _indices)
+  {
+    misses += cache.access(index);
+    if (!used[index])
+    {
+      used[index] = true;
+      ++vertices;
+    }
+  }
+  stats.acmr = static_cast<float>(misses) / static_cast<float>(_indices.size() / 3);
+  stats.atvr = static_cast<float>(misses) / static_cast<float>(vertices);
+  return stats;
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::analyze(const MeshStorage &_data)
+{
+  return analyzeVertexCache(indices32(_data), _data.vertices.size());
+}
+
+void MeshOptimizer::optimize(MeshStorage &io_data, const unsigned int _passes)
+{
+  // Built first so the levels get the other passes too
+  if (_passes & LOD)
+    MeshSimplifier::buildLods(io_data);
+  if (_passes & MESHLETS)
+    Meshlets::build(io_data);
+  std::vector<GLuint> indices = indices32(io_data);
+  // Triangles are reordered within meshlets when there are some, so each stays one index range
+  std::vector<std::pair<GLuint, GLuint>> ranges;
+  if (io_data.meshlets.empty())
+  {
+    for (const SubMesh& part : io_data.subMeshes)
+      ranges.emplace_back(part.firstIndex, part.indexCount);
+  }
+  else
+  {
+    for (const Meshlet& meshlet : io_data.meshlets)
+      ranges.emplace_back(meshlet.firstIndex, meshlet.indexCount);
+  }
+  if (_passes & (VERTEX_CACHE | OVERDRAW))
+  {
+    const GLuint unused = ~0u;
+    std::vector<GLuint> local(io_data.vertices.size(), unused);
+    std::vector<GLuint> global;
+    std::vector<GLuint> partIndices;
+    std::vector<GLuint> ordered;
+    std::vector<glm::vec3> positions;
+    std::vector<size_t> clusters;
+    for (const auto& part : ranges)
+    {
+      const GLuint indexCount = part.second;
+      if (indexCount == 0)
+        continue;
+      // Renumbered from 0 within the range, so the work is proportional to the range rather than the mesh
+      GLuint* range = indices.data() + part.first;
+      global.clear();
+      partIndices.resize(indexCount);
+      for (size_t i = 0; i < indexCount; ++i)
+      {
+        if (local[range[i]] == unused)
+        {
+          local[range[i]] = static_cast<GLuint>(global.size());
+          global.push_back(range[i]);
+        }
+        partIndices[i] = local[range[i]];
+      }
+      for (const GLuint v : global)
+        local[v] = unused;
+
+      ordered.resize(indexCount);
+      clusters.clear();
+      tipsify(partIndices.data(), partIndices.size(), global.size(), ordered.data(), clusters);
+      if (_passes & OVERDRAW)
+      {
+        positions.resize(global.size());
+        for (size_t v = 0; v < global.size(); ++v)
+          positions[v] = io_data.vertices[global[v]];
+        splitClusters(ordered, global.size(), clusters);
+        sortClusters(ordered, clusters, positions);
+      }
+      for (size_t i = 0; i < indexCount; ++i)
+        range[i] = global[ordered[i]];
+    }
+  }
+  if (_passes & VERTEX_FETCH)
+    remapVertices(io_data, indices);
+  io_data.setIndices(std::move(indices));
+  // Last, so the tangents are made in the final vertex order
+  if (_passes & TANGENTS)
+    Tangents::generate(io_data);
+}
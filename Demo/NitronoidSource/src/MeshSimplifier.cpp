@@ -0,0 +1,291 @@
+#include "MeshSimplifier.h"
+#include "Mesh.h"
+#include <glm.hpp>
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <cstring>
+#include <cmath>
+
+namespace
+{
+// Sum of squared distances to a set of planes, weighted by triangle area, as a symmetric 4x4 matrix
+struct Quadric
+{
+  double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+  double b2 = 0.0, bc = 0.0, bd = 0.0;
+  double c2 = 0.0, cd = 0.0;
+  double d2 = 0.0;
+  double weight = 0.0;
+
+  void addPlane(const glm::vec3 &_normal, const double _d, const double _weight)
+  {
+    const double a = _normal.x;
+    const double b = _normal.y;
+    const double c = _normal.z;
+    a2 += a * a * _weight; ab += a * b * _weight; ac += a * c * _weight; ad += a * _d * _weight;
+    b2 += b * b * _weight; bc += b * c * _weight; bd += b * _d * _weight;
+    c2 += c * c * _weight; cd += c * _d * _weight;
+    d2 += _d * _d * _weight;
+    weight += _weight;
+  }
+
+  Quadric operator+(const Quadric &_other) const
+  {
+    Quadric sum = *this;
+    sum.a2 += _other.a2; sum.ab += _other.ab; sum.ac += _other.ac; sum.ad += _other.ad;
+    sum.b2 += _other.b2; sum.bc += _other.bc; sum.bd += _other.bd;
+    sum.c2 += _other.c2; sum.cd += _other.cd;
+    sum.d2 += _other.d2;
+    sum.weight += _other.weight;
+    return sum;
+  }
+
+  // Mean squared distance from _p to the planes
+  double error(const glm::vec3 &_p) const
+  {
+    if (weight <= 0.0)
+      return 0.0;
+    const double x = _p.x;
+    const double y = _p.y;
+    const double z = _p.z;
+    const double sum = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x +
+                       b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y +
+                       c2 * z * z + 2.0 * cd * z + d2;
+    return std::max(sum, 0.0) / weight;
+  }
+};
+
+// Exact positions, so vertices split for their UVs or normals are found again
+struct PositionHash
+{
+  size_t operator()(const glm::vec3 &_p) const
+  {
+    GLuint bits[3];
+    std::memcpy(bits, &_p.x, sizeof(bits));
+    return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+  }
+};
+
+inline unsigned long long edgeKey(const GLuint _from, const GLuint _to)
+{
+  return (static_cast<unsigned long long>(_from) << 32) | _to;
+}
+
+// A vertex merged into a neighbour, the cost is the error at the neighbour's position
+struct Collapse
+{
+  GLuint from;
+  GLuint to;
+  double cost;
+};
+
+// Triangles using each vertex, the ones of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1]]
+void buildAdjacency(const std::vector<GLuint> &_indices, const size_t _vertexCount, std::vector<GLuint> &o_offsets, std::vector<GLuint> &o_triangles)
+{
+  o_offsets.assign(_vertexCount + 1, 0);
+  for (const GLuint index : _indices)
+    ++o_offsets[index + 1];
+  std::partial_sum(o_offsets.begin(), o_offsets.end(), o_offsets.begin());
+  std::vector<GLuint> fill(o_offsets.begin(), o_offsets.end() - 1);
+  o_triangles.resize(_indices.size());
+  for (size_t i = 0; i < _indices.size(); ++i)
+    o_triangles[fill[_indices[i]]++] = static_cast<GLuint>(i / 3);
+}
+}
+
+std::vector<GLuint> MeshSimplifier::simplify(const GLuint* _indices, const size_t _count, const std::vector<glm::vec3> &_positions,
+                                             const size_t _targetCount, const float _maxError, float &o_error)
+{
+  o_error = 0.0f;
+  // Renumbered from 0 within the list, so the work follows the list size rather than the mesh
+  const GLuint unused = ~0u;
+  std::vector<GLuint> local(_positions.size(), unused);
+  std::vector<GLuint> global;
+  std::vector<GLuint> indices(_indices, _indices + _count);
+  for (GLuint& index : indices)
+  {
+    if (local[index] == unused)
+    {
+      local[index] = static_cast<GLuint>(global.size());
+      global.push_back(index);
+    }
+    index = local[index];
+  }
+  const size_t vertexCount = global.size();
+  std::vector<glm::vec3> positions(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v)
+    positions[v] = _positions[global[v]];
+
+  // Vertices sharing a position with another are on a seam, positions with an edge that has no twin
+  // running the other way are on a border, both stay where they are
+  std::unordered_map<glm::vec3, GLuint, PositionHash> firstCopy;
+  std::vector<GLuint> wedge(vertexCount);
+  std::vector<GLuint> copies(vertexCount, 0);
+  for (size_t v = 0; v < vertexCount; ++v)
+  {
+    wedge[v] = firstCopy.emplace(positions[v], static_cast<GLuint>(v)).first->second;
+    ++copies[wedge[v]];
+  }
+  std::unordered_map<unsigned long long, GLuint> edges;
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    const size_t next = i % 3 == 2 ? i - 2 : i + 1;
+    ++edges[edgeKey(wedge[indices[i]], wedge[indices[next]])];
+  }
+  std::vector<bool> border(vertexCount, false);
+  for (const auto& edge : edges)
+  {
+    const GLuint from = static_cast<GLuint>(edge.first >> 32);
+    const GLuint to = static_cast<GLuint>(edge.first & 0xFFFFFFFFu);
+    const auto twin = edges.find(edgeKey(to, from));
+    if (edge.second != 1 || twin == edges.end() || twin->second != 1)
+      border[from] = border[to] = true;
+  }
+  std::vector<bool> locked(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v)
+    locked[v] = copies[wedge[v]] > 1 || border[wedge[v]];
+
+  std::vector<Quadric> quadrics(vertexCount);
+  for (size_t t = 0; t < indices.size(); t += 3)
+  {
+    const glm::vec3& a = positions[indices[t]];
+    const glm::vec3 normal = glm::cross(positions[indices[t + 1]] - a, positions[indices[t + 2]] - a);
+    const float doubleArea = glm::length(normal);
+    if (doubleArea <= 0.0f)
+      continue;
+    const glm::vec3 unit = normal / doubleArea;
+    for (size_t corner = t; corner < t + 3; ++corner)
+      quadrics[indices[corner]].addPlane(unit, -glm::dot(unit, a), doubleArea * 0.5f);
+  }
+
+  // Each pass collapses the cheapest edges whose neighbourhoods don't overlap, then rebuilds the list
+  const double maxCost = static_cast<double>(_maxError) * static_cast<double>(_maxError);
+  std::vector<GLuint> offsets;
+  std::vector<GLuint> triangles;
+  std::vector<Collapse> collapses;
+  std::vector<GLuint> remap(vertexCount);
+  std::vector<bool> touched(vertexCount);
+  while (indices.size() > _targetCount)
+  {
+    buildAdjacency(indices, vertexCount, offsets, triangles);
+    collapses.clear();
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+      const GLuint a = indices[i];
+      const GLuint b = indices[i % 3 == 2 ? i - 2 : i + 1];
+      if (!locked[a])
+        collapses.push_back({a, b, (quadrics[a] + quadrics[b]).error(positions[b])});
+      if (!locked[b])
+        collapses.push_back({b, a, (quadrics[a] + quadrics[b]).error(positions[a])});
+    }
+    std::sort(collapses.begin(), collapses.end(), [](const Collapse &_a, const Collapse &_b){ return _a.cost < _b.cost; });
+
+    std::iota(remap.begin(), remap.end(), 0);
+    std::fill(touched.begin(), touched.end(), false);
+    const size_t goal = (indices.size() - _targetCount) / 3;
+    size_t removed = 0;
+    for (const Collapse& collapse : collapses)
+    {
+      if (collapse.cost > maxCost || removed >= goal)
+        break;
+      if (touched[collapse.from] || touched[collapse.to])
+        continue;
+      // Triangles that keep their area must not turn over
+      bool flips = false;
+      size_t collapsing = 0;
+      for (GLuint i = offsets[collapse.from]; i < offsets[collapse.from + 1] && !flips; ++i)
+      {
+        const GLuint* triangle = &indices[triangles[i] * 3];
+        if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+        {
+          ++collapsing;
+          continue;
+        }
+        glm::vec3 corners[3];
+        for (int c = 0; c < 3; ++c)
+          corners[c] = positions[triangle[c]];
+        const glm::vec3 before = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+        for (int c = 0; c < 3; ++c)
+          corners[c] = triangle[c] == collapse.from ? positions[collapse.to] : corners[c];
+        const glm::vec3 after = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+        flips = glm::dot(before, after) <= 0.0f;
+      }
+      if (flips)
+        continue;
+      remap[collapse.from] = collapse.to;
+      quadrics[collapse.to] = quadrics[collapse.to] + quadrics[collapse.from];
+      // The whole neighbourhood waits for the next pass, so the flip test above stays valid
+      for (GLuint i = offsets[collapse.from]; i < offsets[collapse.from + 1]; ++i)
+      {
+        for (size_t corner = triangles[i] * 3; corner < triangles[i] * 3 + 3; ++corner)
+          touched[indices[corner]] = true;
+      }
+      removed += collapsing;
+      o_error = std::max(o_error, static_cast<float>(std::sqrt(collapse.cost)));
+    }
+    if (removed == 0)
+      break;
+    size_t written = 0;
+    for (size_t t = 0; t < indices.size(); t += 3)
+    {
+      const GLuint a = remap[indices[t]];
+      const GLuint b = remap[indices[t + 1]];
+      const GLuint c = remap[indices[t + 2]];
+      if (a == b || b == c || a == c)
+        continue;
+      indices[written++] = a;
+      indices[written++] = b;
+      indices[written++] = c;
+    }
+    indices.resize(written);
+  }
+
+  for (GLuint& index : indices)
+    index = global[index];
+  return indices;
+}
+
+void MeshSimplifier::buildLods(MeshStorage &io_data)
+{
+  if (io_data.lods.size() != 1)
+    return;
+  std::vector<GLuint> indices = io_data.indices32.empty() ? std::vector<GLuint>(io_data.indices.begin(), io_data.indices.end()) : io_data.indices32;
+  const float maxError = glm::length(io_data.max - io_data.min) * 0.5f * s_maxError;
+  for (size_t level = 1; level <= s_maxLevels; ++level)
+  {
+    const MeshLod previous = io_data.lods.back();
+    MeshLod lod;
+    lod.firstSubMesh = static_cast<GLuint>(io_data.subMeshes.size());
+    lod.subMeshCount = previous.subMeshCount;
+    const size_t levelStart = indices.size();
+    size_t before = 0;
+    float error = 0.0f;
+    std::vector<SubMesh> parts;
+    for (GLuint p = previous.firstSubMesh; p < previous.firstSubMesh + previous.subMeshCount; ++p)
+    {
+      SubMesh part = io_data.subMeshes[p];
+      before += part.indexCount;
+      float partError = 0.0f;
+      const std::vector<GLuint> simplified = simplify(indices.data() + part.firstIndex, part.indexCount, io_data.vertices,
+                                                      part.indexCount / 6 * 3, maxError, partError);
+      // The bounds of the full part still hold, the level only uses some of its vertices
+      part.firstIndex = static_cast<GLuint>(indices.size());
+      part.indexCount = static_cast<GLuint>(simplified.size());
+      indices.insert(indices.end(), simplified.begin(), simplified.end());
+      parts.push_back(part);
+      error = std::max(error, partError);
+    }
+    // Levels that barely shrink cost memory and gain nothing
+    if ((indices.size() - levelStart) * 4 > before * 3)
+    {
+      indices.resize(levelStart);
+      break;
+    }
+    // Errors of successive levels add up in the worst case
+    lod.error = previous.error + error;
+    io_data.subMeshes.insert(io_data.subMeshes.end(), parts.begin(), parts.end());
+    io_data.lods.push_back(lod);
+  }
+  io_data.setIndices(std::move(indices));
+}
@@ -11,7 +11,7 @@ void MeshVBO::init()
   m_ebo.bind();
 }
 //-----------------------------------------------------------------------------------------------------
-void MeshVBO::reset(const unsigned char _indicesSize, const int _nIndices, const unsigned char _dataSize, const int _nVert, const int _nUV, const int _nNorm)
+void MeshVBO::reset(const GLenum _indexType, const int _nIndices, const unsigned char _dataSize, const int _nVert, const int _nUV, const int _nNorm, const int _nTangent, const MeshAttributes::Layout _layout)
 {
   {
     using namespace MeshAttributes;
@@ -19,17 +19,22 @@ void MeshVBO::reset(const unsigned char _indicesSize, const int _nIndices, const
     m_amountOfData[VERTEX] = _nVert;
     m_amountOfData[UV]     = _nUV;
     m_amountOfData[NORMAL] = _nNorm;
+    m_amountOfData[TANGENT] = _nTangent;
   }
-  m_totalAmountOfData = _nVert + _nNorm + _nUV;
+  m_totalAmountOfData = _nVert + _nNorm + _nUV + _nTangent;
+  m_layout = _layout;
   // Track the size of our stored data
   m_dataSize = _dataSize;
   // For all the buffers, we bind them then clear the data pointer
   m_vbo.bind();
   m_vbo.setUsagePattern(QOpenGLBuffer::StaticDraw);
-  m_vbo.allocate(m_dataSize * m_totalAmountOfData);
+  // Quantized vertices are a fixed size whatever the source data type
+  m_vboSize = m_layout == MeshAttributes::QUANTIZED ? _nVert / 3 * stride() : m_dataSize * m_totalAmountOfData;
+  m_vbo.allocate(m_vboSize);
 
   m_numIndices = _nIndices;
-  m_indicesSize = _indicesSize;
+  m_indexType = _indexType;
+  m_indicesSize = _indexType == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort);
   m_ebo.bind();
   m_ebo.setUsagePattern(QOpenGLBuffer::StaticDraw);
   m_ebo.allocate(_nIndices * m_indicesSize);
@@ -42,12 +47,45 @@ void MeshVBO::write(const void *_address, const MeshAttributes::Attribute _secti
   m_vbo.write(offset(_section), _address, m_amountOfData[_section] * m_dataSize);
 }
 //-----------------------------------------------------------------------------------------------------
+void MeshVBO::write(const void *_address)
+{
+  m_vbo.bind();
+  m_vbo.write(0, _address, m_vboSize);
+}
+//-----------------------------------------------------------------------------------------------------
+void MeshVBO::write(const void *_address, const int _first, const int _count)
+{
+  m_vbo.bind();
+  m_vbo.write(_first * stride(), _address, _count * stride());
+}
+//-----------------------------------------------------------------------------------------------------
 void MeshVBO::setIndices(const void* _indices)
 {
   m_ebo.bind();
   m_ebo.write(0, _indices, m_numIndices * m_indicesSize);
 }
 //-----------------------------------------------------------------------------------------------------
+void MeshVBO::setIndices(const void *_indices, const int _first, const int _count)
+{
+  m_ebo.bind();
+  m_ebo.write(_first * m_indicesSize, _indices, _count * m_indicesSize);
+}
+//-----------------------------------------------------------------------------------------------------
+GLenum MeshVBO::indexType() const noexcept
+{
+  return m_indexType;
+}
+//-----------------------------------------------------------------------------------------------------
+int MeshVBO::indexAmount() const noexcept
+{
+  return m_numIndices;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t MeshVBO::byteSize() const noexcept
+{
+  return static_cast<size_t>(m_vboSize) + static_cast<size_t>(m_numIndices) * m_indicesSize;
+}
+//-----------------------------------------------------------------------------------------------------
 unsigned char MeshVBO::dataSize() const noexcept
 {
   // Returns the size the stored of data elements
@@ -68,12 +106,71 @@ int MeshVBO::dataAmount(const MeshAttributes::Attribute _section) const noexcept
 //-----------------------------------------------------------------------------------------------------
 int MeshVBO::offset(const MeshAttributes::Attribute _section) const noexcept
 {
+  using namespace MeshAttributes;
+  // Position, normal, UV, then tangent, each starting on a 4 byte boundary
+  if (m_layout == QUANTIZED)
+  {
+    switch (_section)
+    {
+      case VERTEX:  return 0;
+      case NORMAL:  return 8;
+      case UV:      return 12;
+      default:      return m_amountOfData[UV] != 0 ? 16 : 12;
+    }
+  }
   int offset = 0;
   for (size_t i = 0; i < _section; ++i)
-    offset += m_amountOfData[i];
+  {
+    // Interleaved offsets are within one vertex, attributes the mesh doesn't have take no space
+    if (m_layout == INTERLEAVED)
+      offset += m_amountOfData[i] != 0 ? tupleSize[i] : 0;
+    else
+      offset += m_amountOfData[i];
+  }
   return offset * m_dataSize;
 }
 //-----------------------------------------------------------------------------------------------------
+int MeshVBO::stride() const noexcept
+{
+  using namespace MeshAttributes;
+  if (m_layout == PLANAR)
+    return 0;
+  if (m_layout == QUANTIZED)
+    return 12 + (m_amountOfData[UV] != 0 ? 4 : 0) + (m_amountOfData[TANGENT] != 0 ? 4 : 0);
+  int stride = 0;
+  for (const auto section : {VERTEX, UV, NORMAL, TANGENT})
+    stride += m_amountOfData[section] != 0 ? tupleSize[section] : 0;
+  return stride * m_dataSize;
+}
+//-----------------------------------------------------------------------------------------------------
+GLenum MeshVBO::type(const MeshAttributes::Attribute _section) const noexcept
+{
+  using namespace MeshAttributes;
+  if (m_layout != QUANTIZED)
+    return GL_FLOAT;
+  switch (_section)
+  {
+    case VERTEX:  return GL_UNSIGNED_SHORT;
+    case NORMAL:
+    case TANGENT: return GL_INT_2_10_10_10_REV;
+    default:      return GL_HALF_FLOAT;
+  }
+}
+//-----------------------------------------------------------------------------------------------------
+int MeshVBO::components(const MeshAttributes::Attribute _section) const noexcept
+{
+  using namespace MeshAttributes;
+  // Packed 10-10-10-2 always has four components, the shaders only read the first three
+  if (m_layout == QUANTIZED && _section == NORMAL)
+    return 4;
+  return tupleSize[_section];
+}
+//-----------------------------------------------------------------------------------------------------
+MeshAttributes::Layout MeshVBO::layout() const noexcept
+{
+  return m_layout;
+}
+//-----------------------------------------------------------------------------------------------------
 void MeshVBO::use()
 {
   m_vbo.bind();
@@ -0,0 +1,336 @@
+#include "Meshlets.h"
+#include "Mesh.h"
+#include <glm.hpp>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <unordered_map>
+#include <cstring>
+#include <cmath>
+
+namespace
+{
+// Normals this close to the cone's edge leave too little to cull, such meshlets skip the test
+constexpr float s_minConeCos = 0.1f;
+// How much growing a meshlet weighs spreading out and bending away against each new vertex, turning
+// is the most costly since it widens the normal cone
+constexpr float s_distanceWeight = 0.5f;
+constexpr float s_normalWeight = 8.0f;
+
+// Exact positions, so vertices split for their UVs or normals are found again
+struct PositionHash
+{
+  size_t operator()(const glm::vec3 &_p) const
+  {
+    GLuint bits[3];
+    std::memcpy(bits, &_p.x, sizeof(bits));
+    return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+  }
+};
+
+// Triangles using each vertex, the ones of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1]]
+void buildAdjacency(const std::vector<GLuint> &_indices, const size_t _vertexCount, std::vector<GLuint> &o_offsets, std::vector<GLuint> &o_triangles)
+{
+  o_offsets.assign(_vertexCount + 1, 0);
+  for (const GLuint index : _indices)
+    ++o_offsets[index + 1];
+  std::partial_sum(o_offsets.begin(), o_offsets.end(), o_offsets.begin());
+  std::vector<GLuint> fill(o_offsets.begin(), o_offsets.end() - 1);
+  o_triangles.resize(_indices.size());
+  for (size_t i = 0; i < _indices.size(); ++i)
+    o_triangles[fill[_indices[i]]++] = static_cast<GLuint>(i / 3);
+}
+
+// Sphere and normal cone of the triangles of one meshlet, _indices are its own
+Meshlet bound(const GLuint* _indices, const size_t _count, const std::vector<glm::vec3> &_positions)
+{
+  Meshlet meshlet;
+  glm::vec3 min = _positions[_indices[0]];
+  glm::vec3 max = min;
+  for (size_t i = 1; i < _count; ++i)
+  {
+    min = glm::min(min, _positions[_indices[i]]);
+    max = glm::max(max, _positions[_indices[i]]);
+  }
+  meshlet.centre = (min + max) * 0.5f;
+  for (size_t i = 0; i < _count; ++i)
+    meshlet.radius = std::max(meshlet.radius, glm::length(_positions[_indices[i]] - meshlet.centre));
+
+  std::vector<glm::vec3> normals;
+  std::vector<GLuint> corners;
+  normals.reserve(_count / 3);
+  corners.reserve(_count / 3);
+  glm::vec3 sum(0.0f);
+  for (size_t t = 0; t < _count; t += 3)
+  {
+    const glm::vec3& a = _positions[_indices[t]];
+    const glm::vec3 normal = glm::cross(_positions[_indices[t + 1]] - a, _positions[_indices[t + 2]] - a);
+    const float length = glm::length(normal);
+    // Degenerate triangles are never drawn, so they don't widen the cone
+    if (length <= 0.0f)
+      continue;
+    normals.push_back(normal / length);
+    corners.push_back(_indices[t]);
+    sum += normals.back();
+  }
+  const float sumLength = glm::length(sum);
+  if (normals.empty() || sumLength <= 0.0f)
+    return meshlet;
+  meshlet.coneAxis = sum / sumLength;
+  float coneCos = 1.0f;
+  for (const glm::vec3& normal : normals)
+    coneCos = std::min(coneCos, glm::dot(normal, meshlet.coneAxis));
+  if (coneCos < s_minConeCos)
+    return meshlet;
+  // Far enough back along the axis to be behind the plane of every triangle
+  float back = 0.0f;
+  for (size_t t = 0; t < normals.size(); ++t)
+    back = std::max(back, glm::dot(meshlet.centre - _positions[corners[t]], normals[t]) / glm::dot(meshlet.coneAxis, normals[t]));
+  meshlet.coneApex = meshlet.centre - meshlet.coneAxis * back;
+  // Eyes have to be more than 90 degrees from every normal, the cone's half angle off the reversed axis
+  meshlet.coneCutoff = std::sqrt(std::max(1.0f - coneCos * coneCos, 0.0f));
+  return meshlet;
+}
+
+// Grows meshlets over shared positions, adding the neighbouring triangle that brings the fewest new
+// vertices, stays closest to the meshlet and best faces the same way, so meshlets are compact with
+// narrow cones. _indices are renumbered from 0 and are reordered into meshlet order.
+void partition(std::vector<GLuint> &io_indices, const std::vector<glm::vec3> &_positions, std::vector<size_t> &o_starts)
+{
+  const size_t triangleCount = io_indices.size() / 3;
+  const size_t vertexCount = _positions.size();
+  // Neighbours are found through positions, so seams between UV islands or hard edges don't stop growth
+  std::unordered_map<glm::vec3, GLuint, PositionHash> firstCopy;
+  std::vector<GLuint> weld(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v)
+    weld[v] = firstCopy.emplace(_positions[v], static_cast<GLuint>(v)).first->second;
+  std::vector<GLuint> welded(io_indices.size());
+  for (size_t i = 0; i < io_indices.size(); ++i)
+    welded[i] = weld[io_indices[i]];
+  std::vector<GLuint> offsets;
+  std::vector<GLuint> triangles;
+  buildAdjacency(welded, vertexCount, offsets, triangles);
+  std::vector<glm::vec3> centroids(triangleCount);
+  std::vector<glm::vec3> normals(triangleCount);
+  glm::vec3 min = _positions[0];
+  glm::vec3 max = min;
+  for (const glm::vec3& position : _positions)
+  {
+    min = glm::min(min, position);
+    max = glm::max(max, position);
+  }
+  for (size_t t = 0; t < triangleCount; ++t)
+  {
+    const glm::vec3& a = _positions[io_indices[t * 3]];
+    const glm::vec3& b = _positions[io_indices[t * 3 + 1]];
+    const glm::vec3& c = _positions[io_indices[t * 3 + 2]];
+    centroids[t] = (a + b + c) / 3.0f;
+    const glm::vec3 normal = glm::cross(b - a, c - a);
+    const float length = glm::length(normal);
+    normals[t] = length > 0.0f ? normal / length : normal;
+  }
+  // Distances are measured against the size a meshlet of the part would have if it were a flat square
+  const float extent = glm::length(max - min);
+  const float meshletSize = std::max(extent * std::sqrt(static_cast<float>(Meshlets::s_maxTriangles) / static_cast<float>(triangleCount)),
+                                     std::numeric_limits<float>::min());
+
+  const GLuint none = ~0u;
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<GLuint> owner(vertexCount, none);
+  std::vector<GLuint> vertices;
+  std::vector<GLuint> ordered;
+  ordered.reserve(io_indices.size());
+  size_t scan = 0;
+  GLuint meshlet = 0;
+  glm::vec3 centre(0.0f);
+  glm::vec3 normal(0.0f);
+  while (ordered.size() < io_indices.size())
+  {
+    // Continues next to the last meshlet where possible, so leftovers don't end up as scattered slivers
+    GLuint seed = none;
+    float bestScore = std::numeric_limits<float>::max();
+    for (const GLuint v : vertices)
+    {
+      for (GLuint i = offsets[weld[v]]; i < offsets[weld[v] + 1]; ++i)
+      {
+        const GLuint t = triangles[i];
+        const float score = glm::length(centroids[t] - centre);
+        if (!emitted[t] && score < bestScore)
+        {
+          seed = t;
+          bestScore = score;
+        }
+      }
+    }
+    while (seed == none)
+    {
+      if (!emitted[scan])
+        seed = static_cast<GLuint>(scan);
+      ++scan;
+    }
+
+    o_starts.push_back(ordered.size() / 3);
+    ++meshlet;
+    vertices.clear();
+    centre = glm::vec3(0.0f);
+    normal = glm::vec3(0.0f);
+    size_t meshletTriangles = 0;
+    GLuint next = seed;
+    while (next != none)
+    {
+      emitted[next] = true;
+      for (size_t corner = next * 3; corner < next * 3 + 3; ++corner)
+      {
+        const GLuint v = io_indices[corner];
+        ordered.push_back(v);
+        if (owner[v] != meshlet)
+        {
+          owner[v] = meshlet;
+          vertices.push_back(v);
+        }
+      }
+      ++meshletTriangles;
+      centre += (centroids[next] - centre) / static_cast<float>(meshletTriangles);
+      normal += normals[next];
+      if (meshletTriangles == Meshlets::s_maxTriangles)
+        break;
+
+      const glm::vec3 axis = glm::length(normal) > 0.0f ? glm::normalize(normal) : normal;
+      next = none;
+      bestScore = std::numeric_limits<float>::max();
+      for (const GLuint v : vertices)
+      {
+        for (GLuint i = offsets[weld[v]]; i < offsets[weld[v] + 1]; ++i)
+        {
+          const GLuint t = triangles[i];
+          if (emitted[t])
+            continue;
+          size_t added = 0;
+          for (size_t corner = t * 3; corner < t * 3 + 3; ++corner)
+            added += owner[io_indices[corner]] != meshlet;
+          if (vertices.size() + added > Meshlets::s_maxVertices)
+            continue;
+          const float score = static_cast<float>(added) + s_distanceWeight * glm::length(centroids[t] - centre) / meshletSize +
+                              s_normalWeight * (1.0f - glm::dot(normals[t], axis));
+          if (score < bestScore)
+          {
+            next = t;
+            bestScore = score;
+          }
+        }
+      }
+    }
+  }
+  io_indices.swap(ordered);
+}
+}
+
+void Meshlets::build(MeshStorage &io_data)
+{
+  std::vector<GLuint> indices = io_data.indices32.empty() ? std::vector<GLuint>(io_data.indices.begin(), io_data.indices.end()) : io_data.indices32;
+  io_data.meshlets.clear();
+  const GLuint unused = ~0u;
+  std::vector<GLuint> local(io_data.vertices.size(), unused);
+  std::vector<GLuint> global;
+  std::vector<GLuint> partIndices;
+  std::vector<glm::vec3> positions;
+  std::vector<size_t> starts;
+  for (SubMesh& part : io_data.subMeshes)
+  {
+    part.firstMeshlet = static_cast<GLuint>(io_data.meshlets.size());
+    part.meshletCount = 0;
+    if (part.indexCount == 0)
+      continue;
+    // Renumbered from 0 within the part, so the work is proportional to the part rather than the mesh
+    GLuint* range = indices.data() + part.firstIndex;
+    global.clear();
+    partIndices.resize(part.indexCount);
+    for (size_t i = 0; i < part.indexCount; ++i)
+    {
+      if (local[range[i]] == unused)
+      {
+        local[range[i]] = static_cast<GLuint>(global.size());
+        global.push_back(range[i]);
+      }
+      partIndices[i] = local[range[i]];
+    }
+    positions.resize(global.size());
+    for (size_t v = 0; v < global.size(); ++v)
+    {
+      positions[v] = io_data.vertices[global[v]];
+      local[global[v]] = unused;
+    }
+
+    starts.clear();
+    partition(partIndices, positions, starts);
+    const size_t triangleCount = partIndices.size() / 3;
+    for (size_t m = 0; m < starts.size(); ++m)
+    {
+      const size_t end = m + 1 < starts.size() ? starts[m + 1] : triangleCount;
+      Meshlet meshlet = bound(partIndices.data() + starts[m] * 3, (end - starts[m]) * 3, positions);
+      meshlet.firstIndex = part.firstIndex + static_cast<GLuint>(starts[m] * 3);
+      meshlet.indexCount = static_cast<GLuint>((end - starts[m]) * 3);
+      io_data.meshlets.push_back(meshlet);
+    }
+    part.meshletCount = static_cast<GLuint>(starts.size());
+    for (size_t i = 0; i < part.indexCount; ++i)
+      range[i] = global[partIndices[i]];
+  }
+  io_data.setIndices(std::move(indices));
+}
+
+size_t Meshlets::cull(const Mesh &_mesh, const MeshLod &_lod, const glm::mat4 &_clip, const glm::vec3 &_eye, const bool _backFaces,
+                      std::vector<DrawRange> &o_ranges)
+{
+  // Frustum planes in model space (Gribb and Hartmann), scaled to give distances in model units
+  glm::vec4 planes[6];
+  const glm::vec4 row0(_clip[0][0], _clip[1][0], _clip[2][0], _clip[3][0]);
+  const glm::vec4 row1(_clip[0][1], _clip[1][1], _clip[2][1], _clip[3][1]);
+  const glm::vec4 row2(_clip[0][2], _clip[1][2], _clip[2][2], _clip[3][2]);
+  const glm::vec4 row3(_clip[0][3], _clip[1][3], _clip[2][3], _clip[3][3]);
+  planes[0] = row3 + row0;
+  planes[1] = row3 - row0;
+  planes[2] = row3 + row1;
+  planes[3] = row3 - row1;
+  planes[4] = row3 + row2;
+  planes[5] = row3 - row2;
+  for (glm::vec4& plane : planes)
+    plane /= glm::length(glm::vec3(plane));
+
+  o_ranges.clear();
+  size_t indexCount = 0;
+  const auto append = [&o_ranges, &indexCount](const GLuint _first, const GLuint _count)
+  {
+    if (!o_ranges.empty() && o_ranges.back().firstIndex + o_ranges.back().indexCount == _first)
+      o_ranges.back().indexCount += _count;
+    else
+      o_ranges.push_back({_first, _count});
+    indexCount += _count;
+  };
+  for (GLuint s = _lod.firstSubMesh; s < _lod.firstSubMesh + _lod.subMeshCount; ++s)
+  {
+    const SubMesh& part = _mesh.getSubMesh(s);
+    if (part.meshletCount == 0)
+    {
+      if (part.indexCount != 0)
+        append(part.firstIndex, part.indexCount);
+      continue;
+    }
+    for (GLuint m = part.firstMeshlet; m < part.firstMeshlet + part.meshletCount; ++m)
+    {
+      const Meshlet& meshlet = _mesh.getMeshlet(m);
+      bool visible = true;
+      for (int p = 0; p < 6 && visible; ++p)
+        visible = glm::dot(glm::vec3(planes[p]), meshlet.centre) + planes[p].w >= -meshlet.radius;
+      // The eye is behind the apex and inside the reversed cone, so behind every triangle
+      if (visible && _backFaces && meshlet.coneCutoff < 1.0f)
+      {
+        const glm::vec3 view = meshlet.coneApex - _eye;
+        visible = glm::dot(view, meshlet.coneAxis) < meshlet.coneCutoff * glm::length(view);
+      }
+      if (visible)
+        append(meshlet.firstIndex, meshlet.indexCount);
+    }
+  }
+  return indexCount;
+}
@@ -0,0 +1,435 @@
+#include "ObjLoader.h"
+#include "ThreadPool.h"
+#include "FloatConversion.h"
+#include <QFile>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+// Blocks smaller than this are not worth a thread of their own
+constexpr size_t s_minBlockSize = 64 * 1024;
+
+// One face corner, indices are 0 based and -1 when missing
+struct Corner
+{
+  long v;
+  long t;
+  long n;
+};
+
+// A run of whole lines, parsed by one thread
+struct Block
+{
+  const char* begin;
+  const char* end;
+  // Element counts from the first pass, and where the block's elements start in the whole file
+  size_t positions = 0;
+  size_t uvs = 0;
+  size_t normals = 0;
+  size_t positionBase = 0;
+  size_t uvBase = 0;
+  size_t normalBase = 0;
+  // Three corners per triangle
+  std::vector<Corner> corners;
+  // Corner counts at which an object, group or material line starts a new part
+  std::vector<size_t> splits;
+  bool ok = true;
+};
+
+enum LineKind { POSITION, UV, NORMAL, FACE, PART, OTHER };
+
+inline bool isSpace(const char _c)
+{
+  return _c == ' ' || _c == '\t' || _c == '\r';
+}
+
+inline const char* skipSpace(const char* _it, const char* _end)
+{
+  while (_it < _end && isSpace(*_it))
+    ++_it;
+  return _it;
+}
+
+// Reads the keyword of a line and moves _it past it
+LineKind lineKind(const char* &io_it, const char* _end)
+{
+  const char* it = skipSpace(io_it, _end);
+  LineKind kind = OTHER;
+  size_t length = 0;
+  if (_end - it >= 2 && it[0] == 'v' && isSpace(it[1]))
+  {
+    kind = POSITION;
+    length = 1;
+  }
+  else if (_end - it >= 3 && it[0] == 'v' && it[1] == 't' && isSpace(it[2]))
+  {
+    kind = UV;
+    length = 2;
+  }
+  else if (_end - it >= 3 && it[0] == 'v' && it[1] == 'n' && isSpace(it[2]))
+  {
+    kind = NORMAL;
+    length = 2;
+  }
+  else if (_end - it >= 2 && it[0] == 'f' && isSpace(it[1]))
+  {
+    kind = FACE;
+    length = 1;
+  }
+  else if ((_end - it >= 2 && (it[0] == 'o' || it[0] == 'g') && isSpace(it[1])) ||
+           (_end - it >= 7 && std::memcmp(it, "usemtl", 6) == 0 && isSpace(it[6])))
+  {
+    kind = PART;
+  }
+  io_it = it + length;
+  return kind;
+}
+
+// Calls _line with the begin and end of every line in the block, stops when it returns false
+template<typename F>
+bool forEachLine(const Block &_block, F _line)
+{
+  for (const char* line = _block.begin; line < _block.end;)
+  {
+    const char* eol = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(_block.end - line)));
+    if (eol == nullptr)
+      eol = _block.end;
+    if (!_line(line, eol))
+      return false;
+    line = eol + 1;
+  }
+  return true;
+}
+
+// Parses _count floats separated by spaces, each must end at a space or the end of the line
+bool readFloats(const char* &io_it, const char* _eol, float* o_vals, const size_t _count)
+{
+  for (size_t i = 0; i < _count; ++i)
+  {
+    const char* it = skipSpace(io_it, _eol);
+    if (it < _eol && *it == '+')
+      ++it;
+    const char* next = FloatConversion::parseFloat(it, _eol, o_vals[i]);
+    if (next == it || (next < _eol && !isSpace(*next)))
+      return false;
+    io_it = next;
+  }
+  return true;
+}
+
+// Parses a signed face index, 0 if there is none
+long readIndex(const char* &io_it, const char* _eol)
+{
+  const char* it = io_it;
+  const bool negative = it < _eol && *it == '-';
+  if (negative)
+    ++it;
+  long value = 0;
+  const char* digits = it;
+  while (it < _eol && *it >= '0' && *it <= '9' && it - digits < 10)
+    value = value * 10 + (*it++ - '0');
+  if (it == digits)
+    return 0;
+  io_it = it;
+  return negative ? -value : value;
+}
+
+// Turns a 1 based or negative (relative) OBJ index into a 0 based one, -1 if it is invalid
+inline long resolve(const long _index, const size_t _seen)
+{
+  if (_index > 0)
+    return _index - 1;
+  if (_index < 0 && static_cast<size_t>(-_index) <= _seen)
+    return static_cast<long>(_seen) + _index;
+  return -1;
+}
+
+// First pass, counts the elements of each kind so every block knows where its elements go
+void countBlock(Block &io_block)
+{
+  forEachLine(io_block, [&io_block](const char* _line, const char* _eol)
+  {
+    switch (lineKind(_line, _eol))
+    {
+      case POSITION: ++io_block.positions; break;
+      case UV: ++io_block.uvs; break;
+      case NORMAL: ++io_block.normals; break;
+      default: break;
+    }
+    return true;
+  });
+}
+
+// Second pass, parses elements straight into the shared arrays and collects triangles
+void parseBlock(Block &io_block, float* o_positions, float* o_uvs, float* o_normals)
+{
+  size_t positions = io_block.positionBase;
+  size_t uvs = io_block.uvBase;
+  size_t normals = io_block.normalBase;
+  std::vector<Corner> polygon;
+  io_block.ok = forEachLine(io_block, [&](const char* _line, const char* _eol)
+  {
+    const char* it = _line;
+    switch (lineKind(it, _eol))
+    {
+      case POSITION:
+        return readFloats(it, _eol, o_positions + 3 * positions++, 3);
+      case UV:
+      {
+        // v is optional
+        float* uv = o_uvs + 2 * uvs++;
+        uv[1] = 0.0f;
+        if (!readFloats(it, _eol, uv, 1))
+          return false;
+        const char* rest = skipSpace(it, _eol);
+        return rest == _eol || readFloats(it, _eol, uv + 1, 1);
+      }
+      case NORMAL:
+        return readFloats(it, _eol, o_normals + 3 * normals++, 3);
+      case FACE:
+      {
+        polygon.clear();
+        for (it = skipSpace(it, _eol); it < _eol; it = skipSpace(it, _eol))
+        {
+          Corner corner{-1, -1, -1};
+          corner.v = resolve(readIndex(it, _eol), positions);
+          if (corner.v < 0)
+            return false;
+          if (it < _eol && *it == '/')
+          {
+            ++it;
+            if (it < _eol && *it != '/')
+            {
+              corner.t = resolve(readIndex(it, _eol), uvs);
+              if (corner.t < 0)
+                return false;
+            }
+            if (it < _eol && *it == '/')
+            {
+              ++it;
+              corner.n = resolve(readIndex(it, _eol), normals);
+              if (corner.n < 0)
+                return false;
+            }
+          }
+          if (it < _eol && !isSpace(*it))
+            return false;
+          polygon.push_back(corner);
+        }
+        // Fan triangulation, points and lines are dropped
+        for (size_t i = 2; i < polygon.size(); ++i)
+          io_block.corners.insert(io_block.corners.end(), {polygon[0], polygon[i - 1], polygon[i]});
+        return true;
+      }
+      case PART:
+        io_block.splits.push_back(io_block.corners.size());
+        return true;
+      default:
+        return true;
+    }
+  });
+}
+
+inline size_t hashCorner(const Corner &_corner)
+{
+  size_t hash = static_cast<size_t>(_corner.v) * 0x9E3779B97F4A7C15ull;
+  hash ^= static_cast<size_t>(_corner.t + 1) * 0xC2B2AE3D27D4EB4Full + (hash >> 29);
+  hash ^= static_cast<size_t>(_corner.n + 1) * 0x165667B19E3779F9ull + (hash >> 32);
+  return hash ^ (hash >> 31);
+}
+}
+
+bool ObjLoader::handles(const std::string &_fname)
+{
+  if (_fname.size() < 4)
+    return false;
+  std::string extension = _fname.substr(_fname.size() - 4);
+  std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char _c){ return static_cast<char>(std::tolower(_c)); });
+  return extension == ".obj";
+}
+
+bool ObjLoader::load(const std::string &_fname, MeshStorage &o_data, const std::function<bool(float)> &_progress)
+{
+  QFile file(QString::fromStdString(_fname));
+  if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+    return false;
+  const size_t size = static_cast<size_t>(file.size());
+  const char* text = reinterpret_cast<const char*>(file.map(0, file.size()));
+  if (text == nullptr || !_progress(0.0f))
+    return false;
+
+  // Split into blocks of whole lines, a few more than threads so uneven blocks still balance out
+  ThreadPool& pool = ThreadPool::instance();
+  const size_t blockCount = std::max<size_t>(1, std::min(size / s_minBlockSize, (pool.threadCount() + 1) * 4));
+  std::vector<Block> blocks;
+  blocks.reserve(blockCount);
+  const char* end = text + size;
+  for (const char* begin = text; begin < end;)
+  {
+    const char* split = blocks.size() + 1 == blockCount ? end : std::min(end, begin + size / blockCount);
+    split = split == end ? end : static_cast<const char*>(std::memchr(split, '\n', static_cast<size_t>(end - split)));
+    split = split == nullptr ? end : split + (split < end ? 1 : 0);
+    blocks.emplace_back();
+    blocks.back().begin = begin;
+    blocks.back().end = split;
+    begin = split;
+  }
+
+  pool.parallelFor(blocks.size(), [&blocks](size_t _begin, size_t _end)
+  {
+    for (size_t i = _begin; i < _end; ++i)
+      countBlock(blocks[i]);
+  });
+  size_t positionCount = 0, uvCount = 0, normalCount = 0;
+  for (auto& block : blocks)
+  {
+    block.positionBase = positionCount;
+    block.uvBase = uvCount;
+    block.normalBase = normalCount;
+    positionCount += block.positions;
+    uvCount += block.uvs;
+    normalCount += block.normals;
+  }
+  if (positionCount == 0 || !_progress(0.3f))
+    return false;
+
+  std::vector<float> positions(3 * positionCount);
+  std::vector<float> uvs(2 * uvCount);
+  std::vector<float> normals(3 * normalCount);
+  pool.parallelFor(blocks.size(), [&](size_t _begin, size_t _end)
+  {
+    for (size_t i = _begin; i < _end; ++i)
+      parseBlock(blocks[i], positions.data(), uvs.data(), normals.data());
+  });
+  size_t cornerCount = 0;
+  bool smooth = false;
+  for (const auto& block : blocks)
+  {
+    if (!block.ok)
+      return false;
+    cornerCount += block.corners.size();
+    for (const auto& corner : block.corners)
+    {
+      if (corner.v >= static_cast<long>(positionCount) || corner.t >= static_cast<long>(uvCount) || corner.n >= static_cast<long>(normalCount))
+        return false;
+      smooth |= corner.n < 0;
+    }
+  }
+  if (cornerCount == 0 || !_progress(0.7f))
+    return false;
+
+  // Area weighted smooth normals per position, for corners the file gives no normal
+  std::vector<float> generated;
+  if (smooth)
+  {
+    generated.assign(3 * positionCount, 0.0f);
+    for (const auto& block : blocks)
+    {
+      for (size_t i = 0; i < block.corners.size(); i += 3)
+      {
+        const float* p0 = &positions[3 * block.corners[i].v];
+        const float* p1 = &positions[3 * block.corners[i + 1].v];
+        const float* p2 = &positions[3 * block.corners[i + 2].v];
+        const float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+        const float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        const float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+        for (size_t c = 0; c < 3; ++c)
+        {
+          float* accum = &generated[3 * block.corners[i + c].v];
+          accum[0] += n[0];
+          accum[1] += n[1];
+          accum[2] += n[2];
+        }
+      }
+    }
+    for (size_t i = 0; i < positionCount; ++i)
+    {
+      float* n = &generated[3 * i];
+      const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      if (length > 0.0f)
+      {
+        n[0] /= length;
+        n[1] /= length;
+        n[2] /= length;
+      }
+    }
+  }
+
+  // Weld identical corners into shared vertices, open addressing keeps the table in one allocation
+  size_t capacity = 16;
+  while (capacity < 2 * cornerCount)
+    capacity *= 2;
+  std::vector<long> table(capacity, -1);
+  std::vector<Corner> unique;
+  unique.reserve(std::min(cornerCount, positionCount * 2));
+  MeshStorage data;
+  std::vector<GLuint> indices;
+  indices.reserve(cornerCount);
+  // Where each part starts in the index array, the end closes the last one
+  std::vector<size_t> partStarts;
+  for (const auto& block : blocks)
+  {
+    for (const size_t split : block.splits)
+      partStarts.push_back(indices.size() + split);
+    for (const auto& corner : block.corners)
+    {
+      size_t slot = hashCorner(corner) & (capacity - 1);
+      while (table[slot] >= 0)
+      {
+        const Corner& stored = unique[static_cast<size_t>(table[slot])];
+        if (stored.v == corner.v && stored.t == corner.t && stored.n == corner.n)
+          break;
+        slot = (slot + 1) & (capacity - 1);
+      }
+      if (table[slot] < 0)
+      {
+        table[slot] = static_cast<long>(unique.size());
+        unique.push_back(corner);
+      }
+      indices.push_back(static_cast<GLuint>(table[slot]));
+    }
+  }
+  // Parts without faces are dropped, bounds are left to the caller
+  partStarts.push_back(indices.size());
+  size_t partBegin = 0;
+  for (const size_t partEnd : partStarts)
+  {
+    if (partEnd > partBegin)
+    {
+      SubMesh part;
+      part.firstIndex = static_cast<GLuint>(partBegin);
+      part.indexCount = static_cast<GLuint>(partEnd - partBegin);
+      data.subMeshes.push_back(part);
+    }
+    partBegin = partEnd;
+  }
+
+  data.vertices.reserve(unique.size());
+  data.normals.reserve(unique.size());
+  if (uvCount > 0)
+    data.uvs.reserve(unique.size());
+  for (const auto& corner : unique)
+  {
+    const float* p = &positions[3 * corner.v];
+    data.vertices.emplace_back(p[0], p[1], p[2]);
+    const float* n = corner.n >= 0 ? &normals[3 * corner.n] : &generated[3 * corner.v];
+    data.normals.emplace_back(n[0], n[1], n[2]);
+    if (uvCount > 0)
+    {
+      // Flipped like aiProcess_FlipUVs
+      const float* t = corner.t >= 0 ? &uvs[2 * corner.t] : nullptr;
+      data.uvs.emplace_back(t != nullptr ? t[0] : 0.0f, t != nullptr ? 1.0f - t[1] : 0.0f);
+    }
+  }
+  data.setIndices(std::move(indices));
+  o_data.vertices = std::move(data.vertices);
+  o_data.normals = std::move(data.normals);
+  o_data.uvs = std::move(data.uvs);
+  o_data.indices = std::move(data.indices);
+  o_data.indices32 = std::move(data.indices32);
+  o_data.subMeshes = std::move(data.subMeshes);
+  return true;
+}
@@ -0,0 +1,262 @@
+#include "Tangents.h"
+#include "Mesh.h"
+#include "ThreadPool.h"
+#include <glm.hpp>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TANGENTS_SSE
+#endif
+
+namespace
+{
+// Triangles or vertices worth handing to a worker
+constexpr size_t s_minRange = 4096;
+// Lengths and UV areas at or below this count as zero, as in MikkTSpace
+const float s_epsilon = std::numeric_limits<float>::min();
+
+// acos to within 7e-5 radians (Abramowitz and Stegun 4.4.45). The SSE path has no acos, this one uses the
+// same polynomial so triangles weigh the same whichever path they take
+float acosApprox(const float _x)
+{
+  const float x = std::abs(_x);
+  const float r = std::sqrt(1.0f - x) * (1.5707288f + x * (-0.2121144f + x * (0.0742610f - 0.0187293f * x)));
+  return _x < 0.0f ? 3.14159265f - r : r;
+}
+
+glm::vec3 normalizeSafe(const glm::vec3 &_v)
+{
+  const float length2 = glm::dot(_v, _v);
+  return length2 > s_epsilon ? _v / std::sqrt(length2) : glm::vec3(0.0f);
+}
+
+// Writes the three corners of a triangle as MikkTSpace weighs them: xyz is the triangle's tangent
+// projected into the plane of the corner's normal and scaled by the angle at the corner, w is that angle
+// signed by the UV handedness. Triangles without UV area get all zeros
+template<typename Index>
+void cornerTangents(const MeshStorage &_data, const Index* _triangle, glm::vec4* o_corners)
+{
+  const glm::vec3 p[3] = {_data.vertices[_triangle[0]], _data.vertices[_triangle[1]], _data.vertices[_triangle[2]]};
+  const glm::vec2 uv[3] = {_data.uvs[_triangle[0]], _data.uvs[_triangle[1]], _data.uvs[_triangle[2]]};
+  const glm::vec3 d1 = p[1] - p[0];
+  const glm::vec3 d2 = p[2] - p[0];
+  const glm::vec2 t21 = uv[1] - uv[0];
+  const glm::vec2 t31 = uv[2] - uv[0];
+  const float area = t21.x * t31.y - t21.y * t31.x;
+  const glm::vec3 os = t31.y * d1 - t21.y * d2;
+  const float length = glm::length(os);
+  if (!(std::abs(area) > s_epsilon) || !(length > s_epsilon))
+  {
+    std::fill(o_corners, o_corners + 3, glm::vec4(0.0f));
+    return;
+  }
+  const float sign = area > 0.0f ? 1.0f : -1.0f;
+  const glm::vec3 tangent = os * (sign / length);
+  for (int c = 0; c < 3; ++c)
+  {
+    const glm::vec3& n = _data.normals[_triangle[c]];
+    const glm::vec3 e1 = p[(c + 1) % 3] - p[c];
+    const glm::vec3 e2 = p[(c + 2) % 3] - p[c];
+    const float angle = acosApprox(glm::clamp(glm::dot(normalizeSafe(e1 - n * glm::dot(n, e1)), normalizeSafe(e2 - n * glm::dot(n, e2))),
+                                              -1.0f, 1.0f));
+    o_corners[c] = glm::vec4(normalizeSafe(tangent - n * glm::dot(n, tangent)) * angle, angle * sign);
+  }
+}
+
+#ifdef TANGENTS_SSE
+// Four vectors, one per lane
+struct Vec3x4
+{
+  __m128 x, y, z;
+};
+
+Vec3x4 sub(const Vec3x4 &_a, const Vec3x4 &_b)
+{
+  return {_mm_sub_ps(_a.x, _b.x), _mm_sub_ps(_a.y, _b.y), _mm_sub_ps(_a.z, _b.z)};
+}
+
+Vec3x4 scale(const Vec3x4 &_a, const __m128 _s)
+{
+  return {_mm_mul_ps(_a.x, _s), _mm_mul_ps(_a.y, _s), _mm_mul_ps(_a.z, _s)};
+}
+
+__m128 dot(const Vec3x4 &_a, const Vec3x4 &_b)
+{
+  return _mm_add_ps(_mm_add_ps(_mm_mul_ps(_a.x, _b.x), _mm_mul_ps(_a.y, _b.y)), _mm_mul_ps(_a.z, _b.z));
+}
+
+// Lanes of a mask pick from _a, the rest from _b
+__m128 select(const __m128 _mask, const __m128 _a, const __m128 _b)
+{
+  return _mm_or_ps(_mm_and_ps(_mask, _a), _mm_andnot_ps(_mask, _b));
+}
+
+Vec3x4 normalizeSafe(const Vec3x4 &_v)
+{
+  const __m128 length2 = dot(_v, _v);
+  const __m128 valid = _mm_cmpgt_ps(length2, _mm_set1_ps(s_epsilon));
+  return scale(_v, _mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(length2))));
+}
+
+// The polynomial of the scalar acosApprox, operation for operation
+__m128 acosApprox(const __m128 _x)
+{
+  const __m128 x = _mm_andnot_ps(_mm_set1_ps(-0.0f), _x);
+  __m128 poly = _mm_sub_ps(_mm_set1_ps(0.0742610f), _mm_mul_ps(_mm_set1_ps(0.0187293f), x));
+  poly = _mm_add_ps(_mm_set1_ps(-0.2121144f), _mm_mul_ps(x, poly));
+  poly = _mm_add_ps(_mm_set1_ps(1.5707288f), _mm_mul_ps(x, poly));
+  const __m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), x)), poly);
+  return select(_mm_cmplt_ps(_x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(3.14159265f), r), r);
+}
+
+// Gathers one corner of four triangles into the lanes
+template<typename Index>
+Vec3x4 gather(const std::vector<glm::vec3> &_array, const Index* _triangles, const int _corner)
+{
+  const glm::vec3& a = _array[_triangles[_corner]];
+  const glm::vec3& b = _array[_triangles[3 + _corner]];
+  const glm::vec3& c = _array[_triangles[6 + _corner]];
+  const glm::vec3& d = _array[_triangles[9 + _corner]];
+  return {_mm_setr_ps(a.x, b.x, c.x, d.x), _mm_setr_ps(a.y, b.y, c.y, d.y), _mm_setr_ps(a.z, b.z, c.z, d.z)};
+}
+
+// cornerTangents for four triangles at once, one per lane
+template<typename Index>
+void cornerTangents4(const MeshStorage &_data, const Index* _triangles, glm::vec4* o_corners)
+{
+  const Vec3x4 p[3] = {gather(_data.vertices, _triangles, 0), gather(_data.vertices, _triangles, 1), gather(_data.vertices, _triangles, 2)};
+  __m128 u[3], v[3];
+  for (int c = 0; c < 3; ++c)
+  {
+    const glm::vec2& a = _data.uvs[_triangles[c]];
+    const glm::vec2& b = _data.uvs[_triangles[3 + c]];
+    const glm::vec2& d = _data.uvs[_triangles[6 + c]];
+    const glm::vec2& e = _data.uvs[_triangles[9 + c]];
+    u[c] = _mm_setr_ps(a.x, b.x, d.x, e.x);
+    v[c] = _mm_setr_ps(a.y, b.y, d.y, e.y);
+  }
+  const Vec3x4 d1 = sub(p[1], p[0]);
+  const Vec3x4 d2 = sub(p[2], p[0]);
+  const __m128 t21x = _mm_sub_ps(u[1], u[0]);
+  const __m128 t21y = _mm_sub_ps(v[1], v[0]);
+  const __m128 t31x = _mm_sub_ps(u[2], u[0]);
+  const __m128 t31y = _mm_sub_ps(v[2], v[0]);
+  const __m128 area = _mm_sub_ps(_mm_mul_ps(t21x, t31y), _mm_mul_ps(t21y, t31x));
+  const Vec3x4 os = sub(scale(d1, t31y), scale(d2, t21y));
+  const __m128 length = _mm_sqrt_ps(dot(os, os));
+  const __m128 epsilon = _mm_set1_ps(s_epsilon);
+  const __m128 valid = _mm_and_ps(_mm_cmpgt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), area), epsilon), _mm_cmpgt_ps(length, epsilon));
+  const __m128 sign = select(_mm_cmpgt_ps(area, _mm_setzero_ps()), _mm_set1_ps(1.0f), _mm_set1_ps(-1.0f));
+  const Vec3x4 tangent = scale(os, _mm_and_ps(valid, _mm_div_ps(sign, length)));
+  for (int c = 0; c < 3; ++c)
+  {
+    const Vec3x4 n = gather(_data.normals, _triangles, c);
+    const Vec3x4 e1 = sub(p[(c + 1) % 3], p[c]);
+    const Vec3x4 e2 = sub(p[(c + 2) % 3], p[c]);
+    const __m128 cosine = dot(normalizeSafe(sub(e1, scale(n, dot(n, e1)))), normalizeSafe(sub(e2, scale(n, dot(n, e2)))));
+    const __m128 angle = _mm_and_ps(valid, acosApprox(_mm_min_ps(_mm_max_ps(cosine, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f))));
+    const Vec3x4 projected = scale(normalizeSafe(sub(tangent, scale(n, dot(n, tangent)))), angle);
+    // Lanes are triangles, transposed so each row is one corner's xyzw
+    __m128 x = projected.x, y = projected.y, z = projected.z, w = _mm_mul_ps(angle, sign);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(&o_corners[c].x, x);
+    _mm_storeu_ps(&o_corners[3 + c].x, y);
+    _mm_storeu_ps(&o_corners[6 + c].x, z);
+    _mm_storeu_ps(&o_corners[9 + c].x, w);
+  }
+}
+#endif
+
+// Fills the tangents of every vertex from the triangles of _indices
+template<typename Index>
+void generateFrom(MeshStorage &io_data, const Index* _indices, const size_t _indexCount)
+{
+  ThreadPool& pool = ThreadPool::instance();
+  const size_t triangleCount = _indexCount / 3;
+  std::vector<glm::vec4> corners(triangleCount * 3);
+  size_t scalarFirst = 0;
+#ifdef TANGENTS_SSE
+  const size_t groups = triangleCount / 4;
+  pool.parallelFor(groups, [&](size_t _begin, size_t _end)
+  {
+    for (size_t g = _begin; g < _end; ++g)
+      cornerTangents4(io_data, _indices + g * 12, corners.data() + g * 12);
+  }, s_minRange / 4);
+  scalarFirst = groups * 4;
+#endif
+  pool.parallelFor(triangleCount - scalarFirst, [&](size_t _begin, size_t _end)
+  {
+    for (size_t t = scalarFirst + _begin; t < scalarFirst + _end; ++t)
+      cornerTangents(io_data, _indices + t * 3, corners.data() + t * 3);
+  }, s_minRange);
+
+  // Corners using each vertex, the ones of vertex v are cornerList[offsets[v]] to cornerList[offsets[v + 1]]
+  const size_t vertexCount = io_data.vertices.size();
+  std::vector<GLuint> offsets(vertexCount + 1, 0);
+  for (size_t i = 0; i < triangleCount * 3; ++i)
+    ++offsets[_indices[i] + 1];
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<GLuint> fill(offsets.begin(), offsets.end() - 1);
+  std::vector<GLuint> cornerList(triangleCount * 3);
+  for (size_t i = 0; i < triangleCount * 3; ++i)
+    cornerList[fill[_indices[i]]++] = static_cast<GLuint>(i);
+
+  io_data.tangents.resize(vertexCount);
+  pool.parallelFor(vertexCount, [&](size_t _begin, size_t _end)
+  {
+    for (size_t v = _begin; v < _end; ++v)
+    {
+      // Each handedness is summed on its own, w then holds the angle it covers
+      glm::vec4 positive(0.0f);
+      glm::vec4 negative(0.0f);
+      for (GLuint k = offsets[v]; k < offsets[v + 1]; ++k)
+      {
+        const glm::vec4& corner = corners[cornerList[k]];
+        if (corner.w > 0.0f)
+          positive += corner;
+        else if (corner.w < 0.0f)
+          negative += corner;
+      }
+      const bool mirrored = -negative.w > positive.w;
+      const glm::vec3 sum(mirrored ? negative : positive);
+      // Projected again onto the unit normal, the corners used the normal as imported
+      const glm::vec3 n = normalizeSafe(io_data.normals[v]);
+      glm::vec3 tangent = normalizeSafe(sum - n * glm::dot(n, sum));
+      if (tangent == glm::vec3(0.0f))
+      {
+        const glm::vec3 axis = std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        tangent = glm::normalize(axis - n * glm::dot(n, axis));
+      }
+      io_data.tangents[v] = glm::vec4(tangent, mirrored ? -1.0f : 1.0f);
+    }
+  }, s_minRange);
+}
+}
+
+void Tangents::generate(MeshStorage &io_data)
+{
+  io_data.tangents.clear();
+  const size_t vertexCount = io_data.vertices.size();
+  if (vertexCount == 0 || io_data.uvs.size() != vertexCount || io_data.normals.size() != vertexCount)
+    return;
+  // Level 0 covers every part at full detail, the coarser levels reuse its vertices
+  GLuint first = 0;
+  GLuint count = static_cast<GLuint>(io_data.indices.size() + io_data.indices32.size());
+  if (!io_data.lods.empty())
+  {
+    const MeshLod& lod = io_data.lods[0];
+    if (lod.subMeshCount == 0)
+      return;
+    const SubMesh& firstPart = io_data.subMeshes[lod.firstSubMesh];
+    const SubMesh& lastPart = io_data.subMeshes[lod.firstSubMesh + lod.subMeshCount - 1];
+    first = firstPart.firstIndex;
+    count = lastPart.firstIndex + lastPart.indexCount - first;
+  }
+  if (io_data.indices32.empty())
+    generateFrom(io_data, io_data.indices.data() + first, count);
+  else
+    generateFrom(io_data, io_data.indices32.data() + first, count);
+}
@@ -8,7 +8,12 @@
 #include "DataContainer.h"
 #include "ObjectManager.h"
 #include <vector>
+#include <unordered_map>
 #include "SceneObject.h"
+#include "Meshlets.h"
+#include "GeometryArena.h"
+#include "DrawBatches.h"
+#include "IndirectDraws.h"
 #include <QTableWidget>
 
 class MainScene : public Scene
@@ -90,21 +95,71 @@ private:
   std::vector<size_t> deduceSelectCmd(QString &_cmd);
   void updateBuffer(const size_t _geoID, const size_t _matID);
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Used to write our mesh data into the vbo.
+  /// @brief Used to put a mesh in the arena, only writing anything the first time.
+  /// @param [in,out] io_mesh is the mesh.
+  /// @return The mesh's range, nullptr if it is empty or its arrays can't be fetched.
   //-----------------------------------------------------------------------------------------------------
-  void writeMeshAttributes(size_t _id);
+  const GeometryArena::Allocation* uploadMesh(Mesh &io_mesh);
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Used to pass attribute pointers to the current shader program.
+  /// @brief Used to bind the page holding the mesh being drawn and pass its attribute pointers, only done
+  /// when the page differs from the last one.
   //-----------------------------------------------------------------------------------------------------
   void setAttributeBuffers();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to upload the matrices of this frame's batches as the per instance buffer, the attribute
+  /// pointers into it are set up once with the buffer.
+  //-----------------------------------------------------------------------------------------------------
+  void setInstanceBuffer();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to point the per instance attributes at an instance of the buffer, needed before GL 4.2
+  /// where draws have no base instance.
+  /// @param [in] _firstInstance is the instance the draws start at.
+  //-----------------------------------------------------------------------------------------------------
+  void setInstanceOffset(const GLuint _firstInstance);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to draw a batch of the mesh being drawn, its culled ranges for a single object, its
+  /// whole level for several. Without GL 4.2 the instance attributes are moved to the batch first.
+  /// @param [in] _batch is the batch, from m_batches.
+  /// @param [in] _mesh is the mesh m_meshRange belongs to.
+  /// @return The amount of indices drawn over all instances.
+  //-----------------------------------------------------------------------------------------------------
+  size_t drawBatch(const DrawBatches::Batch &_batch, const Mesh &_mesh);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to turn this frame's batches into indirect commands and upload them, leaving the command
+  /// buffer bound for the multi draws.
+  //-----------------------------------------------------------------------------------------------------
+  void setCommandBuffer();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to switch back face culling for the next draw.
+  /// @param [in] _cullBackFaces is true to cull back faces.
+  //-----------------------------------------------------------------------------------------------------
+  void setCulling(const bool _cullBackFaces);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to pick the level of detail of an object from the size of its mesh on screen. A level
+  /// is used once its error projects to less than s_lodPixelError pixels, and kept until it projects to
+  /// more than s_lodHysteresis times that, so objects near the switching distance don't flicker. The
+  /// distance and scale come from the object's cached world bounds.
+  /// @param [in] _object is the index of the object, its last level is kept by the object's ID.
+  /// @param [in] _mesh is the object's mesh.
+  /// @return The level to draw.
+  //-----------------------------------------------------------------------------------------------------
+  size_t selectLod(const size_t _object, const Mesh &_mesh);
   void useMaterial(const size_t _id);
   virtual void renderScene() override;
 
 private:
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Wraps up our OpenGL buffers and VAO.
+  /// @brief Shared buffers every mesh is uploaded into once, draws pick their mesh's range.
   //-----------------------------------------------------------------------------------------------------
-  MeshVBO m_meshVBO;
+  GeometryArena m_geometry;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The range of the mesh being drawn, owned by the mesh's storage.
+  //-----------------------------------------------------------------------------------------------------
+  const GeometryArena::Allocation* m_meshRange = nullptr;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The page the attribute pointers were last set for.
+  //-----------------------------------------------------------------------------------------------------
+  MeshVBO* m_boundBuffers = nullptr;
   //-----------------------------------------------------------------------------------------------------
   /// @brief Vertex array object, default constructed with a pointer to this OpenGL widget,
   /// a dynamic_cast is used due to Scene's multiple inheritence.
@@ -120,6 +175,67 @@ private:
   QString m_selectCmd;
   QString m_modCmd;
   bool m_wireframe = false;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Largest error in pixels a coarser level of detail may show.
+  //-----------------------------------------------------------------------------------------------------
+  static constexpr float s_lodPixelError = 1.0f;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief How much further the error of the current level may grow before a finer one is used.
+  //-----------------------------------------------------------------------------------------------------
+  static constexpr float s_lodHysteresis = 1.5f;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Level of detail an object was last drawn with, and the frame it was drawn in.
+  //-----------------------------------------------------------------------------------------------------
+  struct ObjectLod
+  {
+    size_t level = 0;
+    size_t frame = 0;
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The levels of the objects drawn last frame, by object ID. Objects that were removed or not
+  /// drawn are dropped after each frame.
+  //-----------------------------------------------------------------------------------------------------
+  std::unordered_map<size_t, ObjectLod> m_objectLods;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Counts frames, to tell which entries of m_objectLods were drawn this frame.
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_lodFrame = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Index ranges of the object being drawn, kept to reuse the allocation.
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<Meshlets::DrawRange> m_drawRanges;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief This frame's objects grouped into instanced draws, kept to reuse the allocations.
+  //-----------------------------------------------------------------------------------------------------
+  DrawBatches m_batches;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The model and normal matrices of every instance drawn this frame, written once per frame.
+  //-----------------------------------------------------------------------------------------------------
+  QOpenGLBuffer m_instanceBuffer {QOpenGLBuffer::VertexBuffer};
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief This frame's batches as indirect commands, grouped into one multi draw per bucket.
+  //-----------------------------------------------------------------------------------------------------
+  IndirectDraws m_indirect;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The commands of m_indirect, written once per frame and read by glMultiDrawElementsIndirect.
+  //-----------------------------------------------------------------------------------------------------
+  QOpenGLBuffer m_commandBuffer {QOpenGLBuffer::VertexBuffer};
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Whether the context has GL 4.3 and batches are submitted with multi draws.
+  //-----------------------------------------------------------------------------------------------------
+  bool m_multiDraw = false;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Triangles drawn in the last report, printed again when the count moves by a tenth.
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_reportedTriangles = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Draw calls issued in the last report, printed again when the count moves by a tenth.
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_reportedDraws = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Bytes the arena had uploaded at the last report, a frame that uploads anything prints again.
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_reportedUploads = 0;
 };
 
 #endif // MAINSCENE_H
@@ -9,10 +9,10 @@ layout (location = 1) in vec2 inUV;
 layout (location = 2) in vec3 inNormal;
 
 
-// We need an MVP because the plane needs to be rotated
-uniform mat4 MVP;
-uniform mat4 N;
-uniform mat4 M;
+// We need the matrices because the plane needs to be rotated, the model and normal ones are read per instance
+uniform mat4 VP;
+layout (location=4) in mat4 M;
+layout (location=8) in mat4 N; // This is the inverse transpose of the model matrix
 
 // Pass through the UV coordinates
 out vec2 FragmentUV;
@@ -22,6 +22,6 @@ void main() {
     FragmentUV = inUV;
 
     // Set the position of the current vertex
-    gl_Position = MVP * vec4(inVert, 1.0);
+    gl_Position = VP * M * vec4(inVert, 1.0);
 }
 
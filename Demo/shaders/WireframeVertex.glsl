@@ -12,14 +12,15 @@ out vec2 TexCoords;
 out vec3 WorldPos;
 out vec3 Normal;
 
-uniform mat4 MVP;
-uniform mat4 N;
-uniform mat4 M;
+// The view projection is shared by every object, the model and normal matrices are read per instance
+uniform mat4 VP;
+layout (location=4) in mat4 M;
+layout (location=8) in mat4 N; // This is the inverse transpose of the model matrix
 
 void main()
 {
-  gl_Position = MVP * vec4(inVert, 1.0);
   WorldPos = vec3(M * vec4(inVert, 1.0));
+  gl_Position = VP * vec4(WorldPos, 1.0);
   Normal = vec3(N * vec4(inNormal, 1.0));
   TexCoords = inUV;
 }
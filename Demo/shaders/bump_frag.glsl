@@ -1,10 +1,12 @@
 #version 430
 
 // A texture sampler to store the colour information
-uniform sampler2D ColourTexture;
+uniform sampler2D texMap;
 
-// A texture sampler to store the normal information
-uniform sampler2D NormalTexture;
+// A texture sampler to store the normal information, in the tangent space of the mesh
+uniform sampler2D bumpMap;
+
+uniform vec3 camPos;
 
 uniform float tiling = 10.0;
 
@@ -46,47 +48,29 @@ uniform MaterialInfo Material = MaterialInfo(
 smooth in vec3 FragmentPosition;
 smooth in vec3 FragmentNormal;
 smooth in vec2 FragmentTexCoord;
+smooth in vec3 FragmentTangent;
+flat in float FragmentHandedness;
 
 
-mat4 rotationMatrix(vec3 axis, float angle)
-{
-    axis = normalize(axis);
-    float s = sin(angle);
-    float c = cos(angle);
-    float oc = 1.0 - c;
-
-    return mat4(oc * axis.x * axis.x + c,           oc * axis.x * axis.y - axis.z * s,  oc * axis.z * axis.x + axis.y * s,  0.0,
-                oc * axis.x * axis.y + axis.z * s,  oc * axis.y * axis.y + c,           oc * axis.y * axis.z - axis.x * s,  0.0,
-                oc * axis.z * axis.x - axis.y * s,  oc * axis.y * axis.z + axis.x * s,  oc * axis.z * axis.z + c,           0.0,
-                0.0,                                0.0,                                0.0,                                1.0);
-}
-
-vec3 rotate(vec3 v, vec3 axis, float angle) {
-  mat4 m = rotationMatrix(axis, angle);
-  vec4 _norm = m * vec4(v, 1.0);
-  return _norm.xyz/_norm.w;
-}
-
 void main() {
     // Calculate the normal (this is the expensive bit in Phong)
     vec3 n = normalize( FragmentNormal );
 
-    // ***********************************************************
-    // What you'll need to do here is rotate n based on the normal
-    // provided in the normal map. After this, the lighting
-    // calculations will work below.
-    // ***********************************************************
-
-    //vec2 position = ( gl_FragCoord.xy / resolution.xy );
-    vec3 color = normalize(texture(NormalTexture, FragmentTexCoord*tiling).rgb*2-1);
-
-    vec3 axis = normalize(cross(vec3(0,0,1), color));
-    float angle = acos(dot(vec3(0,0,1), color));
-    n=rotate(n, axis, angle);
+    // Rebuild the tangent frame, interpolation leaves it slightly skewed. Meshes loaded without tangents
+    // read a zero one and keep their normal
+    vec3 t = FragmentTangent - n * dot(n, FragmentTangent);
+    if (dot(t, t) > 1e-12)
+    {
+        t = normalize(t);
+        vec3 b = FragmentHandedness * cross(n, t);
 
+        // Move the normal from the map's tangent space to the surface
+        vec3 mapped = normalize(texture(bumpMap, FragmentTexCoord*tiling).rgb*2-1);
+        n = normalize(mat3(t, b, n) * mapped);
+    }
 
     // Calculate the view vector
-    vec3 v = normalize(vec3(-FragmentPosition));
+    vec3 v = normalize(camPos - FragmentPosition);
 
     // Calculate the light vector
     vec3 s = normalize( vec3(Light.Position) - FragmentPosition );
@@ -102,7 +86,7 @@ void main() {
 
     // This is the call that retrieves the colour from the texture map using the
     // givne texture coordinates.
-    vec3 texColor = texture(ColourTexture, FragmentTexCoord*tiling).rgb;
+    vec3 texColor = texture(texMap, FragmentTexCoord*tiling).rgb;
 
     // Use the following shader for the correct value
     fragColour = vec4(texColor*lightColor,1.0);
@@ -1,9 +1,9 @@
 #version 430
 
-// The modelview and projection matrices are no longer given in OpenGL 4.2
-uniform mat4 MVP;
-uniform mat4 MV;
-uniform mat3 N; // This is the inverse transpose of the mv matrix
+// The view projection is shared by every object, the model and normal matrices are read per instance
+uniform mat4 VP;
+layout (location=4) in mat4 M;
+layout (location=8) in mat4 N; // This is the inverse transpose of the model matrix
 
 // The vertex position attribute
 layout (location=0) in vec3 VertexPosition;
@@ -14,21 +14,31 @@ layout (location=1) in vec2 TexCoord;
 // The vertex normal attribute
 layout (location=2) in vec3 VertexNormal;
 
+// The vertex tangent attribute, w holds the handedness of the UVs
+layout (location=3) in vec4 VertexTangent;
+
 // These attributes are passed onto the shader (should they all be smoothed?)
 smooth out vec3 FragmentPosition;
 smooth out vec3 FragmentNormal;
 smooth out vec2 FragmentTexCoord;
+smooth out vec3 FragmentTangent;
+flat out float FragmentHandedness;
 
 void main() {  	  
     // Compute the unprojected vertex position
-    FragmentPosition = vec3(MV * vec4(VertexPosition, 1.0) );
+    FragmentPosition = vec3(M * vec4(VertexPosition, 1.0) );
 
     // Transform the vertex normal by the inverse transpose modelview matrix
-    FragmentNormal = normalize(N * VertexNormal);
+    FragmentNormal = normalize(vec3(N * vec4(VertexNormal, 0.0)));
+
+    // M may also hold the transform of quantized positions, so the tangent goes with the normal, exact
+    // for rotations and uniform scales, and the fragment shader makes the frame orthogonal again
+    FragmentTangent = vec3(N * vec4(VertexTangent.xyz, 0.0));
+    FragmentHandedness = VertexTangent.w;
 
     // Copy across the texture coordinates
     FragmentTexCoord = TexCoord;
 
     // Compute the position of the vertex
-    gl_Position = MVP * vec4(VertexPosition,1.0);
+    gl_Position = VP * vec4(FragmentPosition, 1.0);
 }
@@ -14,9 +14,10 @@ smooth out vec3 FragmentPosition;
 smooth out vec3 FragmentNormal;
 smooth out vec2 FragmentTexCoord;
 
-uniform mat4 M;            // model view matrix calculated in the App
-uniform mat4 MVP;           // model view projection calculated in the app
-uniform mat4 N;             // normal matrix calculated in the app
+// The view projection is shared by every object, the model and normal matrices are read per instance
+uniform mat4 VP;
+layout (location=4) in mat4 M;
+layout (location=8) in mat4 N; // This is the inverse transpose of the model matrix
 
 void main()
 {
@@ -30,7 +31,7 @@ void main()
     FragmentTexCoord = inUV;
 
     // Compute the position of the vertex
-    gl_Position = MVP * vec4(inVert,1.0);
+    gl_Position = VP * vec4(FragmentPosition, 1.0);
 }
 
 
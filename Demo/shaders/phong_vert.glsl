@@ -2,10 +2,10 @@
 #extension GL_EXT_gpu_shader4 : enable
 //#extension GL_ARB_shading_language_420pack: enable    // Use for GLSL versions before 420.
 
-// The modelview and projection matrices are no longer given in OpenGL 4.2
-uniform mat4 MVP;
-uniform mat4 M;
-uniform mat4 N; // This is the inverse transpose of the mv matrix
+// The view projection is shared by every object, the model and normal matrices are read per instance
+uniform mat4 VP;
+layout (location=4) in mat4 M;
+layout (location=8) in mat4 N; // This is the inverse transpose of the model matrix
 
 // The vertex position attribute
 layout (location=0) in vec3 inVert;
@@ -33,5 +33,5 @@ void main()
     WSTexCoord = inUV;
 
     // Compute the position of the vertex
-    gl_Position = MVP * vec4(inVert,1.0);
+    gl_Position = VP * vec4(WSVertexPosition, 1.0);
 }
@@ -6,74 +6,247 @@
 #include <MaterialFractal.h>
 #include <MaterialEnvMap.h>
 #include <sys/stat.h>
+#include <QElapsedTimer>
+#include <QOpenGLFunctions_4_1_Core>
+#include <QOpenGLFunctions_4_2_Core>
+#include <QOpenGLFunctions_4_3_Core>
+#include <cstddef>
+#include <algorithm>
+
+namespace
+{
+//any object can be given the bump material, so every mesh is loaded with tangents
+constexpr unsigned int s_meshPasses = MeshOptimizer::LOD | MeshOptimizer::MESHLETS | MeshOptimizer::VERTEX_CACHE |
+                                      MeshOptimizer::VERTEX_FETCH | MeshOptimizer::TANGENTS;
+//batches are drawn pass by pass, the selection outline goes over the objects
+constexpr size_t s_gridPass = 0;
+constexpr size_t s_objectPass = 1;
+constexpr size_t s_selectionPass = 2;
+}
 
 //-----------------------------------------------------------------------------------------------------
-void MainScene::writeMeshAttributes(size_t _id)
+void MainScene::setAttributeBuffers()
 {
-  const auto& mesh = static_cast<Mesh*>(m_drawData->geoFind(_id));
+  if(m_meshRange == nullptr)
+    return;
+  //the attribute pointers stay in the vertex array object, they only change when the draws move to another page
+  MeshVBO& buffers = m_meshRange->buffers();
+  if(&buffers == m_boundBuffers)
+    return;
+  m_boundBuffers = &buffers;
+  buffers.use();
+  auto prog = m_shaderLib->getCurrentShader();
 
   using namespace MeshAttributes;
-  for (const auto buff : {VERTEX, UV, NORMAL})
+  for (const auto buff : {VERTEX, UV, NORMAL, TANGENT})
   {
-    m_meshVBO.write(mesh->getAttribData(buff), buff);
+    // Attributes the mesh doesn't have read a constant instead of another attribute's data
+    if (buffers.dataAmount(buff) == 0)
+    {
+      prog->disableAttributeArray(buff);
+      continue;
+    }
+    prog->enableAttributeArray(buff);
+    prog->setAttributeBuffer(buff, buffers.type(buff), buffers.offset(buff), buffers.components(buff), buffers.stride());
   }
-  m_meshVBO.setIndices(mesh->getIndicesData());
 }
 //-----------------------------------------------------------------------------------------------------
-void MainScene::setAttributeBuffers()
+void MainScene::setInstanceBuffer()
 {
-  static constexpr int tupleSize[] = {3,2,3};
-  auto prog = m_shaderLib->getCurrentShader();
-
+  const auto &instances = m_batches.instances();
+  if(instances.empty())
+    return;
+  if(!m_instanceBuffer.isCreated())
+  {
+    //instanced attributes need GL 4.1 core, drawBatch draws nothing without it
+    auto gl = context()->versionFunctions<QOpenGLFunctions_4_1_Core>();
+    if(gl == nullptr)
+      return;
+    m_instanceBuffer.create();
+    m_instanceBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+    m_instanceBuffer.bind();
+    //the pointers stay in the vertex array object, a column of a matrix per location, advancing once per instance
+    using namespace MeshAttributes;
+    for(const auto matrix : {MODEL_MATRIX, NORMAL_MATRIX})
+    {
+      for(GLuint column = 0; column < 4; ++column)
+      {
+        gl->glEnableVertexAttribArray(matrix + column);
+        gl->glVertexAttribDivisor(matrix + column, 1);
+      }
+    }
+    setInstanceOffset(0);
+  }
+  //allocated again each frame, so the driver can hand out new storage instead of waiting on last frame's draws
+  m_instanceBuffer.bind();
+  m_instanceBuffer.allocate(instances.data(), static_cast<int>(instances.size() * sizeof(DrawBatches::Instance)));
+}
+//-----------------------------------------------------------------------------------------------------
+void MainScene::setInstanceOffset(const GLuint _firstInstance)
+{
+  auto gl = context()->versionFunctions<QOpenGLFunctions_4_1_Core>();
+  if(gl == nullptr)
+    return;
+  m_instanceBuffer.bind();
   using namespace MeshAttributes;
-  for (const auto buff : {VERTEX, UV, NORMAL})
+  const size_t base = _firstInstance * sizeof(DrawBatches::Instance);
+  for(const auto matrix : {MODEL_MATRIX, NORMAL_MATRIX})
   {
-    prog->enableAttributeArray(buff);
-    prog->setAttributeBuffer(buff, GL_FLOAT, m_meshVBO.offset(buff), tupleSize[buff]);
+    const size_t offset = base + (matrix == MODEL_MATRIX ? offsetof(DrawBatches::Instance, model) : offsetof(DrawBatches::Instance, normal));
+    for(GLuint column = 0; column < 4; ++column)
+    {
+      gl->glVertexAttribPointer(matrix + column, 4, GL_FLOAT, GL_FALSE, sizeof(DrawBatches::Instance),
+                                reinterpret_cast<const void*>(offset + column * sizeof(glm::vec4)));
+    }
+  }
+}
+//-----------------------------------------------------------------------------------------------------
+size_t MainScene::drawBatch(const DrawBatches::Batch &_batch, const Mesh &_mesh)
+{
+  //mesh indices start at 0, the base vertex moves them to the mesh's vertices in the page and the base
+  //instance moves the batch to its instances
+  auto gl = context()->versionFunctions<QOpenGLFunctions_4_2_Core>();
+  auto gl41 = context()->versionFunctions<QOpenGLFunctions_4_1_Core>();
+  if((gl == nullptr && gl41 == nullptr) || !m_instanceBuffer.isCreated())
+    return 0;
+  //before GL 4.2 the instance attributes are pointed at the batch's instances instead
+  if(gl == nullptr)
+    setInstanceOffset(_batch.firstInstance);
+  auto draw = [&](const GLuint _first, const GLuint _count, const GLsizei _instances)
+  {
+    if(gl != nullptr)
+      gl->glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(_count), m_meshRange->indexType(),
+                                                        m_meshRange->indexOffset(_first), _instances, m_meshRange->baseVertex(),
+                                                        _batch.firstInstance);
+    else
+      gl41->glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(_count), m_meshRange->indexType(),
+                                              m_meshRange->indexOffset(_first), _instances, m_meshRange->baseVertex());
+  };
+  if(_batch.rangeCount == 0)
+  {
+    //levels are packed in order, so the whole level is one range of the index buffer
+    const GLuint first = _mesh.getSubMesh(_mesh.getLod(_batch.key.level).firstSubMesh).firstIndex;
+    const GLuint count = _mesh.getLodIndexCount(_batch.key.level);
+    draw(first, count, static_cast<GLsizei>(_batch.instanceCount));
+    return static_cast<size_t>(count) * _batch.instanceCount;
+  }
+  size_t indices = 0;
+  for(size_t i = _batch.firstRange; i < _batch.firstRange + _batch.rangeCount; ++i)
+  {
+    const Meshlets::DrawRange& range = m_batches.range(i);
+    draw(range.firstIndex, range.indexCount, 1);
+    indices += range.indexCount;
+  }
+  return indices;
+}
+//-----------------------------------------------------------------------------------------------------
+void MainScene::setCommandBuffer()
+{
+  m_indirect.clear();
+  for(const auto &batch : m_batches.batches())
+  {
+    auto mesh = static_cast<Mesh*>(m_drawData->geoFind(batch.key.geo));
+    //already in the arena, batches are only made from uploaded meshes
+    m_indirect.add(m_batches, batch, *mesh, *uploadMesh(*mesh));
+  }
+  const auto &commands = m_indirect.commands();
+  if(commands.empty())
+    return;
+  if(!m_commandBuffer.isCreated())
+  {
+    m_commandBuffer.create();
+    m_commandBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
   }
+  //QOpenGLBuffer has no indirect type, it is filled as a vertex buffer and bound for the multi draws by id
+  m_commandBuffer.bind();
+  m_commandBuffer.allocate(commands.data(), static_cast<int>(commands.size() * sizeof(IndirectDraws::Command)));
+  context()->versionFunctions<QOpenGLFunctions_4_3_Core>()->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer.bufferId());
+}
+//-----------------------------------------------------------------------------------------------------
+void MainScene::setCulling(const bool _cullBackFaces)
+{
+  if(_cullBackFaces)
+    glEnable(GL_CULL_FACE);
+  else
+    glDisable(GL_CULL_FACE);
+}
+//-----------------------------------------------------------------------------------------------------
+size_t MainScene::selectLod(const size_t _object, const Mesh &_mesh)
+{
+  //kept by ID, so removing objects or reordering them never hands one object another's level
+  ObjectLod& state = m_objectLods[m_objects->objectAt(_object)->getID()];
+  state.frame = m_lodFrame;
+  size_t& level = state.level;
+  level = std::min(level, _mesh.getLodCount() - 1);
+  //pixels per model unit at the centre of the bounding sphere, the world radius over the mesh radius is the
+  //largest scale of the transform
+  const BaseMesh::Bounds& world = m_objects->worldBoundsAt(_object);
+  const float radius = _mesh.getBounds().radius;
+  const float scale = radius > 0.0f ? world.radius / radius : 1.0f;
+  const float distance = std::max(glm::length(vec3(m_camera->viewMatrix() * vec4(world.centre, 1.0f))), 0.0001f);
+  const float pixels = m_camera->projMatrix()[1][1] * 0.5f * height() * devicePixelRatio() * scale / distance;
+  while(level + 1 < _mesh.getLodCount() && _mesh.getLod(level + 1).error * pixels < s_lodPixelError)
+    ++level;
+  while(level > 0 && _mesh.getLod(level).error * pixels > s_lodPixelError * s_lodHysteresis)
+    --level;
+  return level;
 }
 //-----------------------------------------------------------------------------------------------------
 void MainScene::initGeo()
 {
-  Mesh* temp1= new Mesh;
-  Mesh* temp2= new Mesh;
-  Mesh* temp3= new Mesh;
-  Mesh* temp4= new Mesh;
-  Mesh* temp5= new Mesh;
-  Mesh* temp6= new Mesh;
-  temp1->load("models/Grid.obj");
-  temp2->load("models/cube.obj");
-  temp3->load("models/Sphere.obj");
-  temp4->load("models/Suzanne.obj");
-  temp5->load("models/mandarin.obj");
-  temp6->load("models/test2.obj");
-  m_drawData->geoPut(temp1, "Grid");
-  m_drawData->geoPut(temp2, "Cube");
-  m_drawData->geoPut(temp3, "Sphere");
-  m_drawData->geoPut(temp4, "Chimp");
-  m_drawData->geoPut(temp5, "Fruit");
-  m_drawData->geoPut(temp6, "Thing");
-  // Create and bind our Vertex Array Object
+  const std::vector<std::pair<std::string, std::string>> models = {
+    {"models/Grid.obj", "Grid"}, {"models/cube.obj", "Cube"}, {"models/Sphere.obj", "Sphere"},
+    {"models/Suzanne.obj", "Chimp"}, {"models/mandarin.obj", "Fruit"}, {"models/test2.obj", "Thing"}};
+  // Create and bind our Vertex Array Object, meshes are uploaded as they load
   m_vao->create();
   m_vao->bind();
-  // Create and bind our Vertex Buffer Object
-  m_meshVBO.init();
-  updateBuffer(0, 0);
+  //multi draw indirect needs GL 4.3, contexts without it draw batch by batch
+  m_multiDraw = context()->versionFunctions<QOpenGLFunctions_4_3_Core>() != nullptr;
+  std::cout<<"Submitting draws "<<(m_multiDraw ? "with glMultiDrawElementsIndirect" : "one instanced batch at a time");
+  if(context()->versionFunctions<QOpenGLFunctions_4_2_Core>() == nullptr)
+    std::cout<<", moving the instance attributes to each batch without base instance";
+  std::cout<<std::endl;
+  QElapsedTimer total;
+  total.start();
+  for(const auto &model : models)
+  {
+    QElapsedTimer timer;
+    timer.start();
+    Mesh* mesh = new Mesh;
+    mesh->setLayout(MeshAttributes::QUANTIZED);
+    mesh->setResidency(Mesh::GPU_ONLY);
+    mesh->setOptimization(s_meshPasses);
+    mesh->load(model.first);
+    //cold times are full imports, warm times are reads from models/cache
+    std::cout<<model.first<<" loaded in "<<timer.nsecsElapsed()/1000000.0<<" ms ("<<(mesh->loadedFromCache() ? "warm, cached" : "cold, imported")<<")"<<std::endl;
+    const QuantizationError error = mesh->getQuantizationError();
+    std::cout<<"  quantized, largest error "<<error.position<<" units, "<<error.normal<<" degrees, "<<error.uv<<" uv"<<std::endl;
+    //the arrays are released once they are in GPU buffers, only culling and level of detail data stays
+    const size_t loadedBytes = mesh->residentBytes();
+    uploadMesh(*mesh);
+    std::cout<<"  "<<mesh->gpuBytes()<<" bytes on the GPU, "<<mesh->residentBytes()<<" bytes left in memory of "<<loadedBytes<<std::endl;
+    m_drawData->geoPut(mesh, model.second);
+  }
+  std::cout<<"Startup geometry loaded in "<<total.nsecsElapsed()/1000000.0<<" ms, "<<m_geometry.usedBytes()<<" bytes in "
+           <<m_geometry.pageCount()<<" shared buffer pages of "<<m_geometry.byteSize()<<" bytes"<<std::endl;
+  m_reportedUploads = m_geometry.uploadedBytes();
+}
+//-----------------------------------------------------------------------------------------------------
+const GeometryArena::Allocation* MainScene::uploadMesh(Mesh &io_mesh)
+{
+  //writing to a page binds its buffers in the vertex array object, the next draw binds its own again
+  const size_t uploaded = m_geometry.uploadedBytes();
+  const GeometryArena::Allocation* range = io_mesh.upload(m_geometry);
+  if(m_geometry.uploadedBytes() != uploaded)
+    m_boundBuffers = nullptr;
+  return range;
 }
 //-----------------------------------------------------------------------------------------------------
 void MainScene::updateBuffer(const size_t _geoID, const size_t _matID)
 {
   makeCurrent();
-  auto mesh = static_cast<Mesh*>(m_drawData->geoFind(_geoID));
-  m_meshVBO.reset(
-        sizeof(GLushort),
-        mesh->getNIndicesData(),
-        sizeof(GLfloat),
-        mesh->getNVertData(),
-        mesh->getNUVData(),
-        mesh->getNNormData()
-        );
-  writeMeshAttributes(_geoID);
+  //uploaded into the arena on first use, after that drawing only picks the mesh's range
+  m_meshRange = uploadMesh(*static_cast<Mesh*>(m_drawData->geoFind(_geoID)));
   useMaterial(_matID);
 }
 //-----------------------------------------------------------------------------------------------------
@@ -93,7 +266,7 @@ void MainScene::initMaterials()
   {
     auto mat = m_drawData->matFind(i);
     auto name = m_shaderLib->loadShaderProg(mat->shaderFileName());
-    mat->setName(name);
+    m_drawData->setMatName(mat->getID(), name);
     mat->setShaderName(name);
     mat->apply();
   }
@@ -114,6 +287,15 @@ void MainScene::init()
 {
   Scene::init();
 
+  m_drawData->setGeoFactory([]
+  {
+    Mesh* mesh = new Mesh;
+    mesh->setLayout(MeshAttributes::QUANTIZED);
+    mesh->setResidency(Mesh::GPU_ONLY);
+    mesh->setOptimization(s_meshPasses);
+    return mesh;
+  });
+  m_objects->setDataContainer(m_drawData.get());
   initMaterials();
   initGeo();
   std::vector<std::pair<size_t, std::string>> geo = {{1, "Cube"}, {2, "Sphere"}, {3, "Chimp"}, {4, "Fruit"}, {5, "Thing"}};
@@ -139,47 +321,136 @@ void MainScene::renderScene()
 {
   Scene::renderScene();
   using namespace SceneMatrices;
-  mat4 t1=m_matrices[MODEL_VIEW];
-  mat4 t2=m_matrices[PROJECTION];
-  mat4 t3=m_matrices[NORMAL];
-
-  m_drawData->matFind(0)->update();
-  m_meshVBO.use();
-  updateBuffer(0,0);
-  glDrawElements(GL_TRIANGLES, static_cast<Mesh*>(m_drawData->geoFind(0))->getNIndicesData(), GL_UNSIGNED_SHORT, nullptr);
+
+  for(auto id : m_drawData->geoPollAsync())
+  {
+    std::cout<<"Geometry successfully loaded: "<<m_drawData->getGeoName(id)<<std::endl;
+    std::cout<<"Mesh memory: "<<m_drawData->geoResidentBytes()<<" bytes, "<<m_drawData->geoSharedBytes()<<" bytes saved by sharing identical meshes, "
+             <<m_drawData->geoGpuBytes()<<" bytes on the GPU"<<std::endl;
+  }
+  //meshes swapped in or evicted above may have freed the range drawn last, and other GL code may have bound
+  //other buffers since the last frame
+  m_meshRange = nullptr;
+  m_boundBuffers = nullptr;
+  m_batches.clear();
+  auto grid = static_cast<Mesh*>(m_drawData->geoUse(0));
+  if(grid != nullptr && grid->getNIndicesData() != 0 && uploadMesh(*grid) != nullptr)
+  {
+    DrawBatches::Instance instance;
+    instance.model = m_matrices[MODEL_VIEW] * grid->getPositionMatrix();
+    instance.normal = m_matrices[NORMAL];
+    m_drawRanges.assign(1, {grid->getSubMesh(grid->getLod(0).firstSubMesh).firstIndex, grid->getLodIndexCount(0)});
+    DrawBatches::Key key;
+    key.pass = s_gridPass;
+    m_batches.add(key, instance, m_drawRanges);
+  }
+  size_t fullTriangles = 0;
   for(size_t i=0; i<m_objects->getObjectCount(); ++i)
   {
     if(m_objects->objectAt(i)->isActive())
     {
+      auto mesh = static_cast<Mesh*>(m_drawData->geoUse(m_objects->objectAt(i)->getGeoID()));
+      if(mesh == nullptr || mesh->getNIndicesData() == 0) //still loading, evicted or gone
+        continue;
+      if(uploadMesh(*mesh) == nullptr) //released arrays that could not be fetched back for another layout
+        continue;
       //m_objects->objectAt(i)->setGeo(i%(m_drawData->geosize()-1)+1);
       //m_objects->objectAt(i)->setMat(i%(m_drawData->matSize()-1)+1);
-      m_matrices[MODEL_VIEW] = m_objects->objectAt(i)->getMVmatrix();
-      m_matrices[PROJECTION] = m_camera->projMatrix() * m_camera->viewMatrix() * m_matrices[MODEL_VIEW];
-      m_matrices[NORMAL] = glm::inverse(glm::transpose(m_matrices[MODEL_VIEW]));
-      if(m_wireframe)
+      //quantized positions are decoded by the model matrix, normals only see the object transform
+      const mat4 model = m_objects->objectAt(i)->getMVmatrix();
+      DrawBatches::Instance instance;
+      instance.model = model * mesh->getPositionMatrix();
+      instance.normal = glm::inverse(glm::transpose(model));
+      const size_t level = selectLod(i, *mesh);
+      //back facing meshlets are only dropped where the GPU culls back faces too, wireframes show them and
+      //mirroring transforms turn them to the front
+      const bool cullBackFaces = !m_wireframe && glm::determinant(mat3(model)) > 0.0f;
+      const vec3 eye = vec3(glm::inverse(m_camera->viewMatrix() * model)[3]);
+      const mat4 clip = m_camera->projMatrix() * m_camera->viewMatrix() * model;
+      Meshlets::cull(*mesh, mesh->getLod(level), clip, eye, cullBackFaces, m_drawRanges);
+      fullTriangles += mesh->getLodIndexCount(0) / 3;
+      //objects with the same mesh, material and level go out in one instanced draw
+      DrawBatches::Key key;
+      key.pass = s_objectPass;
+      key.material = m_wireframe ? 0 : m_objects->objectAt(i)->getMatID();
+      key.geo = m_objects->objectAt(i)->getGeoID();
+      key.level = level;
+      key.cullBackFaces = cullBackFaces;
+      m_batches.add(key, instance, m_drawRanges);
+      if(!m_wireframe && m_objects->isSelected(i))
       {
-        m_drawData->matFind(m_objects->objectAt(i)->getMatID())->update();
-        updateBuffer(m_objects->objectAt(i)->getGeoID(), 0);
-        glDrawElements(GL_TRIANGLES, static_cast<Mesh*>(m_drawData->geoFind(m_objects->objectAt(i)->getGeoID()))->getNIndicesData(), GL_UNSIGNED_SHORT, nullptr);
-      }
-      else
-      {
-        m_drawData->matFind(m_objects->objectAt(i)->getMatID())->update();
-        updateBuffer(m_objects->objectAt(i)->getGeoID(), m_objects->objectAt(i)->getMatID());
-        glDrawElements(GL_TRIANGLES, static_cast<Mesh*>(m_drawData->geoFind(m_objects->objectAt(i)->getGeoID()))->getNIndicesData(), GL_UNSIGNED_SHORT, nullptr);
-
-        if(m_objects->isSelected(i))
-        {
-          m_drawData->matFind(m_objects->objectAt(i)->getMatID())->update();
-          updateBuffer(m_objects->objectAt(i)->getGeoID(), 0);
-          glDrawElements(GL_TRIANGLES, static_cast<Mesh*>(m_drawData->geoFind(m_objects->objectAt(i)->getGeoID()))->getNIndicesData(), GL_UNSIGNED_SHORT, nullptr);
-        }
+        key.pass = s_selectionPass;
+        key.material = 0;
+        m_batches.add(key, instance, m_drawRanges);
       }
     }
   }
-  m_matrices[MODEL_VIEW] = t1;
-  m_matrices[PROJECTION] = t2;
-  m_matrices[NORMAL] = t3;
+  //objects removed since the last frame, or not drawn in this one, drop their level
+  for(auto it = m_objectLods.begin(); it != m_objectLods.end();)
+  {
+    if(it->second.frame != m_lodFrame)
+      it = m_objectLods.erase(it);
+    else
+      ++it;
+  }
+  ++m_lodFrame;
+  m_batches.build();
+  setInstanceBuffer();
+  size_t drawnTriangles = 0;
+  size_t drawCalls = 0;
+  if(m_multiDraw)
+  {
+    //every bucket of batches sharing a material, culling and page is one call, the commands do the rest
+    setCommandBuffer();
+    auto gl = context()->versionFunctions<QOpenGLFunctions_4_3_Core>();
+    for(const auto &bucket : m_indirect.buckets())
+    {
+      setCulling(bucket.key.cullBackFaces);
+      m_drawData->matFind(bucket.key.material)->update();
+      updateBuffer(bucket.key.geo, bucket.key.material);
+      gl->glMultiDrawElementsIndirect(GL_TRIANGLES, m_meshRange->indexType(),
+                                      reinterpret_cast<const void*>(bucket.firstCommand * sizeof(IndirectDraws::Command)),
+                                      static_cast<GLsizei>(bucket.commandCount), 0);
+      ++drawCalls;
+      if(bucket.key.pass == s_objectPass)
+        drawnTriangles += bucket.indices / 3;
+    }
+  }
+  else
+  {
+    for(const auto &batch : m_batches.batches())
+    {
+      setCulling(batch.key.cullBackFaces);
+      m_drawData->matFind(batch.key.material)->update();
+      updateBuffer(batch.key.geo, batch.key.material);
+      const size_t indices = drawBatch(batch, *static_cast<Mesh*>(m_drawData->geoFind(batch.key.geo)));
+      drawCalls += batch.rangeCount != 0 ? batch.rangeCount : 1;
+      if(batch.key.pass == s_objectPass)
+        drawnTriangles += indices / 3;
+    }
+  }
+  glDisable(GL_CULL_FACE);
+  if(drawnTriangles * 10 < m_reportedTriangles * 9 || drawnTriangles * 10 > m_reportedTriangles * 11)
+  {
+    std::cout<<"Drawing "<<drawnTriangles<<" triangles after level of detail and meshlet culling, "<<fullTriangles<<" at full detail"<<std::endl;
+    m_reportedTriangles = drawnTriangles;
+  }
+  if(drawCalls * 10 < m_reportedDraws * 9 || drawCalls * 10 > m_reportedDraws * 11)
+  {
+    std::cout<<"Issuing "<<drawCalls<<" draw calls for "<<m_batches.batches().size()<<" instanced batches of "<<m_batches.instances().size()
+             <<" objects, "<<m_batches.separateDraws()<<" without instancing";
+    if(m_multiDraw)
+      std::cout<<", "<<m_indirect.commands().size()<<" indirect commands";
+    std::cout<<std::endl;
+    m_reportedDraws = drawCalls;
+  }
+  //static geometry is only uploaded once, anything written after startup is a mesh loaded or reloaded
+  if(m_geometry.uploadedBytes() != m_reportedUploads)
+  {
+    std::cout<<"Uploaded "<<m_geometry.uploadedBytes() - m_reportedUploads<<" bytes of geometry this frame, "<<m_geometry.usedBytes()
+             <<" bytes in "<<m_geometry.pageCount()<<" shared buffer pages"<<std::endl;
+    m_reportedUploads = m_geometry.uploadedBytes();
+  }
 }
 //-----------------------------------------------------------------------------------------------------
 void MainScene::createSceneObjectFull(std::string _name, vec3 _pos, vec3 _rot, vec3 _sc, std::pair<size_t, std::string> _geo, std::pair<size_t, std::string> _mat)
@@ -330,35 +601,35 @@ void MainScene::deduceCreateMat(QString& _name)
     m_drawData->matPut(new MaterialWireframe(m_camera, m_shaderLib, &m_matrices));
     auto mat = m_drawData->matFind(m_drawData->matSize()-1);
     auto name = m_shaderLib->loadShaderProg(mat->shaderFileName());
-    mat->setName(name);
+    m_drawData->setMatName(mat->getID(), name);
     mat->setShaderName(name);
     break;}
   case 1:{
     m_drawData->matPut(new MaterialPhong(m_camera, m_shaderLib, &m_matrices));
     auto mat = m_drawData->matFind(m_drawData->matSize()-1);
     auto name = m_shaderLib->loadShaderProg(mat->shaderFileName());
-    mat->setName(name);
+    m_drawData->setMatName(mat->getID(), name);
     mat->setShaderName(name);
     break;}
   case 3:{
     m_drawData->matPut(new MaterialBump(m_camera, m_shaderLib, &m_matrices));
     auto mat = m_drawData->matFind(m_drawData->matSize()-1);
     auto name = m_shaderLib->loadShaderProg(mat->shaderFileName());
-    mat->setName(name);
+    m_drawData->setMatName(mat->getID(), name);
     mat->setShaderName(name);
     break;}
   case 4:{
     m_drawData->matPut(new MaterialFractal(m_camera, m_shaderLib, &m_matrices));
     auto mat = m_drawData->matFind(m_drawData->matSize()-1);
     auto name = m_shaderLib->loadShaderProg(mat->shaderFileName());
-    mat->setName(name);
+    m_drawData->setMatName(mat->getID(), name);
     mat->setShaderName(name);
     break;}
   case 5:{
     m_drawData->matPut(new MaterialEnvMap(m_camera, m_shaderLib, &m_matrices));
     auto mat = m_drawData->matFind(m_drawData->matSize()-1);
     auto name = m_shaderLib->loadShaderProg(mat->shaderFileName());
-    mat->setName(name);
+    m_drawData->setMatName(mat->getID(), name);
     mat->setShaderName(name);
     break;}
   case 2:{
@@ -375,7 +646,7 @@ void MainScene::deduceCreateMat(QString& _name)
       m_drawData->matPut(new MaterialPBR(m_camera, m_shaderLib, &m_matrices, {a, b, c}, 1.0f, 1.0f, 0.5f, 1.0f));
       auto mat = m_drawData->matFind(m_drawData->matSize()-1);
       auto name = m_shaderLib->loadShaderProg(mat->shaderFileName());
-      mat->setName(name);
+      m_drawData->setMatName(mat->getID(), name);
       mat->setShaderName(name);
     }
     else
@@ -435,10 +706,8 @@ void MainScene::loadFile()
         std::cout<<"Loading geometry from: "<<"models/"<<normal<<" ..."<<std::endl;
         if(fileExists("models/"+normal))
         {
-          Mesh* newMesh = new Mesh;
-          newMesh->load("models/"+normal);
-          m_drawData->geoPut(newMesh, normal.substr(0, normal.size()-4));
-          std::cout<<"Geometry successfully loaded from: "<<"models/"<<normal<<std::endl;
+          //imported on the thread pool, renderScene swaps it in once it is ready
+          m_drawData->geoPutAsync("models/"+normal, normal.substr(0, normal.size()-4));
         }
         else
         {
@@ -483,10 +752,8 @@ void MainScene::loadFile()
         std::cout<<"Loading geometry from: "<<normal<<" ..."<<std::endl;
         if(fileExists("models/"+normal))
         {
-          Mesh* newMesh = new Mesh;
-          newMesh->load("models/"+normal);
-          m_drawData->geoPut(newMesh, normal.substr(0, normal.size()-4));
-          std::cout<<"Geometry successfully loaded from: "<<"models/"<<normal<<std::endl;
+          //imported on the thread pool, renderScene swaps it in once it is ready
+          m_drawData->geoPutAsync("models/"+normal, normal.substr(0, normal.size()-4));
         }
         else
         {
@@ -1,6 +1,8 @@
 #ifndef BASEMESH_H_
 #define BASEMESH_H_
 #include <string>
+#include <functional>
+#include <glm/vec3.hpp>
 //-------------------------------------------------------------------------------------------------------
 /// @author Renats Bikmajevs
 /// Modified from : --
@@ -11,6 +13,26 @@
 class BaseMesh
 {
 public:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Bounding volumes of a mesh, in the space its vertices are stored in
+  //-----------------------------------------------------------------------------------------------------
+  struct Bounds
+  {
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief Axis aligned box enclosing every vertex
+    //-----------------------------------------------------------------------------------------------------
+    glm::vec3 min = glm::vec3(0,0,0);
+    glm::vec3 max = glm::vec3(0,0,0);
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief Sphere enclosing every vertex, not necessarily centred on the box
+    //-----------------------------------------------------------------------------------------------------
+    glm::vec3 centre = glm::vec3(0,0,0);
+    float radius = 0.f;
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief True if the mesh has no vertices, the other values are then meaningless
+    //-----------------------------------------------------------------------------------------------------
+    bool empty = true;
+  };
   //-----------------------------------------------------------------------------------------------------
   /// @brief Default constructor.
   //-----------------------------------------------------------------------------------------------------
@@ -40,6 +62,13 @@ public:
   //-----------------------------------------------------------------------------------------------------
   virtual void load(const std::string &_fname)=0;
   //-----------------------------------------------------------------------------------------------------
+  /// @brief Used to load a mesh while reporting progress, may run on a worker thread
+  /// @param [in]_progress Called with the completed fraction (0 to 1), returning false aborts the load
+  /// @return false if the load failed or was aborted
+  /// @note The default implementation only reports the start and the end of load
+  //-----------------------------------------------------------------------------------------------------
+  virtual bool load(const std::string &_fname, const std::function<bool(float)> &_progress);
+  //-----------------------------------------------------------------------------------------------------
   /// @brief (Host)Used to reset mesh data values.
   //-----------------------------------------------------------------------------------------------------
   virtual void reset()=0;
@@ -61,6 +90,36 @@ public:
   /// @brief Get the currently stored name of this mesh object.
   //-----------------------------------------------------------------------------------------------------
   virtual size_t getID() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Get the file this mesh was last loaded from, empty if it was not loaded from a file.
+  //-----------------------------------------------------------------------------------------------------
+  virtual std::string getSource() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief (Host)Get the number of bytes of mesh data currently held in system memory.
+  //-----------------------------------------------------------------------------------------------------
+  virtual size_t residentBytes() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief (Host)Get the number of bytes of mesh data currently held in GPU buffers.
+  //-----------------------------------------------------------------------------------------------------
+  virtual size_t gpuBytes() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief (Host)Get a hash of the mesh data, 0 if unknown, meshes with equal hashes may share their data.
+  //-----------------------------------------------------------------------------------------------------
+  virtual size_t contentHash() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief (Host)Make this mesh use the data of another mesh with the same content hash.
+  /// @return false if the data could not be shared, the mesh must then be left unchanged
+  //-----------------------------------------------------------------------------------------------------
+  virtual bool shareStorage(const BaseMesh &_other);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief (Host)Get an identifier of the memory holding the mesh data, equal for meshes sharing it.
+  //-----------------------------------------------------------------------------------------------------
+  virtual const void* storageID() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief (Host)Get the bounding box and sphere of the mesh, computed on load.
+  /// @note The default implementation returns empty bounds
+  //-----------------------------------------------------------------------------------------------------
+  virtual Bounds getBounds() const;
 protected:
   //-----------------------------------------------------------------------------------------------------
   /// @brief The ID of this mesh object.
@@ -70,6 +129,10 @@ protected:
   /// @brief The name of this mesh object.
   //-----------------------------------------------------------------------------------------------------
   std::string m_name="";
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The file this mesh was last loaded from, set by the host's load.
+  //-----------------------------------------------------------------------------------------------------
+  std::string m_source="";
 };
 
 #endif //BASEMESH_H_
@@ -28,7 +28,8 @@ public :
     m_rot(_rot),
     m_scale(_sc),
     m_name(_name),
-    m_MVmatrix(1)
+    m_MVmatrix(1),
+    m_matrixStamp(nextMatrixStamp())
   {}
   //-----------------------------------------------------------------------------------------------------
   /// @brief Default virtual destructor.
@@ -75,6 +76,12 @@ public :
   //-----------------------------------------------------------------------------------------------------
   std::vector<BaseObject*> getChildren() const;
   //-----------------------------------------------------------------------------------------------------
+  /// @brief Makes the input object a child of this object without updating any matrices
+  /// @brief Meant for bulk building, the input must not have a parent yet and the caller updates matrices afterwards
+  /// @param [io]_child New child to assign to this object
+  //-----------------------------------------------------------------------------------------------------
+  void linkChild(BaseObject* _child);
+  //-----------------------------------------------------------------------------------------------------
   /// @brief Adds translation vector to the currently stored vector
   //-----------------------------------------------------------------------------------------------------
   void moveObject (const vec3 _tr);
@@ -121,15 +128,28 @@ public :
   //-----------------------------------------------------------------------------------------------------
   /// @brief Returns the active status of this object
   //-----------------------------------------------------------------------------------------------------
-  bool isActive();
+  bool isActive() const;
   //-----------------------------------------------------------------------------------------------------
   /// @brief Updates the local transformation matrix, also adds parent matrix
   //-----------------------------------------------------------------------------------------------------
   void updateMatrix();
   //-----------------------------------------------------------------------------------------------------
+  /// @brief Updates only the matrix of this object from the current parent matrix, children are left as they are
+  //-----------------------------------------------------------------------------------------------------
+  void updateLocalMatrix();
+  //-----------------------------------------------------------------------------------------------------
   /// @brief Returns the local transformation matrix stored in this object
   //-----------------------------------------------------------------------------------------------------
   mat4 getMVmatrix() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns a stamp that changes every time the transformation matrix is updated
+  /// @note Stamps are unique across all objects and never 0, so caches keyed on them never mix up objects
+  //-----------------------------------------------------------------------------------------------------
+  size_t getMatrixStamp() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the local transformation matrix for the specified position, rotation (degrees) and scale
+  //-----------------------------------------------------------------------------------------------------
+  static mat4 composeMatrix(const vec3 &_pos, const vec3 &_rot, const vec3 &_scale);
 protected :
   //-----------------------------------------------------------------------------------------------------
   /// @brief Translation/Position vector of this object
@@ -167,5 +187,14 @@ protected :
   /// @brief A local transformation matrix based on position, rotation and scale
   //-----------------------------------------------------------------------------------------------------
   mat4 m_MVmatrix {1};
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Stamp of the current transformation matrix, renewed by updateLocalMatrix
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_matrixStamp = 0;
+private :
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns a new matrix stamp, safe to call from several threads
+  //-----------------------------------------------------------------------------------------------------
+  static size_t nextMatrixStamp();
 };
 #endif //BASEMESH_H_
@@ -2,13 +2,22 @@
 #define DATACONTAINER_H_
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <functional>
 #include <unordered_map>
 #include "BaseMesh.h"
 #include "BaseMaterial.h"
+#include "IDAllocator.h"
 //-------------------------------------------------------------------------------------------------------
 /// @author Renats Bikmajevs
 /// Modified from : --
 /// @note A container for material and mesh data that also manages them.
+/// @note Lookups by ID or Name go through hash indices, so names and IDs of stored data must only be changed
+/// through the container (setGeoName, setMatName) to keep the indices valid.
+/// @note IDs and Names are unique within the container, a clashing ID is replaced with the lowest free one.
+/// @note Scene objects reference meshes and materials by ID through geoAddRef/matAddRef. With a mesh budget set,
+/// unreferenced and then least recently drawn meshes are evicted and reloaded from their source on next use.
+/// @note Meshes with identical content share one storage block, transparently to Name and ID queries.
 //-------------------------------------------------------------------------------------------------------
 class DataContainer
 {
@@ -18,9 +27,13 @@ public :
   //-----------------------------------------------------------------------------------------------------
   DataContainer()=default;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Default destructor.
+  /// @brief Destructor, cancels pending asynchronous loads
   //-----------------------------------------------------------------------------------------------------
-  ~DataContainer()=default;
+  ~DataContainer();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returned by geoPutAsync when nothing could be registered
+  //-----------------------------------------------------------------------------------------------------
+  static constexpr size_t s_invalidID = static_cast<size_t>(-1);
   //-----------------------------------------------------------------------------------------------------
   /// @brief Calls the update method of the material with the specified ID
   //-----------------------------------------------------------------------------------------------------
@@ -66,6 +79,104 @@ public :
   //-----------------------------------------------------------------------------------------------------
   void geoPut(BaseMesh* _new, const std::string _name);
   //-----------------------------------------------------------------------------------------------------
+  /// @brief Adds all specified Geometry pointers at once, storage is reserved once for the whole batch
+  /// @param [in]_names Custom names matched by position, missing or empty entries use the default name
+  //-----------------------------------------------------------------------------------------------------
+  void geoPutMany(const std::vector<BaseMesh*> &_new, const std::vector<std::string> &_names = {});
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Adds all specified Material pointers at once, storage is reserved once for the whole batch
+  /// @param [in]_names Custom names matched by position, missing or empty entries use the default name
+  //-----------------------------------------------------------------------------------------------------
+  void matPutMany(const std::vector<BaseMaterial*> &_new, const std::vector<std::string> &_names = {});
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Sets the function that creates empty meshes of the host's mesh type, needed by geoPutAsync
+  /// @note Called from worker threads, so it must not touch anything shared
+  //-----------------------------------------------------------------------------------------------------
+  void setGeoFactory(std::function<BaseMesh*()> _factory);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Registers an empty placeholder mesh right away and loads the file into a new mesh on the thread pool
+  /// @return ID of the placeholder, which keeps its ID and Name when the loaded mesh replaces it, s_invalidID if
+  /// no geometry factory is set
+  //-----------------------------------------------------------------------------------------------------
+  size_t geoPutAsync(const std::string &_path, const std::string &_name);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Swaps finished asynchronous loads in for their placeholders, must be called on the render thread
+  /// @note Placeholders of failed or cancelled first loads are removed, meshes whose reload failed are kept evicted
+  /// @return IDs of the meshes that were swapped in
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<size_t> geoPollAsync();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the completed fraction of the asynchronous load of the specified mesh, -1 if it is not loading
+  //-----------------------------------------------------------------------------------------------------
+  float geoAsyncProgress(const size_t _id) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Asks the asynchronous load of the specified mesh to stop, the next geoPollAsync removes its placeholder
+  /// unless the load was a reload
+  //-----------------------------------------------------------------------------------------------------
+  void geoCancelAsync(const size_t _id);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the number of asynchronous loads not yet swapped in or removed
+  //-----------------------------------------------------------------------------------------------------
+  size_t geoAsyncPending() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Adds a reference to the mesh ID, references are counted by ID whether a mesh with the ID is stored or not
+  //-----------------------------------------------------------------------------------------------------
+  void geoAddRef(const size_t _id);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Removes a reference to the mesh ID
+  //-----------------------------------------------------------------------------------------------------
+  void geoRelease(const size_t _id);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the number of references to the mesh ID
+  //-----------------------------------------------------------------------------------------------------
+  size_t geoRefCount(const size_t _id) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Adds a reference to the material ID, references are counted by ID whether a material with the ID is stored or not
+  //-----------------------------------------------------------------------------------------------------
+  void matAddRef(const size_t _id);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Removes a reference to the material ID
+  //-----------------------------------------------------------------------------------------------------
+  void matRelease(const size_t _id);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the number of references to the material ID
+  //-----------------------------------------------------------------------------------------------------
+  size_t matRefCount(const size_t _id) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the mesh with the specified ID for drawing, marking it as used this frame
+  /// @note An evicted mesh is returned empty and its reload is started, it is swapped back in by geoPollAsync
+  //-----------------------------------------------------------------------------------------------------
+  BaseMesh* geoUse(const size_t _id);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Sets the number of bytes meshes may keep in system and GPU memory together, 0 means no limit
+  /// @note Checked by geoPollAsync, only meshes loaded from a file can be evicted and a geometry factory is needed
+  //-----------------------------------------------------------------------------------------------------
+  void setGeoBudget(const size_t _bytes);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the mesh memory budget in bytes, 0 means no limit
+  //-----------------------------------------------------------------------------------------------------
+  size_t geoBudget() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the bytes held by the mesh with the specified ID, 0 if it is evicted or not found
+  //-----------------------------------------------------------------------------------------------------
+  size_t geoResidentBytes(const size_t _id) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the bytes held by all stored meshes, shared storage is counted once
+  //-----------------------------------------------------------------------------------------------------
+  size_t geoResidentBytes() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the bytes saved by meshes sharing storage with an identical mesh
+  //-----------------------------------------------------------------------------------------------------
+  size_t geoSharedBytes() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the bytes all stored meshes hold in GPU buffers, shared storage is counted once
+  //-----------------------------------------------------------------------------------------------------
+  size_t geoGpuBytes() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns true if the mesh with the specified ID is stored, loaded and not evicted
+  //-----------------------------------------------------------------------------------------------------
+  bool geoIsResident(const size_t _id) const;
+  //-----------------------------------------------------------------------------------------------------
   /// @brief Removes material with the specified Name, does nothing if not found
   //-----------------------------------------------------------------------------------------------------
   void matRemove(const std::string _name);
@@ -115,53 +226,97 @@ public :
   size_t getGeoID(const std::string &_name) const;
 private:
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Checks if there are meshes or materials that share the same IDs and replaces them with new IDs if found
+  /// @brief State of one asynchronous mesh load, shared with the worker running it
+  //-----------------------------------------------------------------------------------------------------
+  struct GeoJob
+  {
+    std::string path;
+    std::atomic<float> progress{0.f};
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> finished{false};
+    std::unique_ptr<BaseMesh> result; //written by the worker before finished is set, null if the load failed
+    bool reload = false; //loads an evicted mesh back in
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Usage of one mesh ID
+  //-----------------------------------------------------------------------------------------------------
+  struct GeoUse
+  {
+    size_t refs = 0;
+    size_t lastUse = 0; //use tick of the last draw
+    bool evicted = false;
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Starts loading the file into a new mesh that replaces the stored mesh with the specified ID when done
+  //-----------------------------------------------------------------------------------------------------
+  void startGeoLoad(const size_t _id, const std::string &_path, const bool _reload);
   //-----------------------------------------------------------------------------------------------------
-  void checkIDs();
+  /// @brief Makes the mesh share the storage of a stored mesh with the same content, or records it as the
+  /// mesh to share with for its content
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Checks if there are meshes that share the same IDs and replaces them with new IDs if found
+  void shareGeoStorage(BaseMesh* io_mesh);
   //-----------------------------------------------------------------------------------------------------
-  void checkGeoIDs();
+  /// @brief Evicts meshes until their system and GPU bytes fit the budget, skipping meshes drawn this frame
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Checks if there are materials that share the same IDs and replaces them with new IDs if found
+  void enforceGeoBudget();
   //-----------------------------------------------------------------------------------------------------
-  void checkMatIDs();
+  /// @brief Gives the mesh its final ID and Name and adds it to the indices, the ID is kept unless another
+  /// mesh already has it, a clashing name gets the ID appended
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Scans currenly stored meshes and returns an ID that is not in use
+  void registerGeo(BaseMesh* _new, const std::string &_name);
   //-----------------------------------------------------------------------------------------------------
-  size_t getFreeGeoID() const;
+  /// @brief Gives the material its final ID and Name and adds it to the indices, the ID is kept unless another
+  /// material already has it, a clashing name gets the ID appended
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Scans currenly stored materials and returns an ID that is not in use
+  void registerMat(BaseMaterial* _new, const std::string &_name);
+private :
   //-----------------------------------------------------------------------------------------------------
-  size_t getFreeMatID() const;
+  /// @brief A vector of geometry(mesh) data stored using pointers to the virtual interfaces
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Returns a vector of all stored geometry IDs
+  std::vector<std::unique_ptr<BaseMesh>> m_geo;
   //-----------------------------------------------------------------------------------------------------
-  std::vector<size_t> getCurrentGeoIDs()const;
+  /// @brief A vector of material data stored using pointers to the virtual interfaces
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Returns a vector of all stored material IDs
+  std::vector<std::unique_ptr<BaseMaterial>> m_mat;
   //-----------------------------------------------------------------------------------------------------
-  std::vector<size_t> getCurrentMatIDs()const;
+  /// @brief Geometry lookup indices by ID and by Name
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Checks if there are meshes or materials that share the same Names and replaces them with new Names if found
+  std::unordered_map<size_t, BaseMesh*> m_geoByID;
+  std::unordered_map<std::string, BaseMesh*> m_geoByName;
   //-----------------------------------------------------------------------------------------------------
-  void checkNames();
+  /// @brief Material lookup indices by ID and by Name
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Checks if there are materials that share the same Names and replaces them with new Names if found
+  std::unordered_map<size_t, BaseMaterial*> m_matByID;
+  std::unordered_map<std::string, BaseMaterial*> m_matByName;
   //-----------------------------------------------------------------------------------------------------
-  void checkMatNames();
+  /// @brief IDs in use by meshes and by materials
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Checks if there are meshes that share the same Names and replaces them with new Names if found
+  IDAllocator m_geoIDs;
+  IDAllocator m_matIDs;
   //-----------------------------------------------------------------------------------------------------
-  void checkGeoNames();
-private :
+  /// @brief Creates empty meshes for asynchronous loads
   //-----------------------------------------------------------------------------------------------------
-  /// @brief A vector of geometry(mesh) data stored using pointers to the virtual interfaces
+  std::function<BaseMesh*()> m_geoFactory;
   //-----------------------------------------------------------------------------------------------------
-  std::vector<std::unique_ptr<BaseMesh>> m_geo;
+  /// @brief Asynchronous loads by placeholder ID
   //-----------------------------------------------------------------------------------------------------
-  /// @brief A vector of material data stored using pointers to the virtual interfaces
+  std::unordered_map<size_t, std::shared_ptr<GeoJob>> m_geoJobs;
   //-----------------------------------------------------------------------------------------------------
-  std::vector<std::unique_ptr<BaseMaterial>> m_mat;
+  /// @brief Usage by mesh ID and reference counts by material ID
+  //-----------------------------------------------------------------------------------------------------
+  std::unordered_map<size_t, GeoUse> m_geoUse;
+  std::unordered_map<size_t, size_t> m_matRefs;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief ID of the mesh other meshes share storage with, by content hash
+  //-----------------------------------------------------------------------------------------------------
+  std::unordered_map<size_t, size_t> m_geoByHash;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Mesh memory budget in bytes, 0 means no limit
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_geoBudget = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Advanced by every geoPollAsync, used to order meshes by their last draw
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_useTick = 1;
 };
 #endif //DATACONTAINER_H_
@@ -0,0 +1,33 @@
+#ifndef FLOATCONVERSION_H_
+#define FLOATCONVERSION_H_
+#include <cstddef>
+#include <cstdint>
+//-------------------------------------------------------------------------------------------------------
+/// @author Renats Bikmajevs
+/// Modified from : Ulf Adams, Ryu: fast float-to-string conversion (PLDI 2018)
+/// @note Locale independent conversions between 32 bit floats and their shortest json text.
+/// @note Any float written by formatShortest is read back by parseFloat with exactly the same bits.
+//-------------------------------------------------------------------------------------------------------
+namespace FloatConversion
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Maximum number of characters formatShortest can write
+  //-----------------------------------------------------------------------------------------------------
+  constexpr size_t s_maxChars = 24;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Writes the shortest decimal text that reads back as the same float
+  /// @param [in]_val Value to format, infinities and NaN are written as null
+  /// @param [out]o_out Destination, must have room for s_maxChars characters, not null terminated
+  /// @return Number of characters written
+  //-----------------------------------------------------------------------------------------------------
+  size_t formatShortest(const float _val, char* o_out);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Parses a json number into the nearest float
+  /// @param [in]_begin First character of the number
+  /// @param [in]_end End of the available text
+  /// @param [out]o_val The parsed value, untouched if no number was found
+  /// @return Pointer past the last character of the number, _begin if there was no number
+  //-----------------------------------------------------------------------------------------------------
+  const char* parseFloat(const char* _begin, const char* _end, float &o_val);
+}
+#endif //FLOATCONVERSION_H_
@@ -0,0 +1,64 @@
+#ifndef IDALLOCATOR_H_
+#define IDALLOCATOR_H_
+#include <cstddef>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <unordered_set>
+//-------------------------------------------------------------------------------------------------------
+/// @author Renats Bikmajevs
+/// Modified from : --
+/// @note Hands out the lowest ID that is not in use, IDs can also be claimed explicitly.
+/// @note Fresh IDs cost O(1) amortized, reusing released IDs costs O(log n).
+//-------------------------------------------------------------------------------------------------------
+class IDAllocator
+{
+public:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Default constructor
+  //-----------------------------------------------------------------------------------------------------
+  IDAllocator()=default;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Default destructor
+  //-----------------------------------------------------------------------------------------------------
+  ~IDAllocator()=default;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns true if the specified ID is in use
+  //-----------------------------------------------------------------------------------------------------
+  bool isUsed(const size_t _id) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Marks the specified ID as used
+  /// @return false if it was already in use
+  //-----------------------------------------------------------------------------------------------------
+  bool claim(const size_t _id);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the lowest ID not in use and marks it as used
+  //-----------------------------------------------------------------------------------------------------
+  size_t allocate();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Marks the specified ID as free again
+  //-----------------------------------------------------------------------------------------------------
+  void release(const size_t _id);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Reserves room for the specified number of IDs in use
+  //-----------------------------------------------------------------------------------------------------
+  void reserve(const size_t _count);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Frees all IDs
+  //-----------------------------------------------------------------------------------------------------
+  void clear();
+private:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief All IDs in use
+  //-----------------------------------------------------------------------------------------------------
+  std::unordered_set<size_t> m_used;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Released IDs below m_next, smallest on top, may hold IDs that were claimed again since
+  //-----------------------------------------------------------------------------------------------------
+  std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> m_released;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Every ID below this one has been in use at some point
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_next=0;
+};
+#endif //IDALLOCATOR_H_
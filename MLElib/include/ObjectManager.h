@@ -2,6 +2,8 @@
 #define OBJECTMANAGER_H
 #include "SceneObject.h"
 #include "DataContainer.h"
+#include "SceneRecord.h"
+#include "SceneIndex.h"
 //-------------------------------------------------------------------------------------------------------
 /// @author Renats Bikmajevs
 /// Modified from : --
@@ -140,16 +142,61 @@ public:
   //-----------------------------------------------------------------------------------------------------
   size_t getObjectCount() const;
   //-----------------------------------------------------------------------------------------------------
+  /// @brief Attaches all current and future objects to the specified container, which then counts their mesh
+  /// and material references, nullptr detaches them
+  //-----------------------------------------------------------------------------------------------------
+  void setDataContainer(DataContainer* io_data);
+  //-----------------------------------------------------------------------------------------------------
   /// @brief Reads a json file with the specified name and loads all data into the scene
   /// @brief In the beginning autosaves using AutosavedScene.json name and resets the scene
   /// @brief Warning: this excludes mesh and material data
   //-----------------------------------------------------------------------------------------------------
   void loadRawSceneData(const std::string &_name);
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Writes all current scene data to json using the specified file name
+  /// @brief Writes all current scene data to json using the specified file name, streaming one object at a time
   /// @brief Warning: this excludes mesh and material data
   //-----------------------------------------------------------------------------------------------------
   void writeRawSceneData(const std::string &_name) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Reads a compressed scene archive with the specified name and loads all data into the scene
+  /// @brief Chunks are decompressed in parallel, otherwise behaves exactly like loadRawSceneData
+  //-----------------------------------------------------------------------------------------------------
+  void loadSceneArchive(const std::string &_name);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Writes all current scene data to a compressed scene archive using the specified file name
+  /// @param [in]_chunkSize Number of objects per independently compressed chunk
+  /// @brief Warning: this excludes mesh and material data
+  //-----------------------------------------------------------------------------------------------------
+  void writeSceneArchive(const std::string &_name, const size_t _chunkSize=4096) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Loads only the subtree of the specified root object out of a json scene file
+  /// @brief Uses the sidecar index (scenes/<name>.idx), which is built on first use, so only the records of
+  /// the subtree are parsed. Otherwise behaves exactly like loadRawSceneData
+  /// @param [in]_rootID ID of an object without a parent
+  //-----------------------------------------------------------------------------------------------------
+  void loadSubtree(const std::string &_name, const size_t _rootID);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Loads every root subtree whose world bounds overlap the specified box out of a json scene file
+  /// @brief Uses the sidecar index in the same way as loadSubtree
+  //-----------------------------------------------------------------------------------------------------
+  void loadRegion(const std::string &_name, const vec3 &_min, const vec3 &_max);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the world space bounds of the scene object at the specified position in the stored vector
+  /// @brief Bounds are cached per object and only recomputed when its matrix or its mesh bounds change
+  /// @note Empty if the object has no mesh, no data container is attached or the mesh has no vertices
+  //-----------------------------------------------------------------------------------------------------
+  const BaseMesh::Bounds& worldBoundsAt(size_t _pos) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the world space bounds of the scene object with the specified ID
+  /// @brief If object is not found returns empty bounds
+  //-----------------------------------------------------------------------------------------------------
+  BaseMesh::Bounds getWorldBounds(const size_t _id) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Transforms mesh bounds by the specified matrix
+  /// @note The box is the tightest axis aligned box around the transformed box (Arvo 1990), the sphere
+  /// radius is scaled by the largest axis scale so it stays enclosing under non uniform scale
+  //-----------------------------------------------------------------------------------------------------
+  static BaseMesh::Bounds transformBounds(const BaseMesh::Bounds &_local, const mat4 &_matrix);
 private:
   //-----------------------------------------------------------------------------------------------------
   /// @brief Checks if there are scene objects that share the same ID and replaces them with new IDs if found
@@ -163,6 +210,24 @@ private:
   /// @brief Returns a vector of all currently used IDs of scene objects
   //-----------------------------------------------------------------------------------------------------
   std::vector<size_t> getCurrentIDs()const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Autosaves the current scene using AutosavedScene.json name, then removes all objects
+  //-----------------------------------------------------------------------------------------------------
+  void resetForLoad();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Constructs scene objects from the loaded records, links their hierarchy and computes their matrices
+  /// @note Runs in stages so the whole build stays O(n): construct, ID to slot table, link parents, then update
+  /// every matrix once with parents ahead of their children
+  //-----------------------------------------------------------------------------------------------------
+  void buildFromRecords(const std::vector<SceneRecord> &_records);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Loads the sidecar index of the specified scene, rebuilding and saving it if missing or out of date
+  //-----------------------------------------------------------------------------------------------------
+  bool loadSceneIndex(const std::string &_name, SceneIndex &o_index) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Loads the records of the specified subtrees of a json scene file into the scene
+  //-----------------------------------------------------------------------------------------------------
+  void loadIndexedRoots(const std::string &_name, const std::vector<const SceneIndex::Root*> &_roots);
 private:
   //-----------------------------------------------------------------------------------------------------
   /// @brief A vector of pointers to all currently stored scene objects
@@ -172,5 +237,24 @@ private:
   /// @brief A vector of selected object IDs
   //-----------------------------------------------------------------------------------------------------
   std::vector<size_t> m_selected;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The container new objects are attached to, not owned
+  //-----------------------------------------------------------------------------------------------------
+  DataContainer* m_data = nullptr;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Cached world bounds of one scene object, valid while the object, its matrix stamp and its
+  /// mesh bounds are the ones they were computed from
+  //-----------------------------------------------------------------------------------------------------
+  struct WorldBoundsEntry
+  {
+    const SceneObject* object = nullptr;
+    size_t stamp = 0;
+    BaseMesh::Bounds local;
+    BaseMesh::Bounds world;
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief World bounds cache, parallel to m_sceneObjects and resized on lookup
+  //-----------------------------------------------------------------------------------------------------
+  mutable std::vector<WorldBoundsEntry> m_worldBounds;
 };
 #endif //OBJECTMANAGER_H_
@@ -0,0 +1,50 @@
+#ifndef SCENEARCHIVEFORMAT_H_
+#define SCENEARCHIVEFORMAT_H_
+#include <QtGlobal>
+//-------------------------------------------------------------------------------------------------------
+/// @author Renats Bikmajevs
+/// Modified from : --
+/// @note Layout shared by SceneArchiveWriter and SceneArchiveReader, all integers are little endian.
+/// @note [header : magic, version] [chunk 0] ... [chunk n-1] [index : count, n entries] [footer : index offset, magic]
+/// @note Every chunk is a complete json scene document compressed on its own with qCompress (zlib), so any
+/// chunk can be decompressed without touching the others.
+//-------------------------------------------------------------------------------------------------------
+namespace SceneArchiveFormat
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Magic at the start of the file and at the end of the footer
+  //-----------------------------------------------------------------------------------------------------
+  constexpr char s_headerMagic[4] = {'M','L','E','A'};
+  constexpr char s_footerMagic[4] = {'M','L','E','I'};
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Format version, bumped whenever the layout changes
+  //-----------------------------------------------------------------------------------------------------
+  constexpr quint32 s_version = 1;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Sizes in bytes of the header, footer and a single index entry
+  //-----------------------------------------------------------------------------------------------------
+  constexpr size_t s_headerSize = 8;
+  constexpr size_t s_footerSize = 12;
+  constexpr size_t s_entrySize = 32;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Index entry describing one chunk
+  //-----------------------------------------------------------------------------------------------------
+  struct Chunk
+  {
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief Byte offset and compressed size of the chunk in the file
+    //-----------------------------------------------------------------------------------------------------
+    quint64 offset = 0;
+    quint32 size = 0;
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief Number of scene objects stored in the chunk
+    //-----------------------------------------------------------------------------------------------------
+    quint32 objectCount = 0;
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief Smallest and largest object ID stored in the chunk, so chunks can be picked by ID
+    //-----------------------------------------------------------------------------------------------------
+    quint64 minID = 0;
+    quint64 maxID = 0;
+  };
+}
+#endif //SCENEARCHIVEFORMAT_H_
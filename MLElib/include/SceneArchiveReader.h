@@ -0,0 +1,79 @@
+#ifndef SCENEARCHIVEREADER_H_
+#define SCENEARCHIVEREADER_H_
+#include <string>
+#include <vector>
+#include <QFile>
+#include "SceneRecord.h"
+#include "SceneArchiveFormat.h"
+//-------------------------------------------------------------------------------------------------------
+/// @author Renats Bikmajevs
+/// Modified from : --
+/// @note Reads scene objects back from a scene archive written by SceneArchiveWriter.
+/// @note Opening only reads the header and the chunk index, the file is memory mapped so chunks that are
+/// never requested are never read from disk. Several chunks are decompressed in parallel on the ThreadPool.
+//-------------------------------------------------------------------------------------------------------
+class SceneArchiveReader
+{
+public:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Default constructor
+  //-----------------------------------------------------------------------------------------------------
+  SceneArchiveReader()=default;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Destructor, unmaps and closes the file if it is still open
+  //-----------------------------------------------------------------------------------------------------
+  ~SceneArchiveReader();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Opens and maps the specified archive and reads its chunk index
+  /// @return false if the file could not be opened or is not a valid archive
+  //-----------------------------------------------------------------------------------------------------
+  bool open(const std::string &_fileName);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Unmaps and closes the file
+  //-----------------------------------------------------------------------------------------------------
+  void close();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the number of chunks in the archive
+  //-----------------------------------------------------------------------------------------------------
+  size_t chunkCount() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the index entry of the chunk at the specified position
+  //-----------------------------------------------------------------------------------------------------
+  const SceneArchiveFormat::Chunk& chunk(const size_t _pos) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the positions of all chunks whose ID range contains the specified object ID
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<size_t> chunksWithID(const size_t _id) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Decompresses a single chunk and appends its records
+  /// @return false if the chunk is damaged, io_records is left as it was
+  //-----------------------------------------------------------------------------------------------------
+  bool readChunk(const size_t _pos, std::vector<SceneRecord> &io_records) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Decompresses the specified chunks in parallel and appends their records in the given order
+  /// @return false if any chunk is damaged, io_records is left as it was
+  //-----------------------------------------------------------------------------------------------------
+  bool readChunks(const std::vector<size_t> &_chunks, std::vector<SceneRecord> &io_records) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Decompresses every chunk in parallel and appends all records in file order
+  //-----------------------------------------------------------------------------------------------------
+  bool readAll(std::vector<SceneRecord> &io_records) const;
+private:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The mapped archive file
+  //-----------------------------------------------------------------------------------------------------
+  QFile m_file;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Start of the file mapping, nullptr if nothing is mapped
+  //-----------------------------------------------------------------------------------------------------
+  uchar* m_map = nullptr;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Size of the mapping
+  //-----------------------------------------------------------------------------------------------------
+  quint64 m_size = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The chunk index
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<SceneArchiveFormat::Chunk> m_chunks;
+};
+#endif //SCENEARCHIVEREADER_H_
@@ -1,87 +1,86 @@
-#ifndef BASEMATERIAL_H_
-#define BASEMATERIAL_H_
+#ifndef SCENEARCHIVEWRITER_H_
+#define SCENEARCHIVEWRITER_H_
 #include <string>
-#include <utility>
+#include <vector>
+#include <QFile>
+#include <QBuffer>
+#include "SceneWriter.h"
+#include "SceneArchiveFormat.h"
 //-------------------------------------------------------------------------------------------------------
 /// @author Renats Bikmajevs
 /// Modified from : --
-/// @note This is a virtual interface class for material operations.
-/// @note Most of the functions are either virtual with no implementaion ar pure virtual.
-/// @note Some of the functions were influenced by the host, although they still are not implemented.
+/// @note Streams scene objects into a compressed, chunked scene archive (see SceneArchiveFormat.h).
+/// @note Objects are grouped into chunks of a fixed object count, each chunk is compressed and written as
+/// soon as it is full, the chunk index is written by close().
 //-------------------------------------------------------------------------------------------------------
-class BaseMaterial
+class SceneArchiveWriter
 {
 public:
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Default constructor.
+  /// @brief Default number of objects per chunk
   //-----------------------------------------------------------------------------------------------------
-  BaseMaterial()=default;
+  static constexpr size_t s_defaultChunkSize = 4096;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Default copy constructor.
+  /// @brief Default constructor
   //-----------------------------------------------------------------------------------------------------
-  BaseMaterial(const BaseMaterial&) = default;
+  SceneArchiveWriter()=default;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Default copy assignment operator.
+  /// @brief Destructor, closes the archive if it is still open
   //-----------------------------------------------------------------------------------------------------
-  BaseMaterial& operator=(const BaseMaterial&) = default;
+  ~SceneArchiveWriter();
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Default move constructor.
+  /// @brief Opens (truncates) the specified file and writes the archive header
+  /// @param [in]_fileName Full path of the file to write to
+  /// @param [in]_chunkSize Number of objects per chunk, smaller chunks allow finer partial loads
+  /// @return false if the file could not be opened
   //-----------------------------------------------------------------------------------------------------
-  BaseMaterial(BaseMaterial&&) = default;
+  bool open(const std::string &_fileName, const size_t _chunkSize=s_defaultChunkSize);
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Default move assignment operator.
+  /// @brief Appends a single scene object to the current chunk
   //-----------------------------------------------------------------------------------------------------
-  BaseMaterial& operator=(BaseMaterial&&) = default;
+  void writeObject(const SceneObject &_obj);
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Default virtual destructor.
+  /// @brief Appends a single scene record to the current chunk
   //-----------------------------------------------------------------------------------------------------
-  virtual ~BaseMaterial()=default;
+  void writeRecord(const SceneRecord &_record);
   //-----------------------------------------------------------------------------------------------------
-  /// @brief (Host)Used to intialise a passed shader, subclasses must call this base function.
+  /// @brief Writes the last chunk, the chunk index and the footer, then closes the file
+  /// @return false if any write failed
   //-----------------------------------------------------------------------------------------------------
-  virtual void init()=0;
+  bool close();
+private:
   //-----------------------------------------------------------------------------------------------------
-  /// @brief (Host)Used to update shader values.
+  /// @brief Compresses the current chunk and appends it to the file
   //-----------------------------------------------------------------------------------------------------
-  virtual void update()=0;
+  void writeChunk();
   //-----------------------------------------------------------------------------------------------------
-  /// @brief (Host)Used to set this as the active shader, and pass the uniform values stored in this material.
+  /// @brief The output file
   //-----------------------------------------------------------------------------------------------------
-  virtual void apply();
+  QFile m_file;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief (Host)The file name of the json shader file that this material works with.
+  /// @brief Uncompressed text of the current chunk and the device the chunk writer writes it through
   //-----------------------------------------------------------------------------------------------------
-  virtual const char* shaderFileName() const = 0;
+  QByteArray m_text;
+  QBuffer m_textDevice;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief (Host)Sets the file name of the json shader file that this material works with.
+  /// @brief Formats the records of the current chunk
   //-----------------------------------------------------------------------------------------------------
-  virtual void setShaderName(const std::string &_name);
+  SceneWriter m_chunkWriter;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Sets the name of this material object.
+  /// @brief Index entries of all chunks written so far, the last one is the current chunk
   //-----------------------------------------------------------------------------------------------------
-  virtual void setName(std::string _new);
+  std::vector<SceneArchiveFormat::Chunk> m_chunks;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Returns the name of this material object.
+  /// @brief Record reused by writeObject so its strings keep their capacity
   //-----------------------------------------------------------------------------------------------------
-  virtual std::string getName() const;
+  SceneRecord m_record;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Sets the ID of this material object.
+  /// @brief Number of objects per chunk
   //-----------------------------------------------------------------------------------------------------
-  virtual void setID(size_t _new);
+  size_t m_chunkSize=s_defaultChunkSize;
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Gets the ID of this material object.
+  /// @brief Set when a write to the file came up short
   //-----------------------------------------------------------------------------------------------------
-  virtual size_t getID() const;
-protected:
-  //-----------------------------------------------------------------------------------------------------
-  /// @brief The ID of this material object.
-  //-----------------------------------------------------------------------------------------------------
-  size_t m_id=0;
-  //-----------------------------------------------------------------------------------------------------
-  /// @brief The name of this material object.
-  //-----------------------------------------------------------------------------------------------------
-  std::string m_name="";
-
+  bool m_failed=false;
 };
-
-#endif //BASEMATERIAL_H_
+#endif //SCENEARCHIVEWRITER_H_
@@ -0,0 +1,107 @@
+#ifndef SCENEINDEX_H_
+#define SCENEINDEX_H_
+#include <string>
+#include <vector>
+#include <utility>
+#include <QtGlobal>
+#include <glm/vec3.hpp>
+//-------------------------------------------------------------------------------------------------------
+/// @author Renats Bikmajevs
+/// Modified from : --
+/// @note Sidecar index of a json scene file, one entry per root subtree (a root object and all of its
+/// descendants), holding the byte ranges of the subtree's objects in the scene file and its world bounds.
+/// @note With the index a single subtree or region can be read straight out of a mapped scene file without
+/// parsing anything else. Bounds enclose the world space origins of the objects in the subtree.
+//-------------------------------------------------------------------------------------------------------
+class SceneIndex
+{
+public:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Index entry of one root subtree
+  //-----------------------------------------------------------------------------------------------------
+  struct Root
+  {
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief ID of the root object
+    //-----------------------------------------------------------------------------------------------------
+    size_t id = 0;
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief World space bounds of the subtree
+    //-----------------------------------------------------------------------------------------------------
+    glm::vec3 min = glm::vec3(0,0,0);
+    glm::vec3 max = glm::vec3(0,0,0);
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief Byte ranges of the subtree's objects in the scene file, in file order, neighbouring objects merged
+    //-----------------------------------------------------------------------------------------------------
+    std::vector<std::pair<size_t, size_t>> spans;
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Identifies a version of the scene file, an index is only used for the version it was built from
+  //-----------------------------------------------------------------------------------------------------
+  struct Stamp
+  {
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief Size of the file in bytes
+    //-----------------------------------------------------------------------------------------------------
+    quint64 size = 0;
+    //-----------------------------------------------------------------------------------------------------
+    /// @brief Last modification time of the file, in milliseconds since the epoch
+    //-----------------------------------------------------------------------------------------------------
+    qint64 modified = 0;
+    bool operator==(const Stamp &_other) const { return size == _other.size && modified == _other.modified; }
+    bool operator!=(const Stamp &_other) const { return !(*this == _other); }
+  };
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Default constructor
+  //-----------------------------------------------------------------------------------------------------
+  SceneIndex()=default;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Default destructor
+  //-----------------------------------------------------------------------------------------------------
+  ~SceneIndex()=default;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Scans the specified scene file once and builds the index for it
+  /// @return false if the scene file could not be read
+  //-----------------------------------------------------------------------------------------------------
+  bool build(const std::string &_sceneFile);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Writes the index to the specified file
+  //-----------------------------------------------------------------------------------------------------
+  bool save(const std::string &_indexFile) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Reads an index written by save
+  /// @param [in]_scene Current stamp of the indexed scene file, an index built from any other version is rejected
+  /// @return false if the file is missing, damaged or out of date
+  //-----------------------------------------------------------------------------------------------------
+  bool load(const std::string &_indexFile, const Stamp &_scene);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the entry of the subtree with the specified root ID, nullptr if there is none
+  //-----------------------------------------------------------------------------------------------------
+  const Root* findRoot(const size_t _id) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the entries of all subtrees whose bounds overlap the specified box
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<const Root*> findRegion(const glm::vec3 &_min, const glm::vec3 &_max) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns all subtree entries
+  //-----------------------------------------------------------------------------------------------------
+  const std::vector<Root>& roots() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the stamp of the scene file when the index was built
+  //-----------------------------------------------------------------------------------------------------
+  Stamp sceneStamp() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the current stamp of the specified file, size and modification time are 0 if it is missing
+  //-----------------------------------------------------------------------------------------------------
+  static Stamp stamp(const std::string &_fileName);
+private:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief All root subtrees, in the file order of their first object
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<Root> m_roots;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Stamp of the scene file when the index was built
+  //-----------------------------------------------------------------------------------------------------
+  Stamp m_scene;
+};
+#endif //SCENEINDEX_H_
@@ -6,6 +6,8 @@
 /// @author Renats Bikmajevs
 /// Modified from : --
 /// @note Inherited from BaseObject, this class is the main scene object representation
+/// @note Once attached to a DataContainer the object holds a reference to its mesh and material IDs there,
+/// the container must outlive the object
 //-------------------------------------------------------------------------------------------------------
 class SceneObject : public BaseObject
 {
@@ -37,9 +39,18 @@ public :
     m_material(_mat.first, _mat.second)
   {}
   //-----------------------------------------------------------------------------------------------------
-  /// @brief Default virtual destructor.
+  /// @brief Virtual destructor, releases the references held in the attached container.
   //-----------------------------------------------------------------------------------------------------
-  ~SceneObject() override = default;
+  ~SceneObject() override;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Copying would duplicate the references held in the attached container
+  //-----------------------------------------------------------------------------------------------------
+  SceneObject(const SceneObject&)=delete;
+  SceneObject& operator=(const SceneObject&)=delete;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Moves the references to the current mesh and material from the attached container to the specified one
+  //-----------------------------------------------------------------------------------------------------
+  void setDataContainer(DataContainer* io_data);
   //-----------------------------------------------------------------------------------------------------
   /// @brief Resets all members of this object to their default values
   //-----------------------------------------------------------------------------------------------------
@@ -85,5 +96,9 @@ private :
   /// @brief A pair of linked Material ID and Name
   //-----------------------------------------------------------------------------------------------------
   std::pair<size_t, std::string> m_material = {1, "Material1"};
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The container holding the referenced mesh and material, not owned
+  //-----------------------------------------------------------------------------------------------------
+  DataContainer* m_data = nullptr;
 };
 #endif //SCENEOBJECT_H_
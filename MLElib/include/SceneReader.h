@@ -0,0 +1,88 @@
+#ifndef SCENEREADER_H_
+#define SCENEREADER_H_
+#include <string>
+#include <vector>
+#include <utility>
+#include <QFile>
+#include "SceneRecord.h"
+//-------------------------------------------------------------------------------------------------------
+/// @author Renats Bikmajevs
+/// Modified from : --
+/// @note Reads scene objects from a json scene file one at a time, in file order.
+/// @note The file is memory mapped and parsed in place, floats go through FloatConversion::parseFloat
+/// so values written by SceneWriter come back bit for bit.
+//-------------------------------------------------------------------------------------------------------
+class SceneReader
+{
+public:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Default constructor
+  //-----------------------------------------------------------------------------------------------------
+  SceneReader()=default;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Destructor, unmaps and closes the file if it is still open
+  //-----------------------------------------------------------------------------------------------------
+  ~SceneReader();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Opens and maps the specified file, then reads past the opening of the scene document
+  /// @param [in]_fileName Full path of the file to read
+  /// @return false if the file could not be opened or is not a scene document
+  //-----------------------------------------------------------------------------------------------------
+  bool open(const std::string &_fileName);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Reads a scene document that is already in memory, the text must outlive the reader
+  /// @return false if the text is not a scene document
+  //-----------------------------------------------------------------------------------------------------
+  bool open(const char* _begin, const char* _end);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Reads the next scene object in the file
+  /// @param [out]o_record Record to fill, string members keep their capacity
+  /// @return false at the end of the document or on a parse error
+  //-----------------------------------------------------------------------------------------------------
+  bool next(SceneRecord &o_record);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the byte range of the object last read by next, from its opening to past its closing brace
+  //-----------------------------------------------------------------------------------------------------
+  std::pair<size_t, size_t> recordSpan() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Reads the objects in a byte range of the open document, without touching the rest of the text
+  /// @param [in]_begin Start of the first object, as returned by recordSpan
+  /// @param [in]_end End of the last object, any objects in between are read as well
+  /// @param [out]io_records Records are appended
+  /// @return false if the range does not hold a sequence of scene objects
+  //-----------------------------------------------------------------------------------------------------
+  bool readSpan(const size_t _begin, const size_t _end, std::vector<SceneRecord> &io_records) const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Unmaps and closes the file
+  //-----------------------------------------------------------------------------------------------------
+  void close();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Parses the text of a single scene object, from its opening to its closing brace
+  /// @return false on a parse error
+  //-----------------------------------------------------------------------------------------------------
+  static bool parseRecord(const char* _begin, const char* _end, SceneRecord &o_record);
+private:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The mapped input file
+  //-----------------------------------------------------------------------------------------------------
+  QFile m_file;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Start of the file mapping, nullptr if nothing is mapped or the text was given to open
+  //-----------------------------------------------------------------------------------------------------
+  uchar* m_map = nullptr;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Start, current read position and end of the text
+  //-----------------------------------------------------------------------------------------------------
+  const char* m_begin = nullptr;
+  const char* m_it = nullptr;
+  const char* m_end = nullptr;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Set once the closing brace of the document has been read, or on a parse error
+  //-----------------------------------------------------------------------------------------------------
+  bool m_done = true;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Byte range of the object last read by next
+  //-----------------------------------------------------------------------------------------------------
+  std::pair<size_t, size_t> m_span = {0, 0};
+};
+#endif //SCENEREADER_H_
@@ -0,0 +1,80 @@
+#ifndef SCENERECORD_H_
+#define SCENERECORD_H_
+#include <string>
+#include <utility>
+#include "SceneObject.h"
+//-------------------------------------------------------------------------------------------------------
+/// @author Renats Bikmajevs
+/// Modified from : --
+/// @note Plain copy of everything a scene file stores about one scene object.
+/// @note Used as the exchange format between ObjectManager and the scene readers and writers.
+//-------------------------------------------------------------------------------------------------------
+struct SceneRecord
+{
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Fills all members from the specified scene object, reusing string capacity
+  //-----------------------------------------------------------------------------------------------------
+  void fromObject(const SceneObject &_obj)
+  {
+    name = _obj.getName();
+    id = _obj.getID();
+    active = _obj.isActive();
+    position = _obj.getPosition();
+    rotation = _obj.getRotation();
+    scale = _obj.getScale();
+    hasParent = _obj.getParent() != nullptr;
+    parent = hasParent ? _obj.getParent()->getID() : 0;
+    geo.first = _obj.getGeoID();
+    geo.second = _obj.getGeoName();
+    mat.first = _obj.getMatID();
+    mat.second = _obj.getMatName();
+  }
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Sets all members back to their defaults, reusing string capacity
+  //-----------------------------------------------------------------------------------------------------
+  void reset()
+  {
+    const SceneRecord defaults;
+    name = defaults.name;
+    id = defaults.id;
+    active = defaults.active;
+    position = defaults.position;
+    rotation = defaults.rotation;
+    scale = defaults.scale;
+    hasParent = defaults.hasParent;
+    parent = defaults.parent;
+    geo.first = defaults.geo.first;
+    geo.second = defaults.geo.second;
+    mat.first = defaults.mat.first;
+    mat.second = defaults.mat.second;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Name of the object
+  //-----------------------------------------------------------------------------------------------------
+  std::string name = "SceneObject";
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief ID of the object
+  //-----------------------------------------------------------------------------------------------------
+  size_t id = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Active/Visibility status
+  //-----------------------------------------------------------------------------------------------------
+  bool active = true;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Local position, rotation (angle-axis) and scale
+  //-----------------------------------------------------------------------------------------------------
+  vec3 position = vec3(0,0,0);
+  vec3 rotation = vec3(0,0,0);
+  vec3 scale = vec3(1,1,1);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief True if the object has a parent, parent then holds the ID of the parent object
+  //-----------------------------------------------------------------------------------------------------
+  bool hasParent = false;
+  size_t parent = 0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Linked geometry and material ID-Name pairs
+  //-----------------------------------------------------------------------------------------------------
+  std::pair<size_t, std::string> geo = {1, "Mesh1"};
+  std::pair<size_t, std::string> mat = {1, "Material1"};
+};
+#endif //SCENERECORD_H_
@@ -0,0 +1,121 @@
+#ifndef SCENEWRITER_H_
+#define SCENEWRITER_H_
+#include <string>
+#include <array>
+#include <QFile>
+#include "SceneRecord.h"
+//-------------------------------------------------------------------------------------------------------
+/// @author Renats Bikmajevs
+/// Modified from : --
+/// @note Streams scene objects to a json file one at a time, in storage order.
+/// @note Produces the same schema as QJsonDocument, but never holds more than one write buffer in memory,
+/// so there is no upper limit on the scene size.
+/// @note By default floats are written as the shortest text that reads back as the same float, which is
+/// what the scene data actually holds, FLOAT64 keeps the longer double precision output of QJsonDocument.
+//-------------------------------------------------------------------------------------------------------
+class SceneWriter
+{
+public:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Precision used when writing float values
+  //-----------------------------------------------------------------------------------------------------
+  enum FloatMode {FLOAT32, FLOAT64};
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Default constructor
+  //-----------------------------------------------------------------------------------------------------
+  SceneWriter()=default;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Destructor, closes the file if it is still open
+  //-----------------------------------------------------------------------------------------------------
+  ~SceneWriter();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Opens (truncates) the specified file and writes the opening of the scene document
+  /// @param [in]_fileName Full path of the file to write to
+  /// @return false if the file could not be opened
+  //-----------------------------------------------------------------------------------------------------
+  bool open(const std::string &_fileName);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Writes the scene document to an already opened device, which close() leaves open
+  /// @param [in]_device Device to write to, must outlive the writer or the next call to close()
+  //-----------------------------------------------------------------------------------------------------
+  void open(QIODevice* _device);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Appends a single scene object to the document, keyed "Object"+number of objects written so far
+  //-----------------------------------------------------------------------------------------------------
+  void writeObject(const SceneObject &_obj);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Appends a single scene record to the document, keyed the same way as writeObject
+  //-----------------------------------------------------------------------------------------------------
+  void writeRecord(const SceneRecord &_record);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Writes the closing of the scene document, flushes the buffer and closes the file if the writer opened it
+  //-----------------------------------------------------------------------------------------------------
+  void close();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the number of objects written since the file was opened
+  //-----------------------------------------------------------------------------------------------------
+  size_t objectCount() const;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Sets the precision used for float values written from now on
+  //-----------------------------------------------------------------------------------------------------
+  void setFloatMode(const FloatMode _mode);
+private:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Writes the buffered text to the file and clears the buffer, keeping its capacity
+  //-----------------------------------------------------------------------------------------------------
+  void flush();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Appends an indented key, including the colon
+  //-----------------------------------------------------------------------------------------------------
+  void appendKey(const char* _key);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Appends a quoted and escaped json string
+  //-----------------------------------------------------------------------------------------------------
+  void appendString(const std::string &_str);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Appends an unsigned integer value
+  //-----------------------------------------------------------------------------------------------------
+  void appendInt(size_t _val);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Appends a float value in the current float mode
+  //-----------------------------------------------------------------------------------------------------
+  void appendFloat(float _val);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Appends a vector as a json array of three values
+  //-----------------------------------------------------------------------------------------------------
+  void appendVector(const vec3 &_vec);
+private:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Size at which the write buffer is flushed to the file
+  //-----------------------------------------------------------------------------------------------------
+  static constexpr size_t s_flushSize = 1<<16;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The output file
+  //-----------------------------------------------------------------------------------------------------
+  QFile m_file;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Device currently written to, either m_file or a device given to open, nullptr when closed
+  //-----------------------------------------------------------------------------------------------------
+  QIODevice* m_device=nullptr;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Write buffer, reused between flushes
+  //-----------------------------------------------------------------------------------------------------
+  std::string m_buffer;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Scratch space for number formatting
+  //-----------------------------------------------------------------------------------------------------
+  std::array<char, 32> m_format;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Record reused by writeObject so its strings keep their capacity
+  //-----------------------------------------------------------------------------------------------------
+  SceneRecord m_record;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Precision used for float values
+  //-----------------------------------------------------------------------------------------------------
+  FloatMode m_floatMode=FLOAT32;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Number of objects written since the file was opened
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_count=0;
+};
+#endif //SCENEWRITER_H_
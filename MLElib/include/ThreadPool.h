@@ -0,0 +1,87 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+//-------------------------------------------------------------------------------------------------------
+/// @author Renats Bikmajevs
+/// Modified from : --
+/// @note A fixed set of worker threads that run queued tasks in submission order.
+/// @note Used by the library for any work that splits into independent pieces (decompression, parsing).
+//-------------------------------------------------------------------------------------------------------
+class ThreadPool
+{
+public:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Constructor, starts the worker threads
+  /// @param [in]_threads Number of workers, 0 uses one per hardware thread
+  //-----------------------------------------------------------------------------------------------------
+  explicit ThreadPool(size_t _threads=0);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Destructor, finishes all queued tasks and joins the workers
+  //-----------------------------------------------------------------------------------------------------
+  ~ThreadPool();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Copying a pool makes no sense, the workers belong to exactly one pool
+  //-----------------------------------------------------------------------------------------------------
+  ThreadPool(const ThreadPool&)=delete;
+  ThreadPool& operator=(const ThreadPool&)=delete;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the pool shared by the whole library, created on first use
+  //-----------------------------------------------------------------------------------------------------
+  static ThreadPool& instance();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Queues a task to be run by one of the workers
+  //-----------------------------------------------------------------------------------------------------
+  void submit(std::function<void()> _task);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Blocks until every task submitted so far has finished
+  //-----------------------------------------------------------------------------------------------------
+  void wait();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Splits [0, _count) into contiguous ranges and runs _body on each, the calling thread helps
+  /// @param [in]_count Number of items
+  /// @param [in]_body Called with the begin and end of a range, ranges never overlap
+  /// @param [in]_minRange Smallest range worth handing to a worker
+  /// @note Blocks until all ranges are done, safe to call from inside a pool task
+  //-----------------------------------------------------------------------------------------------------
+  void parallelFor(const size_t _count, const std::function<void(size_t, size_t)> &_body, const size_t _minRange=1);
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Returns the number of worker threads
+  //-----------------------------------------------------------------------------------------------------
+  size_t threadCount() const;
+private:
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Worker loop, runs tasks until the pool is destroyed
+  //-----------------------------------------------------------------------------------------------------
+  void work();
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief The worker threads
+  //-----------------------------------------------------------------------------------------------------
+  std::vector<std::thread> m_workers;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Tasks waiting for a worker
+  //-----------------------------------------------------------------------------------------------------
+  std::queue<std::function<void()>> m_tasks;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Guards the task queue and counters
+  //-----------------------------------------------------------------------------------------------------
+  std::mutex m_mutex;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Signalled when a task is queued, and when the last running task finishes
+  //-----------------------------------------------------------------------------------------------------
+  std::condition_variable m_taskReady;
+  std::condition_variable m_allDone;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Number of tasks queued or running
+  //-----------------------------------------------------------------------------------------------------
+  size_t m_pending=0;
+  //-----------------------------------------------------------------------------------------------------
+  /// @brief Set by the destructor to stop the workers
+  //-----------------------------------------------------------------------------------------------------
+  bool m_stop=false;
+};
+#endif //THREADPOOL_H_
@@ -1,5 +1,13 @@
 #include "BaseMesh.h"
 //-----------------------------------------------------------------------------------------------------
+bool BaseMesh::load(const std::string &_fname, const std::function<bool(float)> &_progress)
+{
+  if(!_progress(0.f))
+    return false;
+  load(_fname);
+  return _progress(1.f);
+}
+//-----------------------------------------------------------------------------------------------------
 void BaseMesh::setName(std::string _new)
 {
   m_name = _new;
@@ -20,3 +28,38 @@ size_t BaseMesh::getID() const
   return m_id;
 }
 //-----------------------------------------------------------------------------------------------------
+std::string BaseMesh::getSource() const
+{
+  return m_source;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t BaseMesh::residentBytes() const
+{
+  return 0;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t BaseMesh::gpuBytes() const
+{
+  return 0;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t BaseMesh::contentHash() const
+{
+  return 0;
+}
+//-----------------------------------------------------------------------------------------------------
+bool BaseMesh::shareStorage(const BaseMesh &)
+{
+  return false;
+}
+//-----------------------------------------------------------------------------------------------------
+const void* BaseMesh::storageID() const
+{
+  return this;
+}
+//-----------------------------------------------------------------------------------------------------
+BaseMesh::Bounds BaseMesh::getBounds() const
+{
+  return Bounds();
+}
+//-----------------------------------------------------------------------------------------------------
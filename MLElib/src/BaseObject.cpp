@@ -1,4 +1,5 @@
 #include "BaseObject.h"
+#include <atomic>
 //-----------------------------------------------------------------------------------------------------
 void BaseObject::changeID(const size_t _newID)
 {
@@ -60,6 +61,12 @@ std::vector<BaseObject*> BaseObject::getChildren() const
   return m_children;
 }
 //-----------------------------------------------------------------------------------------------------
+void BaseObject::linkChild(BaseObject* _child)
+{
+  _child->m_parent = this;
+  m_children.push_back(_child);
+}
+//-----------------------------------------------------------------------------------------------------
 void BaseObject::moveObject (const vec3 _tr)
 {
   m_pos += _tr;
@@ -116,37 +123,36 @@ void BaseObject::setActive(bool _new)
   m_isActive = _new;
 }
 //-----------------------------------------------------------------------------------------------------
-bool BaseObject::isActive()
+bool BaseObject::isActive() const
 {
   return m_isActive;
 }
 //-----------------------------------------------------------------------------------------------------
 void BaseObject::updateMatrix()
 {
-  m_MVmatrix = glm::mat4();
-    if(m_parent==nullptr)
-    {
-      m_MVmatrix = glm::translate(m_MVmatrix, m_pos);
-      m_MVmatrix = glm::rotate(m_MVmatrix, glm::radians(m_rot.x), glm::vec3(1.0f, 0.0f, 0.0f));
-      m_MVmatrix = glm::rotate(m_MVmatrix, glm::radians(m_rot.y), glm::vec3(0.0f, 1.0f, 0.0f));
-      m_MVmatrix = glm::rotate(m_MVmatrix, glm::radians(m_rot.z), glm::vec3(0.0f, 0.0f, 1.0f));
-      m_MVmatrix = glm::scale(m_MVmatrix, m_scale);
-    }
-    else
-    {
-      m_MVmatrix=m_parent->getMVmatrix();
-      m_MVmatrix = glm::translate(m_MVmatrix, m_pos);
-      m_MVmatrix = glm::rotate(m_MVmatrix, glm::radians(m_rot.x), glm::vec3(1.0f, 0.0f, 0.0f));
-      m_MVmatrix = glm::rotate(m_MVmatrix, glm::radians(m_rot.y), glm::vec3(0.0f, 1.0f, 0.0f));
-      m_MVmatrix = glm::rotate(m_MVmatrix, glm::radians(m_rot.z), glm::vec3(0.0f, 0.0f, 1.0f));
-      m_MVmatrix = glm::scale(m_MVmatrix, m_scale);
-    }
-
-    if(!m_children.empty()) //make sure to update children as they have no way of knowing of the parent matrix changes
-    {
-      for(auto child : m_children)
-        child->updateMatrix();
-    }
+  updateLocalMatrix();
+  if(!m_children.empty()) //make sure to update children as they have no way of knowing of the parent matrix changes
+  {
+    for(auto child : m_children)
+      child->updateMatrix();
+  }
+}
+//-----------------------------------------------------------------------------------------------------
+void BaseObject::updateLocalMatrix()
+{
+  m_MVmatrix = composeMatrix(m_pos, m_rot, m_scale);
+  if(m_parent!=nullptr)
+    m_MVmatrix = m_parent->getMVmatrix() * m_MVmatrix;
+  m_matrixStamp = nextMatrixStamp();
+}
+//-----------------------------------------------------------------------------------------------------
+mat4 BaseObject::composeMatrix(const vec3 &_pos, const vec3 &_rot, const vec3 &_scale)
+{
+  mat4 ret = glm::translate(glm::mat4(1.0f), _pos);
+  ret = glm::rotate(ret, glm::radians(_rot.x), glm::vec3(1.0f, 0.0f, 0.0f));
+  ret = glm::rotate(ret, glm::radians(_rot.y), glm::vec3(0.0f, 1.0f, 0.0f));
+  ret = glm::rotate(ret, glm::radians(_rot.z), glm::vec3(0.0f, 0.0f, 1.0f));
+  return glm::scale(ret, _scale);
 }
 //-----------------------------------------------------------------------------------------------------
 mat4 BaseObject::getMVmatrix() const
@@ -154,3 +160,14 @@ mat4 BaseObject::getMVmatrix() const
   return m_MVmatrix;
 }
 //-----------------------------------------------------------------------------------------------------
+size_t BaseObject::getMatrixStamp() const
+{
+  return m_matrixStamp;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t BaseObject::nextMatrixStamp()
+{
+  static std::atomic<size_t> s_stamp(0);
+  return ++s_stamp;
+}
+//-----------------------------------------------------------------------------------------------------
@@ -1,14 +1,49 @@
 #include "DataContainer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <unordered_set>
+//-----------------------------------------------------------------------------------------------------
+namespace
+{
+//-----------------------------------------------------------------------------------------------------
+/// Returns the specified name, or the fallback if it is empty, with the ID appended if it is already taken
+//-----------------------------------------------------------------------------------------------------
+template<typename T>
+std::string uniqueName(const std::string &_name, const char* _fallback, const size_t _id, const std::unordered_map<std::string, T*> &_taken)
+{
+  const std::string base = _name.empty() ? std::string(_fallback) : _name;
+  if(_taken.count(base) == 0)
+    return base;
+  std::string ret = base + std::to_string(_id);
+  for(size_t n=1; _taken.count(ret) != 0; ++n) //only when a stored name already ends in this ID
+    ret = base + std::to_string(_id) + "_" + std::to_string(n);
+  return ret;
+}
+//-----------------------------------------------------------------------------------------------------
+/// Destroys the stored object the pointer refers to, keeping the order of the rest
+//-----------------------------------------------------------------------------------------------------
+template<typename T>
+void eraseStored(std::vector<std::unique_ptr<T>> &io_stored, const T* _ptr)
+{
+  auto it = std::find_if(io_stored.begin(), io_stored.end(), [_ptr](const std::unique_ptr<T> &_stored){ return _stored.get() == _ptr; });
+  if(it != io_stored.end())
+    io_stored.erase(it);
+}
+}
+//-----------------------------------------------------------------------------------------------------
+constexpr size_t DataContainer::s_invalidID;
+//-----------------------------------------------------------------------------------------------------
+DataContainer::~DataContainer()
+{
+  for(auto &job : m_geoJobs)
+    job.second->cancelled = true;
+}
 //-----------------------------------------------------------------------------------------------------
 void DataContainer::matUpdate(const size_t _id)
 {
-  for(auto it = m_mat.begin(); it<m_mat.end(); ++it)
-  {
-    if(_id == it->get()->getID())
-    {
-      it->get()->update();
-    }
-  }
+  auto mat = matFind(_id);
+  if(mat != nullptr)
+    mat->update();
 }
 //-----------------------------------------------------------------------------------------------------
 size_t DataContainer::matSize() const
@@ -23,377 +58,496 @@ size_t DataContainer::geosize() const
 //-----------------------------------------------------------------------------------------------------
 BaseMesh* DataContainer::geoFind(const size_t _id) const
 {
-  for(auto it = m_geo.begin(); it<m_geo.end(); ++it)
-  {
-    if(_id == it->get()->getID())
-    {
-      return it->get();
-    }
-  }
-  return nullptr;
+  auto found = m_geoByID.find(_id);
+  return found == m_geoByID.end() ? nullptr : found->second;
 }
 //-----------------------------------------------------------------------------------------------------
 BaseMesh* DataContainer::geoFind(const std::string _name) const
 {
-  for(auto it = m_geo.begin(); it<m_geo.end(); ++it)
-  {
-    if(_name == it->get()->getName())
-    {
-      return it->get();
-    }
-  }
-  return nullptr;
+  auto found = m_geoByName.find(_name);
+  return found == m_geoByName.end() ? nullptr : found->second;
 }
 //-----------------------------------------------------------------------------------------------------
 BaseMaterial* DataContainer::matFind(const size_t _id) const
 {
-  for(auto it = m_mat.begin(); it<m_mat.end(); ++it)
-  {
-    if(_id == it->get()->getID())
-    {
-      return it->get();
-    }
-  }
-  return nullptr;
+  auto found = m_matByID.find(_id);
+  return found == m_matByID.end() ? nullptr : found->second;
 }
 //-----------------------------------------------------------------------------------------------------
 BaseMaterial* DataContainer::matFind(const std::string _name) const
 {
-  for(auto it = m_mat.begin(); it<m_mat.end(); ++it)
-  {
-    if(_name == it->get()->getName())
-    {
-      return it->get();
-    }
-  }
-  return nullptr;
+  auto found = m_matByName.find(_name);
+  return found == m_matByName.end() ? nullptr : found->second;
 }
 //-----------------------------------------------------------------------------------------------------
 void DataContainer::matPut(BaseMaterial* _new)
 {
-  m_mat.emplace_back(_new);
-  checkMatIDs();
-  checkMatNames();
+  matPut(_new, "");
 }
 //-----------------------------------------------------------------------------------------------------
 void DataContainer::matPut(BaseMaterial* _new, std::string _name)
 {
-  if(!_name.empty())
-  {
-    _new->setName(_name);
-    m_mat.emplace_back(_new);
-    checkMatIDs();
-  }
-  else
-  {
-    m_mat.emplace_back(_new);
-    checkMatIDs();
-    checkMatNames();
-  }
+  m_mat.emplace_back(_new);
+  registerMat(_new, _name);
 }
 //-----------------------------------------------------------------------------------------------------
 void DataContainer::geoPut(BaseMesh* _new)
 {
-  m_geo.emplace_back(_new);
-  checkGeoIDs();
-  checkGeoNames();
+  geoPut(_new, "");
 }
 //-----------------------------------------------------------------------------------------------------
 void DataContainer::geoPut(BaseMesh* _new, std::string _name)
 {
-  if(!_name.empty())
-  {
-    _new->setName(_name);
-    m_geo.emplace_back(_new);
-    checkGeoIDs();
-  }
-  else
-  {
-    m_geo.emplace_back(_new);
-    checkGeoIDs();
-    checkGeoNames();
-  }
+  m_geo.emplace_back(_new);
+  registerGeo(_new, _name);
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::matRemove(const std::string _name)
+void DataContainer::geoPutMany(const std::vector<BaseMesh*> &_new, const std::vector<std::string> &_names)
 {
-  for(auto it = m_mat.begin(); it<m_mat.end(); ++it)
+  const size_t total = m_geo.size() + _new.size();
+  m_geo.reserve(total);
+  m_geoByID.reserve(total);
+  m_geoByName.reserve(total);
+  m_geoIDs.reserve(total);
+  for(size_t i=0; i<_new.size(); ++i)
   {
-    if(_name == it->get()->getName())
-    {
-      m_mat.erase(it);
-      break;
-    }
+    m_geo.emplace_back(_new[i]);
+    registerGeo(_new[i], i < _names.size() ? _names[i] : "");
   }
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::matRemove(const size_t _id)
+void DataContainer::matPutMany(const std::vector<BaseMaterial*> &_new, const std::vector<std::string> &_names)
 {
-  for(auto it = m_mat.begin(); it<m_mat.end(); ++it)
+  const size_t total = m_mat.size() + _new.size();
+  m_mat.reserve(total);
+  m_matByID.reserve(total);
+  m_matByName.reserve(total);
+  m_matIDs.reserve(total);
+  for(size_t i=0; i<_new.size(); ++i)
   {
-    if(_id == it->get()->getID())
-    {
-      m_mat.erase(it);
-      break;
-    }
+    m_mat.emplace_back(_new[i]);
+    registerMat(_new[i], i < _names.size() ? _names[i] : "");
   }
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::geoRemove(const std::string _name)
+void DataContainer::setGeoFactory(std::function<BaseMesh*()> _factory)
 {
-  for(auto it = m_geo.begin(); it<m_geo.end(); ++it)
-  {
-    if(_name == it->get()->getName())
-    {
-      m_geo.erase(it);
-      break;
-    }
-  }
+  m_geoFactory = std::move(_factory);
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::geoRemove(const size_t _id)
+size_t DataContainer::geoPutAsync(const std::string &_path, const std::string &_name)
 {
-  for(auto it = m_geo.begin(); it<m_geo.end(); ++it)
-  {
-    if(_id == it->get()->getID())
-    {
-      m_geo.erase(it);
-      break;
-    }
-  }
+  if(!m_geoFactory)
+    return s_invalidID;
+  BaseMesh* placeholder = m_geoFactory();
+  geoPut(placeholder, _name);
+  startGeoLoad(placeholder->getID(), _path, false);
+  return placeholder->getID();
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::setGeoName(const size_t _id, const std::string _new)
+void DataContainer::startGeoLoad(const size_t _id, const std::string &_path, const bool _reload)
 {
-  for(auto it = m_geo.begin(); it<m_geo.end(); ++it)
+  auto job = std::make_shared<GeoJob>();
+  job->path = _path;
+  job->reload = _reload;
+  m_geoJobs[_id] = job;
+  //the task owns everything it touches, so the container may change or go away while it runs
+  auto factory = m_geoFactory;
+  ThreadPool::instance().submit([job, factory]()
   {
-    if(_id == it->get()->getID())
+    if(!job->cancelled)
     {
-      it->get()->setName(_new);
-      break;
+      std::unique_ptr<BaseMesh> mesh(factory());
+      GeoJob* state = job.get();
+      const bool loaded = mesh->load(state->path, [state](float _done)
+      {
+        state->progress = _done;
+        return !state->cancelled;
+      });
+      if(loaded && !job->cancelled)
+        job->result = std::move(mesh);
     }
-  }
+    job->finished = true;
+  });
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::setMatName(const size_t _id, const std::string _new)
+std::vector<size_t> DataContainer::geoPollAsync()
 {
-  for(auto it = m_mat.begin(); it<m_mat.end(); ++it)
+  std::vector<size_t> swapped;
+  std::vector<size_t> dropped;
+  for(auto it = m_geoJobs.begin(); it != m_geoJobs.end();)
   {
-    if(_id == it->get()->getID())
+    const auto &job = *it->second;
+    if(!job.finished)
     {
-      it->get()->setName(_new);
-      break;
+      ++it;
+      continue;
+    }
+    const size_t id = it->first;
+    if(job.result == nullptr || job.cancelled)
+    {
+      //only a first load's placeholder goes, a failed reload keeps the mesh objects still refer to and
+      //leaves it evicted, so its next use tries again
+      if(!job.reload)
+        dropped.push_back(id);
+      it = m_geoJobs.erase(it);
+      continue;
     }
+    //the loaded mesh takes over the placeholder's ID, Name and storage slot
+    BaseMesh* placeholder = geoFind(id);
+    BaseMesh* loaded = it->second->result.release();
+    loaded->setID(id);
+    loaded->setName(placeholder->getName());
+    auto stored = std::find_if(m_geo.begin(), m_geo.end(), [placeholder](const std::unique_ptr<BaseMesh> &_stored){ return _stored.get() == placeholder; });
+    stored->reset(loaded);
+    m_geoByID[id] = loaded;
+    m_geoByName[loaded->getName()] = loaded;
+    m_geoUse[id].evicted = false;
+    shareGeoStorage(loaded);
+    swapped.push_back(id);
+    it = m_geoJobs.erase(it);
   }
+  for(auto id : dropped)
+    geoRemove(id);
+  enforceGeoBudget();
+  ++m_useTick;
+  return swapped;
 }
 //-----------------------------------------------------------------------------------------------------
-std::string DataContainer::getMatName(const size_t _id) const
+float DataContainer::geoAsyncProgress(const size_t _id) const
 {
-  for(auto it = m_mat.begin(); it<m_mat.end(); ++it)
-  {
-    if(_id == it->get()->getID())
-    {
-      return it->get()->getName();
-    }
-  }
-  return "Material1";
+  auto found = m_geoJobs.find(_id);
+  return found == m_geoJobs.end() ? -1.f : found->second->progress.load();
 }
 //-----------------------------------------------------------------------------------------------------
-std::string DataContainer::getGeoName(const size_t _id) const
+void DataContainer::geoCancelAsync(const size_t _id)
 {
-  for(auto it = m_geo.begin(); it<m_geo.end(); ++it)
-  {
-    if(_id == it->get()->getID())
-    {
-      return it->get()->getName();
-    }
-  }
-  return "Mesh1";
+  auto found = m_geoJobs.find(_id);
+  if(found != m_geoJobs.end())
+    found->second->cancelled = true;
 }
 //-----------------------------------------------------------------------------------------------------
-std::vector<std::string> DataContainer::getGeoNames() const
+size_t DataContainer::geoAsyncPending() const
 {
-  std::vector<std::string> ret;
-  for(auto it = m_geo.begin(); it<m_geo.end(); ++it)
-  {
-    ret.emplace_back(it->get()->getName());
-  }
-  return ret;
+  return m_geoJobs.size();
 }
 //-----------------------------------------------------------------------------------------------------
-std::vector<std::string> DataContainer::getMatNames() const
+void DataContainer::geoAddRef(const size_t _id)
 {
-  std::vector<std::string> ret;
-  for(auto it = m_mat.begin(); it<m_mat.end(); ++it)
+  ++m_geoUse[_id].refs;
+}
+//-----------------------------------------------------------------------------------------------------
+void DataContainer::geoRelease(const size_t _id)
+{
+  auto found = m_geoUse.find(_id);
+  if(found != m_geoUse.end() && found->second.refs > 0)
+    --found->second.refs;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t DataContainer::geoRefCount(const size_t _id) const
+{
+  auto found = m_geoUse.find(_id);
+  return found == m_geoUse.end() ? 0 : found->second.refs;
+}
+//-----------------------------------------------------------------------------------------------------
+void DataContainer::matAddRef(const size_t _id)
+{
+  ++m_matRefs[_id];
+}
+//-----------------------------------------------------------------------------------------------------
+void DataContainer::matRelease(const size_t _id)
+{
+  auto found = m_matRefs.find(_id);
+  if(found != m_matRefs.end() && found->second > 0)
+    --found->second;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t DataContainer::matRefCount(const size_t _id) const
+{
+  auto found = m_matRefs.find(_id);
+  return found == m_matRefs.end() ? 0 : found->second;
+}
+//-----------------------------------------------------------------------------------------------------
+BaseMesh* DataContainer::geoUse(const size_t _id)
+{
+  auto mesh = geoFind(_id);
+  if(mesh == nullptr)
+    return nullptr;
+  auto &use = m_geoUse[_id];
+  use.lastUse = m_useTick;
+  if(use.evicted && m_geoJobs.count(_id) == 0)
+    startGeoLoad(_id, mesh->getSource(), true);
+  return mesh;
+}
+//-----------------------------------------------------------------------------------------------------
+void DataContainer::setGeoBudget(const size_t _bytes)
+{
+  m_geoBudget = _bytes;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t DataContainer::geoBudget() const
+{
+  return m_geoBudget;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t DataContainer::geoResidentBytes(const size_t _id) const
+{
+  auto mesh = geoFind(_id);
+  return mesh == nullptr ? 0 : mesh->residentBytes();
+}
+//-----------------------------------------------------------------------------------------------------
+size_t DataContainer::geoResidentBytes() const
+{
+  size_t total = 0;
+  std::unordered_set<const void*> counted;
+  counted.reserve(m_geo.size());
+  for(const auto &mesh : m_geo)
   {
-    ret.emplace_back(it->get()->getName());
+    if(counted.insert(mesh->storageID()).second)
+      total += mesh->residentBytes();
   }
-  return ret;
+  return total;
 }
 //-----------------------------------------------------------------------------------------------------
-size_t DataContainer::getMatID(const std::string &_name) const
+size_t DataContainer::geoSharedBytes() const
 {
-  for(auto it = m_mat.begin(); it<m_mat.end(); ++it)
+  size_t total = 0;
+  for(const auto &mesh : m_geo)
+    total += mesh->residentBytes();
+  return total - geoResidentBytes();
+}
+//-----------------------------------------------------------------------------------------------------
+size_t DataContainer::geoGpuBytes() const
+{
+  size_t total = 0;
+  std::unordered_set<const void*> counted;
+  counted.reserve(m_geo.size());
+  for(const auto &mesh : m_geo)
   {
-    if(_name == it->get()->getName())
-    {
-      return it->get()->getID();
-    }
+    if(counted.insert(mesh->storageID()).second)
+      total += mesh->gpuBytes();
   }
-  return 0;
+  return total;
 }
 //-----------------------------------------------------------------------------------------------------
-size_t DataContainer::getGeoID(const std::string &_name) const
+void DataContainer::shareGeoStorage(BaseMesh* io_mesh)
 {
-  for(auto it = m_geo.begin(); it<m_geo.end(); ++it)
+  const size_t hash = io_mesh->contentHash();
+  if(hash == 0)
+    return;
+  auto found = m_geoByHash.find(hash);
+  if(found != m_geoByHash.end() && found->second != io_mesh->getID())
   {
-    if(_name == it->get()->getName())
-    {
-      return it->get()->getID();
-    }
+    auto shared = geoFind(found->second);
+    if(shared != nullptr && shared->contentHash() == hash && io_mesh->shareStorage(*shared))
+      return;
   }
-  return 0;
+  //first mesh with this content, or the recorded one is gone or changed
+  m_geoByHash[hash] = io_mesh->getID();
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::checkIDs()
+bool DataContainer::geoIsResident(const size_t _id) const
 {
-  checkGeoIDs();
-  checkMatIDs();
+  if(geoFind(_id) == nullptr || m_geoJobs.count(_id) != 0)
+    return false;
+  auto found = m_geoUse.find(_id);
+  return found == m_geoUse.end() || !found->second.evicted;
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::checkGeoIDs()
+void DataContainer::enforceGeoBudget()
 {
-  std::vector<size_t> currentUsed = getCurrentGeoIDs();
-  for(size_t m =0; m<currentUsed.size(); ++m)
+  if(m_geoBudget == 0 || !m_geoFactory)
+    return;
+  //system and GPU bytes of every storage, with the number of meshes still holding it
+  struct Storage
+  {
+    size_t bytes;
+    size_t users;
+  };
+  std::unordered_map<const void*, Storage> storages;
+  storages.reserve(m_geo.size());
+  size_t total = 0;
+  for(const auto &mesh : m_geo)
   {
-    for(size_t n=m+1; n<currentUsed.size(); ++n) //start from 1
+    auto inserted = storages.emplace(mesh->storageID(), Storage{0, 0});
+    if(inserted.second)
     {
-      if(currentUsed[m] == currentUsed[n]) //if we have a match
-      {
-        size_t tmp = getFreeGeoID();
-        currentUsed[n] = tmp; //update for further loop iterations
-        m_geo[n]->setID(tmp);
-      }
+      inserted.first->second.bytes = mesh->residentBytes() + mesh->gpuBytes();
+      total += inserted.first->second.bytes;
     }
+    ++inserted.first->second.users;
+  }
+  if(total <= m_geoBudget)
+    return;
+  //unreferenced meshes go first, then the least recently drawn ones
+  struct Candidate
+  {
+    BaseMesh* mesh;
+    GeoUse* use;
+  };
+  std::vector<Candidate> candidates;
+  for(const auto &mesh : m_geo)
+  {
+    auto &use = m_geoUse[mesh->getID()];
+    if(!use.evicted && use.lastUse != m_useTick && !mesh->getSource().empty() && m_geoJobs.count(mesh->getID()) == 0)
+      candidates.push_back({mesh.get(), &use});
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate &_a, const Candidate &_b)
+  {
+    if((_a.use->refs == 0) != (_b.use->refs == 0))
+      return _a.use->refs == 0;
+    return _a.use->lastUse < _b.use->lastUse;
+  });
+  for(auto &candidate : candidates)
+  {
+    if(total <= m_geoBudget)
+      break;
+    //shared storage is only freed with its last user
+    auto &storage = storages[candidate.mesh->storageID()];
+    if(--storage.users == 0)
+      total -= storage.bytes;
+    candidate.mesh->reset();
+    candidate.use->evicted = true;
   }
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::checkMatIDs()
+void DataContainer::matRemove(const std::string _name)
 {
-  std::vector<size_t> currentUsed = getCurrentMatIDs();
-  for(size_t m =0; m<currentUsed.size(); ++m)
+  auto found = matFind(_name);
+  if(found != nullptr)
+    matRemove(found->getID());
+}
+//-----------------------------------------------------------------------------------------------------
+void DataContainer::matRemove(const size_t _id)
+{
+  auto found = matFind(_id);
+  if(found == nullptr)
+    return;
+  m_matByID.erase(_id);
+  m_matByName.erase(found->getName());
+  m_matIDs.release(_id);
+  eraseStored(m_mat, found);
+}
+//-----------------------------------------------------------------------------------------------------
+void DataContainer::geoRemove(const std::string _name)
+{
+  auto found = geoFind(_name);
+  if(found != nullptr)
+    geoRemove(found->getID());
+}
+//-----------------------------------------------------------------------------------------------------
+void DataContainer::geoRemove(const size_t _id)
+{
+  auto found = geoFind(_id);
+  if(found == nullptr)
+    return;
+  auto job = m_geoJobs.find(_id);
+  if(job != m_geoJobs.end())
   {
-    for(size_t n=m+1; n<currentUsed.size(); ++n) //start from 1
+    job->second->cancelled = true;
+    m_geoJobs.erase(job);
+  }
+  m_geoByID.erase(_id);
+  m_geoByName.erase(found->getName());
+  m_geoIDs.release(_id);
+  m_geoUse[_id].evicted = false;
+  auto shared = m_geoByHash.find(found->contentHash());
+  if(shared != m_geoByHash.end() && shared->second == _id)
+  {
+    //hand the content over to another mesh sharing it, the removal already costs a scan of the vector
+    m_geoByHash.erase(shared);
+    for(const auto &mesh : m_geo)
     {
-      if(currentUsed[m] == currentUsed[n]) //if we have a match
+      if(mesh.get() != found && mesh->contentHash() == found->contentHash())
       {
-        size_t tmp = getFreeMatID();
-        currentUsed[n] = tmp; //update for further loop iterations
-        m_mat[n]->setID(tmp);
+        m_geoByHash[mesh->contentHash()] = mesh->getID();
+        break;
       }
     }
   }
+  eraseStored(m_geo, found);
 }
 //-----------------------------------------------------------------------------------------------------
-size_t DataContainer::getFreeGeoID() const
+void DataContainer::setGeoName(const size_t _id, const std::string _new)
 {
-  size_t newID=0;
-  std::vector<size_t> currentUsed = getCurrentGeoIDs();
-  for(auto n : currentUsed)
-  {
-    if(n==newID) //match, need a different id
-    {
-      ++newID;
-      if(n+1>newID)
-        break;
-    }
-  }
-  return newID;
+  auto found = geoFind(_id);
+  if(found == nullptr || found->getName() == _new)
+    return;
+  m_geoByName.erase(found->getName());
+  found->setName(uniqueName(_new, "Mesh", _id, m_geoByName));
+  m_geoByName.emplace(found->getName(), found);
 }
 //-----------------------------------------------------------------------------------------------------
-size_t DataContainer::getFreeMatID() const
+void DataContainer::setMatName(const size_t _id, const std::string _new)
 {
-  size_t newID=0;
-  std::vector<size_t> currentUsed = getCurrentMatIDs();
-  for(auto n : currentUsed)
-  {
-    if(n==newID) //match, need a different id
-    {
-      ++newID;
-      if(n+1>newID)
-        break;
-    }
-  }
-  return newID;
+  auto found = matFind(_id);
+  if(found == nullptr || found->getName() == _new)
+    return;
+  m_matByName.erase(found->getName());
+  found->setName(uniqueName(_new, "Material", _id, m_matByName));
+  m_matByName.emplace(found->getName(), found);
 }
 //-----------------------------------------------------------------------------------------------------
-std::vector<size_t> DataContainer::getCurrentGeoIDs() const
+std::string DataContainer::getMatName(const size_t _id) const
 {
-  std::vector<size_t> ret;
-  ret.clear();
-  ret.reserve(m_geo.size());
-  for(size_t i=0; i<m_geo.size(); ++i)
+  auto found = matFind(_id);
+  return found == nullptr ? "Material1" : found->getName();
+}
+//-----------------------------------------------------------------------------------------------------
+std::string DataContainer::getGeoName(const size_t _id) const
+{
+  auto found = geoFind(_id);
+  return found == nullptr ? "Mesh1" : found->getName();
+}
+//-----------------------------------------------------------------------------------------------------
+std::vector<std::string> DataContainer::getGeoNames() const
+{
+  std::vector<std::string> ret;
+  for(auto it = m_geo.begin(); it<m_geo.end(); ++it)
   {
-    ret.push_back(m_geo.at(i)->getID());
+    ret.emplace_back(it->get()->getName());
   }
   return ret;
 }
 //-----------------------------------------------------------------------------------------------------
-std::vector<size_t> DataContainer::getCurrentMatIDs() const
+std::vector<std::string> DataContainer::getMatNames() const
 {
-  std::vector<size_t> ret;
-  ret.clear();
-  ret.reserve(m_mat.size());
-  for(size_t i=0; i<m_mat.size(); ++i)
+  std::vector<std::string> ret;
+  for(auto it = m_mat.begin(); it<m_mat.end(); ++it)
   {
-    ret.push_back(m_mat.at(i)->getID());
+    ret.emplace_back(it->get()->getName());
   }
   return ret;
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::checkNames()
+size_t DataContainer::getMatID(const std::string &_name) const
 {
-  checkMatNames();
-  checkGeoNames();
+  auto found = matFind(_name);
+  return found == nullptr ? 0 : found->getID();
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::checkMatNames()
+size_t DataContainer::getGeoID(const std::string &_name) const
 {
-  std::vector<std::string> current = getMatNames();
-  std::vector<size_t> currentIDs = getCurrentMatIDs();
-  for(size_t m =0; m<current.size(); ++m)
-  {
-    if(m==0&&m_mat[m]->getName()=="")
-      m_mat[m]->setName("Material");
-
-    for(size_t n=m+1; n<current.size(); ++n)
-    {
-      if(current[m] == current[n])
-      {
-        std::string tmp = current[m]+std::to_string(currentIDs[n]);
-        m_mat[n]->setName(tmp);
-      }
-    }
-  }
+  auto found = geoFind(_name);
+  return found == nullptr ? 0 : found->getID();
 }
 //-----------------------------------------------------------------------------------------------------
-void DataContainer::checkGeoNames()
+void DataContainer::registerGeo(BaseMesh* _new, const std::string &_name)
 {
-  std::vector<std::string> current = getGeoNames();
-  std::vector<size_t> currentIDs = getCurrentGeoIDs();
-  for(size_t m =0; m<current.size(); ++m)
-  {
-    if(m==0&&m_geo[m]->getName()=="")
-      m_geo[m]->setName("Mesh");
-
-    for(size_t n=m+1; n<current.size(); ++n)
-    {
-      if(current[m] == current[n])
-      {
-        std::string tmp = current[m]+std::to_string(currentIDs[n]);
-        m_geo[n]->setName(tmp);
-      }
-    }
-  }
+  if(!m_geoIDs.claim(_new->getID()))
+    _new->setID(m_geoIDs.allocate());
+  _new->setName(uniqueName(_name.empty() ? _new->getName() : _name, "Mesh", _new->getID(), m_geoByName));
+  m_geoByID.emplace(_new->getID(), _new);
+  m_geoByName.emplace(_new->getName(), _new);
+  shareGeoStorage(_new);
+}
+//-----------------------------------------------------------------------------------------------------
+void DataContainer::registerMat(BaseMaterial* _new, const std::string &_name)
+{
+  if(!m_matIDs.claim(_new->getID()))
+    _new->setID(m_matIDs.allocate());
+  _new->setName(uniqueName(_name.empty() ? _new->getName() : _name, "Material", _new->getID(), m_matByName));
+  m_matByID.emplace(_new->getID(), _new);
+  m_matByName.emplace(_new->getName(), _new);
 }
 //-----------------------------------------------------------------------------------------------------
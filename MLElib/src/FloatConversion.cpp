@@ -0,0 +1,440 @@
+#include "FloatConversion.h"
+#include <cstring>
+#include <cstdlib>
+#include <clocale>
+#include <limits>
+#include <string>
+//-----------------------------------------------------------------------------------------------------
+// Shortest float formatting follows Ulf Adams' Ryu (PLDI 2018), specialised for 32 bit floats.
+//-----------------------------------------------------------------------------------------------------
+namespace
+{
+constexpr int s_mantissaBits = 23;
+constexpr int s_exponentBits = 8;
+constexpr int s_bias = 127;
+constexpr int s_pow5InvBitcount = 59;
+constexpr int s_pow5Bitcount = 61;
+//-----------------------------------------------------------------------------------------------------
+/// floor(2^(pow5bits(i)-1+59) / 5^i) + 1
+//-----------------------------------------------------------------------------------------------------
+constexpr uint64_t s_pow5InvSplit[31] = {
+  576460752303423489u, 461168601842738791u, 368934881474191033u, 295147905179352826u,
+  472236648286964522u, 377789318629571618u, 302231454903657294u, 483570327845851670u,
+  386856262276681336u, 309485009821345069u, 495176015714152110u, 396140812571321688u,
+  316912650057057351u, 507060240091291761u, 405648192073033409u, 324518553658426727u,
+  519229685853482763u, 415383748682786211u, 332306998946228969u, 531691198313966350u,
+  425352958651173080u, 340282366920938464u, 544451787073501542u, 435561429658801234u,
+  348449143727040987u, 557518629963265579u, 446014903970612463u, 356811923176489971u,
+  570899077082383953u, 456719261665907162u, 365375409332725730u
+};
+//-----------------------------------------------------------------------------------------------------
+/// 5^i normalised to 61 significant bits
+//-----------------------------------------------------------------------------------------------------
+constexpr uint64_t s_pow5Split[47] = {
+  1152921504606846976u, 1441151880758558720u, 1801439850948198400u, 2251799813685248000u,
+  1407374883553280000u, 1759218604441600000u, 2199023255552000000u, 1374389534720000000u,
+  1717986918400000000u, 2147483648000000000u, 1342177280000000000u, 1677721600000000000u,
+  2097152000000000000u, 1310720000000000000u, 1638400000000000000u, 2048000000000000000u,
+  1280000000000000000u, 1600000000000000000u, 2000000000000000000u, 1250000000000000000u,
+  1562500000000000000u, 1953125000000000000u, 1220703125000000000u, 1525878906250000000u,
+  1907348632812500000u, 1192092895507812500u, 1490116119384765625u, 1862645149230957031u,
+  1164153218269348144u, 1455191522836685180u, 1818989403545856475u, 2273736754432320594u,
+  1421085471520200371u, 1776356839400250464u, 2220446049250313080u, 1387778780781445675u,
+  1734723475976807094u, 2168404344971008868u, 1355252715606880542u, 1694065894508600678u,
+  2117582368135750847u, 1323488980084844279u, 1654361225106055349u, 2067951531382569187u,
+  1292469707114105741u, 1615587133892632177u, 2019483917365790221u
+};
+//-----------------------------------------------------------------------------------------------------
+/// Powers of ten that are exact in float and double respectively
+//-----------------------------------------------------------------------------------------------------
+constexpr float s_exactPow10f[11] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+constexpr double s_exactPow10d[23] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+//-----------------------------------------------------------------------------------------------------
+inline int32_t pow5bits(const int32_t _e)
+{
+  return static_cast<int32_t>(((static_cast<uint32_t>(_e) * 1217359) >> 19) + 1);
+}
+//-----------------------------------------------------------------------------------------------------
+inline uint32_t log10Pow2(const int32_t _e)
+{
+  return (static_cast<uint32_t>(_e) * 78913) >> 18;
+}
+//-----------------------------------------------------------------------------------------------------
+inline uint32_t log10Pow5(const int32_t _e)
+{
+  return (static_cast<uint32_t>(_e) * 732923) >> 20;
+}
+//-----------------------------------------------------------------------------------------------------
+inline uint32_t pow5Factor(uint32_t _value)
+{
+  uint32_t count = 0;
+  while(_value % 5 == 0)
+  {
+    _value /= 5;
+    ++count;
+  }
+  return count;
+}
+//-----------------------------------------------------------------------------------------------------
+inline bool multipleOfPowerOf5(const uint32_t _value, const uint32_t _p)
+{
+  return pow5Factor(_value) >= _p;
+}
+//-----------------------------------------------------------------------------------------------------
+inline bool multipleOfPowerOf2(const uint32_t _value, const uint32_t _p)
+{
+  return (_value & ((1u << _p) - 1)) == 0;
+}
+//-----------------------------------------------------------------------------------------------------
+inline uint32_t mulShift(const uint32_t _m, const uint64_t _factor, const int32_t _shift)
+{
+  const uint64_t bits0 = static_cast<uint64_t>(_m) * static_cast<uint32_t>(_factor);
+  const uint64_t bits1 = static_cast<uint64_t>(_m) * static_cast<uint32_t>(_factor >> 32);
+  const uint64_t sum = (bits0 >> 32) + bits1;
+  return static_cast<uint32_t>(sum >> (_shift - 32));
+}
+//-----------------------------------------------------------------------------------------------------
+inline uint32_t decimalLength(const uint32_t _v)
+{
+  uint32_t len = 1;
+  for(uint32_t bound = 10; len < 10 && _v >= bound; bound *= 10)
+    ++len;
+  return len;
+}
+//-----------------------------------------------------------------------------------------------------
+/// Returns the shortest decimal mantissa and exponent that round to the given finite, non zero float
+//-----------------------------------------------------------------------------------------------------
+void shortestDecimal(const uint32_t _ieeeMantissa, const uint32_t _ieeeExponent, uint32_t &o_mantissa, int32_t &o_exponent)
+{
+  int32_t e2;
+  uint32_t m2;
+  if(_ieeeExponent == 0)
+  {
+    e2 = 1 - s_bias - s_mantissaBits - 2;
+    m2 = _ieeeMantissa;
+  }
+  else
+  {
+    e2 = static_cast<int32_t>(_ieeeExponent) - s_bias - s_mantissaBits - 2;
+    m2 = (1u << s_mantissaBits) | _ieeeMantissa;
+  }
+  const bool acceptBounds = (m2 & 1) == 0;
+
+  //the interval of values that round to this float, scaled by 4
+  const uint32_t mv = 4 * m2;
+  const uint32_t mmShift = _ieeeMantissa != 0 || _ieeeExponent <= 1;
+
+  uint32_t vr, vp, vm;
+  int32_t e10;
+  bool vmIsTrailingZeros = false;
+  bool vrIsTrailingZeros = false;
+  uint32_t lastRemovedDigit = 0;
+  if(e2 >= 0)
+  {
+    const uint32_t q = log10Pow2(e2);
+    e10 = static_cast<int32_t>(q);
+    const int32_t k = s_pow5InvBitcount + pow5bits(static_cast<int32_t>(q)) - 1;
+    const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+    vr = mulShift(4 * m2, s_pow5InvSplit[q], i);
+    vp = mulShift(4 * m2 + 2, s_pow5InvSplit[q], i);
+    vm = mulShift(4 * m2 - 1 - mmShift, s_pow5InvSplit[q], i);
+    if(q != 0 && (vp - 1) / 10 <= vm / 10)
+    {
+      //one removed digit is needed even when the loop below does not run
+      const int32_t l = s_pow5InvBitcount + pow5bits(static_cast<int32_t>(q - 1)) - 1;
+      lastRemovedDigit = mulShift(mv, s_pow5InvSplit[q - 1], -e2 + static_cast<int32_t>(q) - 1 + l) % 10;
+    }
+    if(q <= 9)
+    {
+      //only one of mp, mv and mm can be a multiple of 5, if any
+      if(mv % 5 == 0)
+        vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+      else if(acceptBounds)
+        vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+      else
+        vp -= multipleOfPowerOf5(mv + 2, q);
+    }
+  }
+  else
+  {
+    const uint32_t q = log10Pow5(-e2);
+    e10 = static_cast<int32_t>(q) + e2;
+    const int32_t i = -e2 - static_cast<int32_t>(q);
+    const int32_t k = pow5bits(i) - s_pow5Bitcount;
+    int32_t j = static_cast<int32_t>(q) - k;
+    vr = mulShift(4 * m2, s_pow5Split[i], j);
+    vp = mulShift(4 * m2 + 2, s_pow5Split[i], j);
+    vm = mulShift(4 * m2 - 1 - mmShift, s_pow5Split[i], j);
+    if(q != 0 && (vp - 1) / 10 <= vm / 10)
+    {
+      j = static_cast<int32_t>(q) - 1 - (pow5bits(i + 1) - s_pow5Bitcount);
+      lastRemovedDigit = mulShift(mv, s_pow5Split[i + 1], j) % 10;
+    }
+    if(q <= 1)
+    {
+      //mv = 4 * m2 always has at least two trailing zero bits
+      vrIsTrailingZeros = true;
+      if(acceptBounds)
+        vmIsTrailingZeros = mmShift == 1;
+      else
+        --vp;
+    }
+    else if(q < 31)
+    {
+      vrIsTrailingZeros = multipleOfPowerOf2(mv, q - 1);
+    }
+  }
+
+  //remove digits while the upper and lower bounds still differ
+  int32_t removed = 0;
+  uint32_t output;
+  if(vmIsTrailingZeros || vrIsTrailingZeros)
+  {
+    //general case, rare
+    while(vp / 10 > vm / 10)
+    {
+      vmIsTrailingZeros &= vm % 10 == 0;
+      vrIsTrailingZeros &= lastRemovedDigit == 0;
+      lastRemovedDigit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    if(vmIsTrailingZeros)
+    {
+      while(vm % 10 == 0)
+      {
+        vrIsTrailingZeros &= lastRemovedDigit == 0;
+        lastRemovedDigit = vr % 10;
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        ++removed;
+      }
+    }
+    if(vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0)
+      lastRemovedDigit = 4; //round half to even
+    output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+  }
+  else
+  {
+    //common case
+    while(vp / 10 > vm / 10)
+    {
+      lastRemovedDigit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    output = vr + (vr == vm || lastRemovedDigit >= 5);
+  }
+  o_mantissa = output;
+  o_exponent = e10 + removed;
+}
+//-----------------------------------------------------------------------------------------------------
+/// Locale independent fallback, used for the rare inputs the fast paths cannot round correctly
+//-----------------------------------------------------------------------------------------------------
+float slowParse(const char* _begin, const char* _end)
+{
+  std::string text(_begin, _end);
+  const char point = *std::localeconv()->decimal_point;
+  for(auto &c : text)
+  {
+    if(c == '.')
+      c = point;
+  }
+  return std::strtof(text.c_str(), nullptr);
+}
+}
+//-----------------------------------------------------------------------------------------------------
+size_t FloatConversion::formatShortest(const float _val, char* o_out)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &_val, sizeof(bits));
+  const bool sign = (bits >> 31) != 0;
+  const uint32_t ieeeMantissa = bits & ((1u << s_mantissaBits) - 1);
+  const uint32_t ieeeExponent = (bits >> s_mantissaBits) & ((1u << s_exponentBits) - 1);
+
+  char* it = o_out;
+  if(ieeeExponent == (1u << s_exponentBits) - 1)
+  {
+    //json has no representation for inf or nan
+    std::memcpy(it, "null", 4);
+    return 4;
+  }
+  if(sign)
+    *it++ = '-';
+  if(ieeeExponent == 0 && ieeeMantissa == 0)
+  {
+    *it++ = '0';
+    return static_cast<size_t>(it - o_out);
+  }
+
+  uint32_t mantissa;
+  int32_t exponent;
+  shortestDecimal(ieeeMantissa, ieeeExponent, mantissa, exponent);
+
+  char digits[10];
+  const int32_t length = static_cast<int32_t>(decimalLength(mantissa));
+  for(int32_t i = length - 1; i >= 0; --i)
+  {
+    digits[i] = static_cast<char>('0' + mantissa % 10);
+    mantissa /= 10;
+  }
+  //position of the decimal point relative to the first digit
+  const int32_t point = length + exponent;
+  if(point > 21 || point < -5)
+  {
+    //scientific notation, d.ddde-x
+    *it++ = digits[0];
+    if(length > 1)
+    {
+      *it++ = '.';
+      std::memcpy(it, digits + 1, static_cast<size_t>(length - 1));
+      it += length - 1;
+    }
+    *it++ = 'e';
+    int32_t sciExp = point - 1;
+    if(sciExp < 0)
+    {
+      *it++ = '-';
+      sciExp = -sciExp;
+    }
+    if(sciExp >= 10)
+      *it++ = static_cast<char>('0' + sciExp / 10);
+    *it++ = static_cast<char>('0' + sciExp % 10);
+  }
+  else if(exponent >= 0)
+  {
+    //integral value, pad with zeros
+    std::memcpy(it, digits, static_cast<size_t>(length));
+    it += length;
+    std::memset(it, '0', static_cast<size_t>(exponent));
+    it += exponent;
+  }
+  else if(point > 0)
+  {
+    std::memcpy(it, digits, static_cast<size_t>(point));
+    it += point;
+    *it++ = '.';
+    std::memcpy(it, digits + point, static_cast<size_t>(length - point));
+    it += length - point;
+  }
+  else
+  {
+    *it++ = '0';
+    *it++ = '.';
+    std::memset(it, '0', static_cast<size_t>(-point));
+    it += -point;
+    std::memcpy(it, digits, static_cast<size_t>(length));
+    it += length;
+  }
+  return static_cast<size_t>(it - o_out);
+}
+//-----------------------------------------------------------------------------------------------------
+const char* FloatConversion::parseFloat(const char* _begin, const char* _end, float &o_val)
+{
+  const char* it = _begin;
+  bool negative = false;
+  if(it < _end && *it == '-')
+  {
+    negative = true;
+    ++it;
+  }
+  //accumulate up to 19 significant digits, the rest only move the exponent
+  uint64_t mantissa = 0;
+  int32_t exponent = 0;
+  int32_t significant = 0;
+  bool truncated = false;
+  const char* digitsBegin = it;
+  for(; it < _end && *it >= '0' && *it <= '9'; ++it)
+  {
+    if(significant < 19)
+    {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*it - '0');
+      if(mantissa != 0)
+        ++significant;
+    }
+    else
+    {
+      ++exponent;
+      truncated |= *it != '0';
+    }
+  }
+  if(it < _end && *it == '.')
+  {
+    ++it;
+    for(; it < _end && *it >= '0' && *it <= '9'; ++it)
+    {
+      if(significant < 19)
+      {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*it - '0');
+        --exponent;
+        if(mantissa != 0)
+          ++significant;
+      }
+      else
+      {
+        truncated |= *it != '0';
+      }
+    }
+  }
+  if(it == digitsBegin)
+    return _begin; //not a number
+  if(it < _end && (*it == 'e' || *it == 'E'))
+  {
+    const char* expBegin = it++;
+    bool expNegative = false;
+    if(it < _end && (*it == '+' || *it == '-'))
+      expNegative = *it++ == '-';
+    int32_t explicitExp = 0;
+    const char* expDigits = it;
+    for(; it < _end && *it >= '0' && *it <= '9'; ++it)
+    {
+      if(explicitExp < 100000)
+        explicitExp = explicitExp * 10 + (*it - '0');
+    }
+    if(it == expDigits)
+      it = expBegin; //dangling exponent marker is not part of the number
+    else
+      exponent += expNegative ? -explicitExp : explicitExp;
+  }
+
+  if(mantissa == 0)
+  {
+    o_val = negative ? -0.0f : 0.0f;
+    return it;
+  }
+  if(!truncated && mantissa <= (1u << 24) && exponent >= -10 && exponent <= 10)
+  {
+    //both operands are exact floats, so one correctly rounded operation gives the answer
+    float result = static_cast<float>(mantissa);
+    result = exponent < 0 ? result / s_exactPow10f[-exponent] : result * s_exactPow10f[exponent];
+    o_val = negative ? -result : result;
+    return it;
+  }
+  if(!truncated && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22)
+  {
+    //correctly rounded double, then narrowed. Narrowing can only go wrong if the double
+    //landed exactly on a halfway point between two floats, so those take the slow path
+    double wide = static_cast<double>(mantissa);
+    wide = exponent < 0 ? wide / s_exactPow10d[-exponent] : wide * s_exactPow10d[exponent];
+    uint64_t wideBits;
+    std::memcpy(&wideBits, &wide, sizeof(wideBits));
+    const bool halfway = (wideBits & ((1ull << 29) - 1)) == (1ull << 28);
+    const bool normal = wide >= static_cast<double>(std::numeric_limits<float>::min()) &&
+                        wide <= static_cast<double>(std::numeric_limits<float>::max());
+    if(!halfway && normal)
+    {
+      const float result = static_cast<float>(wide);
+      o_val = negative ? -result : result;
+      return it;
+    }
+  }
+  o_val = slowParse(_begin, it);
+  return it;
+}
+//-----------------------------------------------------------------------------------------------------
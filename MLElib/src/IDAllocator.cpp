@@ -0,0 +1,46 @@
+#include "IDAllocator.h"
+//-----------------------------------------------------------------------------------------------------
+bool IDAllocator::isUsed(const size_t _id) const
+{
+  return m_used.count(_id) != 0;
+}
+//-----------------------------------------------------------------------------------------------------
+bool IDAllocator::claim(const size_t _id)
+{
+  return m_used.insert(_id).second;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t IDAllocator::allocate()
+{
+  //released IDs are all below m_next, so they win while there are any left
+  while(!m_released.empty())
+  {
+    const size_t id = m_released.top();
+    m_released.pop();
+    if(claim(id))
+      return id;
+  }
+  while(isUsed(m_next)) //skip IDs that were claimed explicitly
+    ++m_next;
+  claim(m_next);
+  return m_next++;
+}
+//-----------------------------------------------------------------------------------------------------
+void IDAllocator::release(const size_t _id)
+{
+  if(m_used.erase(_id) != 0 && _id < m_next)
+    m_released.push(_id);
+}
+//-----------------------------------------------------------------------------------------------------
+void IDAllocator::reserve(const size_t _count)
+{
+  m_used.reserve(_count);
+}
+//-----------------------------------------------------------------------------------------------------
+void IDAllocator::clear()
+{
+  m_used.clear();
+  m_released = decltype(m_released)();
+  m_next = 0;
+}
+//-----------------------------------------------------------------------------------------------------
@@ -1,20 +1,34 @@
 #include "ObjectManager.h"
-#include <iostream>
+#include "SceneWriter.h"
+#include "SceneReader.h"
+#include "SceneArchiveWriter.h"
+#include "SceneArchiveReader.h"
 #include <QFile>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QJsonDocument>
+#include <unordered_map>
 #include <utility>
 //-----------------------------------------------------------------------------------------------------
+namespace
+{
+//-----------------------------------------------------------------------------------------------------
+/// Returns true if both bounds hold exactly the same values
+//-----------------------------------------------------------------------------------------------------
+bool sameBounds(const BaseMesh::Bounds &_a, const BaseMesh::Bounds &_b)
+{
+  return _a.empty == _b.empty && _a.min == _b.min && _a.max == _b.max && _a.centre == _b.centre && _a.radius == _b.radius;
+}
+}
+//-----------------------------------------------------------------------------------------------------
 void ObjectManager::createSceneObject(std::string _name, vec3 _pos, vec3 _rot, vec3 _sc, std::pair<size_t, std::string> _geo, std::pair<size_t, std::string> _mat)
 {
   m_sceneObjects.emplace_back(new SceneObject(_name, _pos, _rot, _sc, _geo, _mat));
+  m_sceneObjects.back()->setDataContainer(m_data);
   checkObjectIDs();
 }
 //-----------------------------------------------------------------------------------------------------
 void ObjectManager::createSceneObject(std::string _name, std::pair<size_t, std::string> _geo, std::pair<size_t, std::string> _mat)
 {
   m_sceneObjects.emplace_back(new SceneObject(_name, _geo, _mat));
+  m_sceneObjects.back()->setDataContainer(m_data);
   checkObjectIDs();
 }
 //-----------------------------------------------------------------------------------------------------
@@ -314,6 +328,59 @@ size_t ObjectManager::getObjectCount() const
   return m_sceneObjects.size();
 }
 //-----------------------------------------------------------------------------------------------------
+void ObjectManager::setDataContainer(DataContainer* io_data)
+{
+  m_data = io_data;
+  for(auto &object : m_sceneObjects)
+    object->setDataContainer(m_data);
+}
+//-----------------------------------------------------------------------------------------------------
+const BaseMesh::Bounds& ObjectManager::worldBoundsAt(size_t _pos) const
+{
+  const SceneObject* object = objectAt(_pos);
+  if(m_worldBounds.size() != m_sceneObjects.size())
+    m_worldBounds.resize(m_sceneObjects.size());
+  WorldBoundsEntry &entry = m_worldBounds[_pos];
+  BaseMesh* mesh = m_data != nullptr ? m_data->geoFind(object->getGeoID()) : nullptr;
+  const BaseMesh::Bounds local = mesh != nullptr ? mesh->getBounds() : BaseMesh::Bounds();
+  //objects removed or inserted before this one shift the vector, so the object itself is checked too
+  if(entry.object != object || entry.stamp != object->getMatrixStamp() || !sameBounds(entry.local, local))
+  {
+    entry.object = object;
+    entry.stamp = object->getMatrixStamp();
+    entry.local = local;
+    entry.world = transformBounds(local, object->getMVmatrix());
+  }
+  return entry.world;
+}
+//-----------------------------------------------------------------------------------------------------
+BaseMesh::Bounds ObjectManager::getWorldBounds(const size_t _id) const
+{
+  for(size_t i=0; i<m_sceneObjects.size(); ++i)
+  {
+    if(m_sceneObjects[i]->getID() == _id)
+      return worldBoundsAt(i);
+  }
+  return BaseMesh::Bounds();
+}
+//-----------------------------------------------------------------------------------------------------
+BaseMesh::Bounds ObjectManager::transformBounds(const BaseMesh::Bounds &_local, const mat4 &_matrix)
+{
+  if(_local.empty)
+    return _local;
+  BaseMesh::Bounds ret;
+  ret.empty = false;
+  const vec3 axes[3] = {vec3(_matrix[0]), vec3(_matrix[1]), vec3(_matrix[2])};
+  const vec3 halfSize = (_local.max - _local.min) * 0.5f;
+  const vec3 centre = vec3(_matrix * vec4((_local.min + _local.max) * 0.5f, 1.f));
+  const vec3 extent = abs(axes[0]) * halfSize.x + abs(axes[1]) * halfSize.y + abs(axes[2]) * halfSize.z;
+  ret.min = centre - extent;
+  ret.max = centre + extent;
+  ret.centre = vec3(_matrix * vec4(_local.centre, 1.f));
+  ret.radius = _local.radius * max(length(axes[0]), max(length(axes[1]), length(axes[2])));
+  return ret;
+}
+//-----------------------------------------------------------------------------------------------------
 void ObjectManager::checkObjectIDs()
 {
   std::vector<size_t> currentUsed = getCurrentIDs();
@@ -359,140 +426,175 @@ std::vector<size_t> ObjectManager::getCurrentIDs()const
   return ret;
 }
 //-----------------------------------------------------------------------------------------------------
-inline std::string stringify(const QJsonValue _jStr)
+void ObjectManager::resetForLoad()
 {
-  return _jStr.toString().toStdString();
+  std::string save = "AutosavedScene";
+  writeRawSceneData(save);
+
+  m_sceneObjects.clear();
+  m_sceneObjects.resize(0);
+  m_selected.clear();
+  m_selected.resize(0);
+  m_worldBounds.clear();
+}
+//-----------------------------------------------------------------------------------------------------
+void ObjectManager::buildFromRecords(const std::vector<SceneRecord> &_records)
+{
+  //stage 1 : construct every object, matrices are left for stage 4
+  const size_t first = m_sceneObjects.size();
+  const size_t count = _records.size();
+  m_sceneObjects.reserve(first + count);
+  for(const auto &record : _records)
+  {
+    m_sceneObjects.emplace_back(new SceneObject(record.name, record.position, record.rotation, record.scale, record.geo, record.mat));
+    m_sceneObjects.back()->changeID(record.id);
+    m_sceneObjects.back()->setActive(record.active);
+    m_sceneObjects.back()->setDataContainer(m_data);
+  }
+  //stage 2 : ID -> slot table, the first object with a duplicated ID wins like the linear lookup did
+  std::unordered_map<size_t, size_t> slotOfID;
+  slotOfID.reserve(count);
+  for(size_t i=0; i<count; ++i)
+    slotOfID.emplace(_records[i].id, i);
+  auto parentSlot = [&](const size_t _slot)
+  {
+    if(!_records[_slot].hasParent)
+      return count;
+    auto found = slotOfID.find(_records[_slot].parent);
+    return found == slotOfID.end() ? count : found->second;
+  };
+  //stage 3 : link every object to its parent once, walking each parent chain only once
+  //objects with a missing parent, or whose parent chain loops back on itself, become roots
+  std::vector<size_t> order; //parents always come before their children
+  order.reserve(count);
+  std::vector<char> state(count, 0); //0 new, 1 on the current chain, 2 linked
+  std::vector<size_t> chain;
+  for(size_t i=0; i<count; ++i)
+  {
+    for(size_t slot=i; slot<count && state[slot]==0; slot=parentSlot(slot))
+    {
+      state[slot] = 1;
+      chain.push_back(slot);
+    }
+    while(!chain.empty())
+    {
+      const size_t slot = chain.back();
+      chain.pop_back();
+      const size_t parent = parentSlot(slot);
+      if(parent < count && state[parent] == 2)
+        m_sceneObjects[first + parent]->linkChild(m_sceneObjects[first + slot].get());
+      state[slot] = 2;
+      order.push_back(slot);
+    }
+  }
+  //stage 4 : world matrices, computed once per object in topological order
+  for(auto slot : order)
+    m_sceneObjects[first + slot]->updateLocalMatrix();
 }
 //-----------------------------------------------------------------------------------------------------
-inline size_t intify(int _jStr)
+void ObjectManager::loadRawSceneData(const std::string &_name)
 {
-  return static_cast<size_t>(_jStr);
+  resetForLoad();
+  // Map the raw file and decode all records
+  SceneReader reader;
+  if(!reader.open("scenes/"+_name+".json"))
+    return;
+  std::vector<SceneRecord> records(1);
+  while(reader.next(records.back()))
+    records.emplace_back();
+  records.pop_back();
+  reader.close();
+  buildFromRecords(records);
+}
+//-----------------------------------------------------------------------------------------------------
+void ObjectManager::loadSceneArchive(const std::string &_name)
+{
+  resetForLoad();
+  SceneArchiveReader reader;
+  if(!reader.open("scenes/"+_name+".mlea"))
+    return;
+  std::vector<SceneRecord> records;
+  if(reader.readAll(records))
+    buildFromRecords(records);
+}
+//-----------------------------------------------------------------------------------------------------
+bool ObjectManager::loadSceneIndex(const std::string &_name, SceneIndex &o_index) const
+{
+  const std::string sceneFile = "scenes/"+_name+".json";
+  const std::string indexFile = "scenes/"+_name+".idx";
+  if(o_index.load(indexFile, SceneIndex::stamp(sceneFile)))
+    return true;
+  //missing or out of date, a single scan of the scene rebuilds it
+  if(!o_index.build(sceneFile))
+    return false;
+  o_index.save(indexFile);
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+void ObjectManager::loadIndexedRoots(const std::string &_name, const std::vector<const SceneIndex::Root*> &_roots)
+{
+  SceneReader reader;
+  if(!reader.open("scenes/"+_name+".json"))
+    return;
+  //only the pages holding the requested spans are ever read from the mapped file
+  std::vector<SceneRecord> records;
+  for(auto root : _roots)
+  {
+    for(const auto &span : root->spans)
+    {
+      if(!reader.readSpan(span.first, span.second, records))
+        return;
+    }
+  }
+  reader.close();
+  buildFromRecords(records);
 }
 //-----------------------------------------------------------------------------------------------------
-inline float floatify(const QJsonValue _jStr)
+void ObjectManager::loadSubtree(const std::string &_name, const size_t _rootID)
 {
-  return static_cast<float>(_jStr.toDouble());
+  //reset first, the autosave may rewrite the very file that is about to be indexed
+  resetForLoad();
+  SceneIndex index;
+  if(!loadSceneIndex(_name, index))
+    return;
+  const SceneIndex::Root* root = index.findRoot(_rootID);
+  if(root != nullptr)
+    loadIndexedRoots(_name, {root});
 }
 //-----------------------------------------------------------------------------------------------------
-vec3 vectorize(const QJsonArray _jStr)
+void ObjectManager::loadRegion(const std::string &_name, const vec3 &_min, const vec3 &_max)
 {
-  auto arrX = _jStr[0];
-  auto arrY = _jStr[1];
-  auto arrZ = _jStr[2];
-  return vec3(floatify(arrX), floatify(arrY), floatify(arrZ));
+  resetForLoad();
+  SceneIndex index;
+  if(!loadSceneIndex(_name, index))
+    return;
+  loadIndexedRoots(_name, index.findRegion(_min, _max));
 }
 //-----------------------------------------------------------------------------------------------------
-void ObjectManager::loadRawSceneData(const std::string &_name)
+void ObjectManager::writeRawSceneData(const std::string &_name) const
 {
-  std::string save = "AutosavedScene";
-  writeRawSceneData(save);
-
-  m_sceneObjects.clear();
-  m_sceneObjects.resize(0);
-  m_selected.clear();
-  m_selected.resize(0);
-
-  // Read in raw file
-  QString fileName = QString::fromStdString("scenes/"+_name+".json");
-  QFile file(fileName);
-  file.open(QIODevice::ReadOnly | QIODevice::Text);
-  QByteArray rawData = file.readAll();
-  // Parse document
-  QJsonDocument doc(QJsonDocument::fromJson(rawData));
-  // Get the json object to view
-  QJsonObject ObjectParts = doc.object();
-  std::vector<std::pair<size_t, size_t>> relations;
-
-  for(auto obj= ObjectParts.begin(); obj!=ObjectParts.end(); ++obj)
-  {
-    auto sceneObject = obj.value().toObject();
-    auto jname = sceneObject["Name"].toString();
-    auto jid = sceneObject["ID"].toInt();
-    bool jactive = sceneObject["Active"].toBool();
-    auto jpos = sceneObject["Position"].toArray();
-    auto jrot = sceneObject["Rotation"].toArray();
-    auto jscale = sceneObject["Scale"].toArray();
-    auto jparent = sceneObject["Parent"].toInt();
-    auto jgeoName = sceneObject["GeometryName"].toString();
-    auto jgeoID = sceneObject["GeometryID"].toInt();
-    std::cout<<jgeoID<<std::endl;
-    auto jmatName = sceneObject["MaterialName"].toString();
-    auto jmatID = sceneObject["MaterialID"].toInt();
-    //now construct an object using retrieved info
-    std::cout<<intify(jmatID)<<stringify(jmatName)<<std::endl;
-    m_sceneObjects.emplace_back(new SceneObject(stringify(jname),
-    vectorize(jpos), vectorize(jrot), vectorize(jscale),
-    std::pair<size_t, std::string>{intify(jgeoID), stringify(jgeoName)}, std::pair<size_t, std::string>{intify(jmatID), stringify(jmatName)}));
-    m_sceneObjects.back()->changeID(intify(jid));
-    m_sceneObjects.back()->setActive(jactive);
-    //do not assign relations at this point (not all objects constructed yet)
-    //but save for later
-    if(jparent != QJsonValue::Null)
-    {
-      relations.push_back(std::pair<size_t,size_t>(intify(jparent),intify(jid)));
-    }
-    //make sure to update matrix at this point ot else all objects will have default matrix
-    m_sceneObjects.back()->updateMatrix();
-  }
-  //here all objects should be ready for connection
-  for(auto rel : relations)
+  //the sidecar index of the old file no longer matches
+  QFile::remove(QString::fromStdString("scenes/"+_name+".idx"));
+  SceneWriter writer;
+  if(!writer.open("scenes/"+_name+".json"))
+    return;
+  //objects are streamed in storage order, nothing but the write buffer is kept in memory
+  for(auto obj= m_sceneObjects.begin(); obj<m_sceneObjects.end(); ++obj)
   {
-    //calling addChild also calls add parent in the child, so no need for extra code here
-    getObject(rel.first)->addChild(getObject(rel.second));
+    writer.writeObject(*obj->get());
   }
-  file.close();
+  writer.close();
 }
 //-----------------------------------------------------------------------------------------------------
-void ObjectManager::writeRawSceneData(const std::string &_name) const
+void ObjectManager::writeSceneArchive(const std::string &_name, const size_t _chunkSize) const
 {
-  // Read in raw file
-  QString fileName = QString::fromStdString("scenes/"+_name+".json");
-  QFile file(fileName);
-  file.open(QIODevice::WriteOnly | QIODevice::Text);
-  //write to file below
-
-  // Get the json object to view
-  QJsonObject ObjectParts;
-  size_t i=0;
+  SceneArchiveWriter writer;
+  if(!writer.open("scenes/"+_name+".mlea", _chunkSize))
+    return;
   for(auto obj= m_sceneObjects.begin(); obj<m_sceneObjects.end(); ++obj)
   {
-    auto sceneObject = QJsonObject();
-    sceneObject["Name"] = QString::fromStdString(obj->get()->getName());
-    sceneObject["ID"] = static_cast<qint32>(obj->get()->getID());
-    bool boolText = obj->get()->isActive() ? true : false;
-    sceneObject["Active"] = boolText;
-    QJsonArray pos;
-    pos.append(static_cast<double>(obj->get()->getPosition().x));
-    pos.append(static_cast<double>(obj->get()->getPosition().y));
-    pos.append(static_cast<double>(obj->get()->getPosition().z));
-    sceneObject["Position"] = pos;
-    QJsonArray rot;
-    rot.append(static_cast<double>(obj->get()->getRotation().x));
-    rot.append(static_cast<double>(obj->get()->getRotation().y));
-    rot.append(static_cast<double>(obj->get()->getRotation().z));
-    sceneObject["Rotation"] = rot;
-    QJsonArray scale;
-    scale.append(static_cast<double>(obj->get()->getScale().x));
-    scale.append(static_cast<double>(obj->get()->getScale().y));
-    scale.append(static_cast<double>(obj->get()->getScale().z));
-    sceneObject["Scale"] = scale;
-    if(obj->get()->getParent() != nullptr)
-    {
-      sceneObject["Parent"] = static_cast<qint32>(obj->get()->getParent()->getID());
-    }
-    else
-    {
-      sceneObject["Parent"] = QJsonValue::Null;
-    }
-    sceneObject["GeometryName"] = QString::fromStdString(obj->get()->getGeoName());
-    sceneObject["GeometryID"] = static_cast<qint32>(obj->get()->getGeoID());
-    sceneObject["MaterialName"] = QString::fromStdString(obj->get()->getMatName());
-    sceneObject["MaterialID"] = static_cast<qint32>(obj->get()->getMatID());
-    ObjectParts["Object"+QString::fromStdString(std::to_string(i))] = sceneObject;
-    ++i;
-  }
-  QJsonDocument doc(ObjectParts);
-  file.write(doc.toJson());
-  file.close();
+    writer.writeObject(*obj->get());
+  }
+  writer.close();
 }
 //-----------------------------------------------------------------------------------------------------
@@ -0,0 +1,149 @@
+#include "SceneArchiveReader.h"
+#include "SceneReader.h"
+#include "ThreadPool.h"
+#include <QtEndian>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+//-----------------------------------------------------------------------------------------------------
+SceneArchiveReader::~SceneArchiveReader()
+{
+  close();
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneArchiveReader::open(const std::string &_fileName)
+{
+  using namespace SceneArchiveFormat;
+  close();
+  m_file.setFileName(QString::fromStdString(_fileName));
+  if(!m_file.open(QIODevice::ReadOnly))
+    return false;
+  m_size = static_cast<quint64>(m_file.size());
+  if(m_size >= s_headerSize + 4 + s_footerSize)
+    m_map = m_file.map(0, m_file.size());
+  if(m_map == nullptr)
+  {
+    close();
+    return false;
+  }
+  //header and footer
+  const uchar* footer = m_map + m_size - s_footerSize;
+  const quint64 indexOffset = qFromLittleEndian<quint64>(footer);
+  if(std::memcmp(m_map, s_headerMagic, 4) != 0 || qFromLittleEndian<quint32>(m_map + 4) != s_version ||
+     std::memcmp(footer + 8, s_footerMagic, 4) != 0 || indexOffset < s_headerSize || indexOffset + 4 > m_size - s_footerSize)
+  {
+    close();
+    return false;
+  }
+  //chunk index
+  const uchar* it = m_map + indexOffset;
+  const quint32 count = qFromLittleEndian<quint32>(it);
+  it += 4;
+  if(count > (m_size - s_footerSize - indexOffset - 4) / s_entrySize)
+  {
+    close();
+    return false;
+  }
+  m_chunks.resize(count);
+  for(auto &chunk : m_chunks)
+  {
+    chunk.offset = qFromLittleEndian<quint64>(it);
+    chunk.size = qFromLittleEndian<quint32>(it + 8);
+    chunk.objectCount = qFromLittleEndian<quint32>(it + 12);
+    chunk.minID = qFromLittleEndian<quint64>(it + 16);
+    chunk.maxID = qFromLittleEndian<quint64>(it + 24);
+    it += s_entrySize;
+    if(chunk.offset < s_headerSize || chunk.offset + chunk.size > indexOffset)
+    {
+      close();
+      return false;
+    }
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneArchiveReader::close()
+{
+  if(m_map != nullptr)
+    m_file.unmap(m_map);
+  m_map = nullptr;
+  m_size = 0;
+  m_chunks.clear();
+  if(m_file.isOpen())
+    m_file.close();
+}
+//-----------------------------------------------------------------------------------------------------
+size_t SceneArchiveReader::chunkCount() const
+{
+  return m_chunks.size();
+}
+//-----------------------------------------------------------------------------------------------------
+const SceneArchiveFormat::Chunk& SceneArchiveReader::chunk(const size_t _pos) const
+{
+  return m_chunks.at(_pos);
+}
+//-----------------------------------------------------------------------------------------------------
+std::vector<size_t> SceneArchiveReader::chunksWithID(const size_t _id) const
+{
+  std::vector<size_t> ret;
+  for(size_t i=0; i<m_chunks.size(); ++i)
+  {
+    if(m_chunks[i].minID <= _id && _id <= m_chunks[i].maxID)
+      ret.push_back(i);
+  }
+  return ret;
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneArchiveReader::readChunk(const size_t _pos, std::vector<SceneRecord> &io_records) const
+{
+  if(_pos >= m_chunks.size())
+    return false;
+  const auto &chunk = m_chunks[_pos];
+  const QByteArray text = qUncompress(m_map + chunk.offset, static_cast<int>(chunk.size));
+  SceneReader reader;
+  if(chunk.objectCount > static_cast<size_t>(text.size()) || !reader.open(text.constData(), text.constData() + text.size()))
+    return false;
+  const size_t first = io_records.size();
+  io_records.resize(first + chunk.objectCount);
+  size_t count = 0;
+  while(count < chunk.objectCount && reader.next(io_records[first + count]))
+    ++count;
+  if(count != chunk.objectCount)
+  {
+    io_records.resize(first);
+    return false;
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneArchiveReader::readChunks(const std::vector<size_t> &_chunks, std::vector<SceneRecord> &io_records) const
+{
+  //every chunk decodes into its own vector, so the workers never share anything
+  std::vector<std::vector<SceneRecord>> decoded(_chunks.size());
+  std::vector<char> ok(_chunks.size(), 0);
+  ThreadPool::instance().parallelFor(_chunks.size(), [&](size_t _begin, size_t _end)
+  {
+    for(size_t i=_begin; i<_end; ++i)
+      ok[i] = readChunk(_chunks[i], decoded[i]);
+  });
+  size_t total = io_records.size();
+  for(size_t i=0; i<decoded.size(); ++i)
+  {
+    if(!ok[i])
+      return false;
+    total += decoded[i].size();
+  }
+  io_records.reserve(total);
+  for(auto &records : decoded)
+    std::move(records.begin(), records.end(), std::back_inserter(io_records));
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneArchiveReader::readAll(std::vector<SceneRecord> &io_records) const
+{
+  std::vector<size_t> all(m_chunks.size());
+  for(size_t i=0; i<all.size(); ++i)
+    all[i] = i;
+  return readChunks(all, io_records);
+}
+//-----------------------------------------------------------------------------------------------------
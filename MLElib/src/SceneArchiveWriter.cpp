@@ -0,0 +1,103 @@
+#include "SceneArchiveWriter.h"
+#include <QtEndian>
+#include <algorithm>
+//-----------------------------------------------------------------------------------------------------
+namespace
+{
+//-----------------------------------------------------------------------------------------------------
+template<typename T>
+void appendLittleEndian(QByteArray &io_data, const T _val)
+{
+  char bytes[sizeof(T)];
+  qToLittleEndian<T>(_val, bytes);
+  io_data.append(bytes, static_cast<int>(sizeof(T)));
+}
+}
+//-----------------------------------------------------------------------------------------------------
+SceneArchiveWriter::~SceneArchiveWriter()
+{
+  close();
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneArchiveWriter::open(const std::string &_fileName, const size_t _chunkSize)
+{
+  close();
+  m_file.setFileName(QString::fromStdString(_fileName));
+  if(!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return false;
+  m_chunkSize = std::max<size_t>(1, _chunkSize);
+  m_chunks.clear();
+  m_failed = false;
+  QByteArray header(SceneArchiveFormat::s_headerMagic, 4);
+  appendLittleEndian<quint32>(header, SceneArchiveFormat::s_version);
+  m_failed = m_file.write(header) != header.size();
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneArchiveWriter::writeObject(const SceneObject &_obj)
+{
+  m_record.fromObject(_obj);
+  writeRecord(m_record);
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneArchiveWriter::writeRecord(const SceneRecord &_record)
+{
+  if(!m_textDevice.isOpen())
+  {
+    //start a new chunk
+    m_chunks.emplace_back();
+    m_chunks.back().minID = _record.id;
+    m_chunks.back().maxID = _record.id;
+    m_text.clear();
+    m_textDevice.setBuffer(&m_text);
+    m_textDevice.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    m_chunkWriter.open(&m_textDevice);
+  }
+  m_chunkWriter.writeRecord(_record);
+  auto &chunk = m_chunks.back();
+  chunk.minID = std::min<quint64>(chunk.minID, _record.id);
+  chunk.maxID = std::max<quint64>(chunk.maxID, _record.id);
+  if(++chunk.objectCount == m_chunkSize)
+    writeChunk();
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneArchiveWriter::close()
+{
+  if(!m_file.isOpen())
+    return false;
+  if(m_textDevice.isOpen())
+    writeChunk();
+  //index and footer
+  const quint64 indexOffset = static_cast<quint64>(m_file.pos());
+  QByteArray index;
+  index.reserve(static_cast<int>(4 + m_chunks.size() * SceneArchiveFormat::s_entrySize + SceneArchiveFormat::s_footerSize));
+  appendLittleEndian<quint32>(index, static_cast<quint32>(m_chunks.size()));
+  for(const auto &chunk : m_chunks)
+  {
+    appendLittleEndian<quint64>(index, chunk.offset);
+    appendLittleEndian<quint32>(index, chunk.size);
+    appendLittleEndian<quint32>(index, chunk.objectCount);
+    appendLittleEndian<quint64>(index, chunk.minID);
+    appendLittleEndian<quint64>(index, chunk.maxID);
+  }
+  appendLittleEndian<quint64>(index, indexOffset);
+  index.append(SceneArchiveFormat::s_footerMagic, 4);
+  if(m_file.write(index) != index.size())
+    m_failed = true;
+  m_file.close();
+  m_chunks.clear();
+  return !m_failed;
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneArchiveWriter::writeChunk()
+{
+  m_chunkWriter.close();
+  m_textDevice.close();
+  const QByteArray packed = qCompress(m_text);
+  auto &chunk = m_chunks.back();
+  chunk.offset = static_cast<quint64>(m_file.pos());
+  chunk.size = static_cast<quint32>(packed.size());
+  if(m_file.write(packed) != packed.size())
+    m_failed = true;
+}
+//-----------------------------------------------------------------------------------------------------
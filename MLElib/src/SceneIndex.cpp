@@ -0,0 +1,283 @@
+#include "SceneIndex.h"
+#include "SceneReader.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QtEndian>
+#include <unordered_map>
+#include <cstring>
+//-----------------------------------------------------------------------------------------------------
+namespace
+{
+//-----------------------------------------------------------------------------------------------------
+constexpr char s_magic[4] = {'M','L','E','X'};
+constexpr quint32 s_version = 2;
+//-----------------------------------------------------------------------------------------------------
+template<typename T>
+void appendLittleEndian(QByteArray &io_data, const T _val)
+{
+  char bytes[sizeof(T)];
+  qToLittleEndian<T>(_val, bytes);
+  io_data.append(bytes, static_cast<int>(sizeof(T)));
+}
+//-----------------------------------------------------------------------------------------------------
+void appendVector(QByteArray &io_data, const glm::vec3 &_vec)
+{
+  const float components[3] = {_vec.x, _vec.y, _vec.z};
+  for(auto component : components)
+  {
+    quint32 bits;
+    std::memcpy(&bits, &component, sizeof(bits));
+    appendLittleEndian<quint32>(io_data, bits);
+  }
+}
+//-----------------------------------------------------------------------------------------------------
+/// Bounds checked reads from the loaded index data
+//-----------------------------------------------------------------------------------------------------
+struct IndexCursor
+{
+  const uchar* it;
+  const uchar* end;
+  //-----------------------------------------------------------------------------------------------------
+  template<typename T>
+  bool read(T &o_val)
+  {
+    if(static_cast<size_t>(end - it) < sizeof(T))
+      return false;
+    o_val = qFromLittleEndian<T>(it);
+    it += sizeof(T);
+    return true;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool readVector(glm::vec3 &o_vec)
+  {
+    float components[3];
+    for(auto &component : components)
+    {
+      quint32 bits;
+      if(!read(bits))
+        return false;
+      std::memcpy(&component, &bits, sizeof(bits));
+    }
+    o_vec = glm::vec3(components[0], components[1], components[2]);
+    return true;
+  }
+};
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneIndex::build(const std::string &_sceneFile)
+{
+  m_roots.clear();
+  //stamped before reading, so a write that lands during the scan makes the index out of date
+  m_scene = stamp(_sceneFile);
+  SceneReader reader;
+  if(!reader.open(_sceneFile))
+    return false;
+  //first pass, everything the hierarchy needs from every object
+  struct Entry
+  {
+    size_t id;
+    size_t parent;
+    bool hasParent;
+    glm::mat4 local;
+    std::pair<size_t, size_t> span;
+  };
+  std::vector<Entry> entries;
+  std::unordered_map<size_t, size_t> slotOfID;
+  SceneRecord record;
+  while(reader.next(record))
+  {
+    slotOfID.emplace(record.id, entries.size()); //the first object with a duplicated ID wins
+    entries.push_back({record.id, record.parent, record.hasParent, BaseObject::composeMatrix(record.position, record.rotation, record.scale), reader.recordSpan()});
+  }
+  reader.close();
+
+  //world matrices and roots, every parent chain is walked once
+  const size_t count = entries.size();
+  std::vector<glm::mat4> world(count);
+  std::vector<size_t> root(count);
+  std::vector<char> state(count, 0); //0 new, 1 on the current chain, 2 done
+  std::vector<size_t> chain;
+  auto parentSlot = [&](const size_t _slot)
+  {
+    if(!entries[_slot].hasParent)
+      return count;
+    auto found = slotOfID.find(entries[_slot].parent);
+    return found == slotOfID.end() ? count : found->second;
+  };
+  for(size_t i=0; i<count; ++i)
+  {
+    for(size_t slot=i; slot<count && state[slot]==0; slot=parentSlot(slot))
+    {
+      state[slot] = 1;
+      chain.push_back(slot);
+    }
+    //unwind from the top, an object whose parent is missing or on the chain (a cycle) becomes a root
+    while(!chain.empty())
+    {
+      const size_t slot = chain.back();
+      chain.pop_back();
+      const size_t parent = parentSlot(slot);
+      if(parent < count && state[parent] == 2)
+      {
+        world[slot] = world[parent] * entries[slot].local;
+        root[slot] = root[parent];
+      }
+      else
+      {
+        world[slot] = entries[slot].local;
+        root[slot] = slot;
+      }
+      state[slot] = 2;
+    }
+  }
+
+  //group objects by root, merging spans of objects that follow each other in the file
+  std::unordered_map<size_t, size_t> rootEntries;
+  std::vector<size_t> lastObject;
+  for(size_t i=0; i<count; ++i)
+  {
+    const glm::vec3 origin(world[i][3].x, world[i][3].y, world[i][3].z);
+    auto inserted = rootEntries.emplace(root[i], m_roots.size());
+    if(inserted.second)
+    {
+      m_roots.emplace_back();
+      m_roots.back().id = entries[root[i]].id;
+      m_roots.back().min = origin;
+      m_roots.back().max = origin;
+      lastObject.push_back(i);
+      m_roots.back().spans.push_back(entries[i].span);
+      continue;
+    }
+    const size_t r = inserted.first->second;
+    auto &entry = m_roots[r];
+    entry.min = glm::min(entry.min, origin);
+    entry.max = glm::max(entry.max, origin);
+    if(lastObject[r] + 1 == i)
+      entry.spans.back().second = entries[i].span.second;
+    else
+      entry.spans.push_back(entries[i].span);
+    lastObject[r] = i;
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneIndex::save(const std::string &_indexFile) const
+{
+  QByteArray data(s_magic, 4);
+  appendLittleEndian<quint32>(data, s_version);
+  appendLittleEndian<quint64>(data, m_scene.size);
+  appendLittleEndian<qint64>(data, m_scene.modified);
+  appendLittleEndian<quint32>(data, static_cast<quint32>(m_roots.size()));
+  for(const auto &root : m_roots)
+  {
+    appendLittleEndian<quint64>(data, root.id);
+    appendVector(data, root.min);
+    appendVector(data, root.max);
+    appendLittleEndian<quint32>(data, static_cast<quint32>(root.spans.size()));
+    for(const auto &span : root.spans)
+    {
+      appendLittleEndian<quint64>(data, span.first);
+      appendLittleEndian<quint64>(data, span.second);
+    }
+  }
+  QFile file(QString::fromStdString(_indexFile));
+  if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return false;
+  const bool ok = file.write(data) == data.size();
+  file.close();
+  return ok;
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneIndex::load(const std::string &_indexFile, const Stamp &_scene)
+{
+  m_roots.clear();
+  m_scene = Stamp();
+  QFile file(QString::fromStdString(_indexFile));
+  if(!file.open(QIODevice::ReadOnly))
+    return false;
+  const QByteArray data = file.readAll();
+  file.close();
+  const uchar* begin = reinterpret_cast<const uchar*>(data.constData());
+  IndexCursor cursor{begin, begin + data.size()};
+  quint32 version = 0;
+  Stamp scene;
+  quint32 rootCount = 0;
+  if(data.size() < 4 || std::memcmp(begin, s_magic, 4) != 0)
+    return false;
+  cursor.it += 4;
+  if(!cursor.read(version) || version != s_version || !cursor.read(scene.size) || !cursor.read(scene.modified) || scene != _scene ||
+     !cursor.read(rootCount))
+    return false;
+  if(rootCount > static_cast<size_t>(cursor.end - cursor.it) / 36) //smallest possible entry
+    return false;
+  std::vector<Root> roots(rootCount);
+  for(auto &root : roots)
+  {
+    quint64 id;
+    quint32 spanCount;
+    if(!cursor.read(id) || !cursor.readVector(root.min) || !cursor.readVector(root.max) || !cursor.read(spanCount))
+      return false;
+    root.id = static_cast<size_t>(id);
+    if(spanCount > static_cast<size_t>(cursor.end - cursor.it) / 16)
+      return false;
+    root.spans.resize(spanCount);
+    for(auto &span : root.spans)
+    {
+      quint64 first, second;
+      cursor.read(first);
+      cursor.read(second);
+      if(first > second || second > scene.size)
+        return false;
+      span = {static_cast<size_t>(first), static_cast<size_t>(second)};
+    }
+  }
+  m_roots = std::move(roots);
+  m_scene = scene;
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+const SceneIndex::Root* SceneIndex::findRoot(const size_t _id) const
+{
+  for(const auto &root : m_roots)
+  {
+    if(root.id == _id)
+      return &root;
+  }
+  return nullptr;
+}
+//-----------------------------------------------------------------------------------------------------
+std::vector<const SceneIndex::Root*> SceneIndex::findRegion(const glm::vec3 &_min, const glm::vec3 &_max) const
+{
+  std::vector<const Root*> ret;
+  for(const auto &root : m_roots)
+  {
+    if(root.min.x <= _max.x && root.max.x >= _min.x &&
+       root.min.y <= _max.y && root.max.y >= _min.y &&
+       root.min.z <= _max.z && root.max.z >= _min.z)
+      ret.push_back(&root);
+  }
+  return ret;
+}
+//-----------------------------------------------------------------------------------------------------
+const std::vector<SceneIndex::Root>& SceneIndex::roots() const
+{
+  return m_roots;
+}
+//-----------------------------------------------------------------------------------------------------
+SceneIndex::Stamp SceneIndex::sceneStamp() const
+{
+  return m_scene;
+}
+//-----------------------------------------------------------------------------------------------------
+SceneIndex::Stamp SceneIndex::stamp(const std::string &_fileName)
+{
+  Stamp ret;
+  const QFileInfo info(QString::fromStdString(_fileName));
+  if(!info.exists())
+    return ret;
+  ret.size = static_cast<quint64>(info.size());
+  ret.modified = info.lastModified().toMSecsSinceEpoch();
+  return ret;
+}
+//-----------------------------------------------------------------------------------------------------
@@ -1,5 +1,25 @@
 #include "SceneObject.h"
 //-----------------------------------------------------------------------------------------------------
+SceneObject::~SceneObject()
+{
+  setDataContainer(nullptr);
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneObject::setDataContainer(DataContainer* io_data)
+{
+  if(m_data != nullptr)
+  {
+    m_data->geoRelease(m_geometry.first);
+    m_data->matRelease(m_material.first);
+  }
+  m_data = io_data;
+  if(m_data != nullptr)
+  {
+    m_data->geoAddRef(m_geometry.first);
+    m_data->matAddRef(m_material.first);
+  }
+}
+//-----------------------------------------------------------------------------------------------------
 void SceneObject::reset()
 {
   m_pos=vec3(0,0,0);
@@ -28,11 +48,21 @@ size_t SceneObject::getID () const
 //-----------------------------------------------------------------------------------------------------
 void SceneObject::setGeo(std::pair<size_t, std::string> &_new)
 {
+  if(m_data != nullptr)
+  {
+    m_data->geoAddRef(_new.first);
+    m_data->geoRelease(m_geometry.first);
+  }
   m_geometry = _new;
 }
 //-----------------------------------------------------------------------------------------------------
 void SceneObject::setMat(std::pair<size_t, std::string> &_new)
 {
+  if(m_data != nullptr)
+  {
+    m_data->matAddRef(_new.first);
+    m_data->matRelease(m_material.first);
+  }
   m_material = _new;
 }
 //-----------------------------------------------------------------------------------------------------
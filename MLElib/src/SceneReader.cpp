@@ -0,0 +1,364 @@
+#include "SceneReader.h"
+#include "FloatConversion.h"
+#include <cstring>
+//-----------------------------------------------------------------------------------------------------
+namespace
+{
+//-----------------------------------------------------------------------------------------------------
+/// Minimal json cursor, only what the scene schema needs
+//-----------------------------------------------------------------------------------------------------
+struct JsonCursor
+{
+  const char* it;
+  const char* end;
+  //-----------------------------------------------------------------------------------------------------
+  void skipSpace()
+  {
+    while(it < end && (*it == ' ' || *it == '\n' || *it == '\r' || *it == '\t'))
+      ++it;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool expect(const char _c)
+  {
+    skipSpace();
+    if(it < end && *it == _c)
+    {
+      ++it;
+      return true;
+    }
+    return false;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool literal(const char* _word)
+  {
+    skipSpace();
+    const size_t len = std::strlen(_word);
+    if(static_cast<size_t>(end - it) >= len && std::memcmp(it, _word, len) == 0)
+    {
+      it += len;
+      return true;
+    }
+    return false;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  void appendUtf8(std::string &o_str, const unsigned _code)
+  {
+    if(_code < 0x80)
+    {
+      o_str += static_cast<char>(_code);
+    }
+    else if(_code < 0x800)
+    {
+      o_str += static_cast<char>(0xC0 | (_code >> 6));
+      o_str += static_cast<char>(0x80 | (_code & 0x3F));
+    }
+    else if(_code < 0x10000)
+    {
+      o_str += static_cast<char>(0xE0 | (_code >> 12));
+      o_str += static_cast<char>(0x80 | ((_code >> 6) & 0x3F));
+      o_str += static_cast<char>(0x80 | (_code & 0x3F));
+    }
+    else
+    {
+      o_str += static_cast<char>(0xF0 | (_code >> 18));
+      o_str += static_cast<char>(0x80 | ((_code >> 12) & 0x3F));
+      o_str += static_cast<char>(0x80 | ((_code >> 6) & 0x3F));
+      o_str += static_cast<char>(0x80 | (_code & 0x3F));
+    }
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool readHex(unsigned &o_code)
+  {
+    if(end - it < 4)
+      return false;
+    o_code = 0;
+    for(int i = 0; i < 4; ++i, ++it)
+    {
+      o_code <<= 4;
+      if(*it >= '0' && *it <= '9') o_code |= static_cast<unsigned>(*it - '0');
+      else if(*it >= 'a' && *it <= 'f') o_code |= static_cast<unsigned>(*it - 'a' + 10);
+      else if(*it >= 'A' && *it <= 'F') o_code |= static_cast<unsigned>(*it - 'A' + 10);
+      else return false;
+    }
+    return true;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool readString(std::string &o_str)
+  {
+    if(!expect('"'))
+      return false;
+    o_str.clear();
+    while(it < end)
+    {
+      //copy runs of plain characters in one go
+      const char* run = it;
+      while(it < end && *it != '"' && *it != '\\')
+        ++it;
+      o_str.append(run, static_cast<size_t>(it - run));
+      if(it == end)
+        return false;
+      if(*it++ == '"')
+        return true;
+      if(it == end)
+        return false;
+      switch(*it++)
+      {
+        case '"' : {o_str += '"'; break;}
+        case '\\' : {o_str += '\\'; break;}
+        case '/' : {o_str += '/'; break;}
+        case 'b' : {o_str += '\b'; break;}
+        case 'f' : {o_str += '\f'; break;}
+        case 'n' : {o_str += '\n'; break;}
+        case 'r' : {o_str += '\r'; break;}
+        case 't' : {o_str += '\t'; break;}
+        case 'u' :
+        {
+          unsigned code;
+          if(!readHex(code))
+            return false;
+          if(code >= 0xD800 && code < 0xDC00 && end - it >= 6 && it[0] == '\\' && it[1] == 'u')
+          {
+            //surrogate pair
+            it += 2;
+            unsigned low;
+            if(!readHex(low))
+              return false;
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          }
+          appendUtf8(o_str, code);
+          break;
+        }
+        default : return false;
+      }
+    }
+    return false;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool readFloat(float &o_val)
+  {
+    skipSpace();
+    if(literal("null"))
+    {
+      o_val = 0.0f;
+      return true;
+    }
+    const char* next = FloatConversion::parseFloat(it, end, o_val);
+    if(next == it)
+      return false;
+    it = next;
+    return true;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool readID(size_t &o_val)
+  {
+    skipSpace();
+    if(it == end || *it < '0' || *it > '9')
+      return false;
+    o_val = 0;
+    for(; it < end && *it >= '0' && *it <= '9'; ++it)
+      o_val = o_val * 10 + static_cast<size_t>(*it - '0');
+    return true;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool readBool(bool &o_val)
+  {
+    if(literal("true"))
+      o_val = true;
+    else if(literal("false"))
+      o_val = false;
+    else
+      return false;
+    return true;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool readVector(vec3 &o_vec)
+  {
+    return expect('[') && readFloat(o_vec.x) && expect(',') && readFloat(o_vec.y) && expect(',') && readFloat(o_vec.z) && expect(']');
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool skipValue()
+  {
+    skipSpace();
+    if(it == end)
+      return false;
+    if(*it == '"')
+    {
+      std::string ignored;
+      return readString(ignored);
+    }
+    if(*it == '{' || *it == '[')
+    {
+      const char close = *it == '{' ? '}' : ']';
+      ++it;
+      if(expect(close))
+        return true;
+      do
+      {
+        if(close == '}')
+        {
+          std::string ignored;
+          if(!readString(ignored) || !expect(':'))
+            return false;
+        }
+        if(!skipValue())
+          return false;
+      } while(expect(','));
+      return expect(close);
+    }
+    //number or literal
+    while(it < end && *it != ',' && *it != '}' && *it != ']' && *it != ' ' && *it != '\n' && *it != '\r' && *it != '\t')
+      ++it;
+    return true;
+  }
+  //-----------------------------------------------------------------------------------------------------
+  bool readRecord(SceneRecord &o_record, std::string &io_key)
+  {
+    if(!expect('{'))
+      return false;
+    //keys the object leaves out take their defaults, not the values of the record read before
+    o_record.reset();
+    if(expect('}'))
+      return true;
+    do
+    {
+      if(!readString(io_key) || !expect(':'))
+        return false;
+      bool ok;
+      if(io_key == "Name") ok = readString(o_record.name);
+      else if(io_key == "ID") ok = readID(o_record.id);
+      else if(io_key == "Active") ok = readBool(o_record.active);
+      else if(io_key == "Position") ok = readVector(o_record.position);
+      else if(io_key == "Rotation") ok = readVector(o_record.rotation);
+      else if(io_key == "Scale") ok = readVector(o_record.scale);
+      else if(io_key == "GeometryName") ok = readString(o_record.geo.second);
+      else if(io_key == "GeometryID") ok = readID(o_record.geo.first);
+      else if(io_key == "MaterialName") ok = readString(o_record.mat.second);
+      else if(io_key == "MaterialID") ok = readID(o_record.mat.first);
+      else if(io_key == "Parent")
+      {
+        o_record.hasParent = !literal("null");
+        ok = !o_record.hasParent || readID(o_record.parent);
+      }
+      else ok = skipValue(); //unknown keys are ignored
+      if(!ok)
+        return false;
+    } while(expect(','));
+    return expect('}');
+  }
+};
+}
+//-----------------------------------------------------------------------------------------------------
+SceneReader::~SceneReader()
+{
+  close();
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneReader::open(const std::string &_fileName)
+{
+  close();
+  m_file.setFileName(QString::fromStdString(_fileName));
+  if(!m_file.open(QIODevice::ReadOnly))
+    return false;
+  if(m_file.size() > 0)
+    m_map = m_file.map(0, m_file.size());
+  if(m_map == nullptr)
+  {
+    close();
+    return false;
+  }
+  const char* text = reinterpret_cast<const char*>(m_map);
+  if(!open(text, text + m_file.size()))
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneReader::open(const char* _begin, const char* _end)
+{
+  JsonCursor cursor{_begin, _end};
+  if(!cursor.expect('{'))
+  {
+    m_done = true;
+    return false;
+  }
+  m_done = cursor.expect('}');
+  m_begin = _begin;
+  m_it = cursor.it;
+  m_end = _end;
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneReader::next(SceneRecord &o_record)
+{
+  if(m_done)
+    return false;
+  JsonCursor cursor{m_it, m_end};
+  std::string key;
+  if(!cursor.readString(key) || !cursor.expect(':'))
+  {
+    m_done = true;
+    return false;
+  }
+  cursor.skipSpace();
+  m_span.first = static_cast<size_t>(cursor.it - m_begin);
+  if(!cursor.readRecord(o_record, key))
+  {
+    m_done = true;
+    return false;
+  }
+  m_span.second = static_cast<size_t>(cursor.it - m_begin);
+  //either another object follows or the document ends
+  if(!cursor.expect(','))
+  {
+    cursor.expect('}');
+    m_done = true;
+  }
+  m_it = cursor.it;
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+std::pair<size_t, size_t> SceneReader::recordSpan() const
+{
+  return m_span;
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneReader::readSpan(const size_t _begin, const size_t _end, std::vector<SceneRecord> &io_records) const
+{
+  if(m_begin == nullptr || _begin > _end || _end > static_cast<size_t>(m_end - m_begin))
+    return false;
+  JsonCursor cursor{m_begin + _begin, m_begin + _end};
+  std::string key;
+  do
+  {
+    io_records.emplace_back();
+    if(!cursor.readRecord(io_records.back(), key))
+    {
+      io_records.pop_back();
+      return false;
+    }
+    //objects inside the range are separated by the key of the next object
+  } while(cursor.expect(',') && cursor.readString(key) && cursor.expect(':'));
+  cursor.skipSpace();
+  return cursor.it == cursor.end;
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneReader::close()
+{
+  if(m_map != nullptr)
+    m_file.unmap(m_map);
+  m_map = nullptr;
+  m_begin = m_it = m_end = nullptr;
+  m_done = true;
+  if(m_file.isOpen())
+    m_file.close();
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneReader::parseRecord(const char* _begin, const char* _end, SceneRecord &o_record)
+{
+  JsonCursor cursor{_begin, _end};
+  std::string key;
+  return cursor.readRecord(o_record, key);
+}
+//-----------------------------------------------------------------------------------------------------
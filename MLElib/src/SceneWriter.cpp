@@ -0,0 +1,205 @@
+#include "SceneWriter.h"
+#include "FloatConversion.h"
+#include <cstdio>
+#include <cstdlib>
+#include <clocale>
+//-----------------------------------------------------------------------------------------------------
+SceneWriter::~SceneWriter()
+{
+  close();
+}
+//-----------------------------------------------------------------------------------------------------
+bool SceneWriter::open(const std::string &_fileName)
+{
+  close();
+  m_file.setFileName(QString::fromStdString(_fileName));
+  if(!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    return false;
+  open(&m_file);
+  return true;
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::open(QIODevice* _device)
+{
+  if(m_device != _device)
+    close();
+  m_device = _device;
+  m_count = 0;
+  m_buffer.clear();
+  m_buffer.reserve(s_flushSize + 4096); //one object never exceeds the slack, so the buffer never reallocates
+  m_buffer += "{\n";
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::writeObject(const SceneObject &_obj)
+{
+  m_record.fromObject(_obj);
+  writeRecord(m_record);
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::writeRecord(const SceneRecord &_record)
+{
+  if(m_count != 0)
+    m_buffer += ",\n";
+  //keys are written in the same (sorted) order that QJsonDocument would use
+  m_buffer += "    \"Object";
+  appendInt(m_count);
+  m_buffer += "\": {\n";
+  appendKey("Active");
+  m_buffer += _record.active ? "true" : "false";
+  m_buffer += ",\n";
+  appendKey("GeometryID");
+  appendInt(_record.geo.first);
+  m_buffer += ",\n";
+  appendKey("GeometryName");
+  appendString(_record.geo.second);
+  m_buffer += ",\n";
+  appendKey("ID");
+  appendInt(_record.id);
+  m_buffer += ",\n";
+  appendKey("MaterialID");
+  appendInt(_record.mat.first);
+  m_buffer += ",\n";
+  appendKey("MaterialName");
+  appendString(_record.mat.second);
+  m_buffer += ",\n";
+  appendKey("Name");
+  appendString(_record.name);
+  m_buffer += ",\n";
+  appendKey("Parent");
+  if(_record.hasParent)
+    appendInt(_record.parent);
+  else
+    m_buffer += "null";
+  m_buffer += ",\n";
+  appendKey("Position");
+  appendVector(_record.position);
+  m_buffer += ",\n";
+  appendKey("Rotation");
+  appendVector(_record.rotation);
+  m_buffer += ",\n";
+  appendKey("Scale");
+  appendVector(_record.scale);
+  m_buffer += "\n    }";
+  ++m_count;
+
+  if(m_buffer.size() >= s_flushSize)
+    flush();
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::close()
+{
+  if(m_device == nullptr)
+    return;
+  m_buffer += m_count != 0 ? "\n}\n" : "}\n";
+  flush();
+  if(m_device == &m_file)
+    m_file.close();
+  m_device = nullptr;
+}
+//-----------------------------------------------------------------------------------------------------
+size_t SceneWriter::objectCount() const
+{
+  return m_count;
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::setFloatMode(const FloatMode _mode)
+{
+  m_floatMode = _mode;
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::flush()
+{
+  if(!m_buffer.empty())
+    m_device->write(m_buffer.data(), static_cast<qint64>(m_buffer.size()));
+  m_buffer.clear();
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::appendKey(const char* _key)
+{
+  m_buffer += "        \"";
+  m_buffer += _key;
+  m_buffer += "\": ";
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::appendString(const std::string &_str)
+{
+  m_buffer += '"';
+  for(auto c : _str)
+  {
+    switch(c)
+    {
+      case '"' : {m_buffer += "\\\""; break;}
+      case '\\' : {m_buffer += "\\\\"; break;}
+      case '\b' : {m_buffer += "\\b"; break;}
+      case '\f' : {m_buffer += "\\f"; break;}
+      case '\n' : {m_buffer += "\\n"; break;}
+      case '\r' : {m_buffer += "\\r"; break;}
+      case '\t' : {m_buffer += "\\t"; break;}
+      default :
+      {
+        if(static_cast<unsigned char>(c) < 0x20) //remaining control characters must be escaped
+        {
+          std::snprintf(m_format.data(), m_format.size(), "\\u%04x", static_cast<unsigned>(c));
+          m_buffer += m_format.data();
+        }
+        else
+        {
+          m_buffer += c;
+        }
+        break;
+      }
+    }
+  }
+  m_buffer += '"';
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::appendInt(size_t _val)
+{
+  //write digits backwards into the scratch buffer
+  char* end = m_format.data() + m_format.size();
+  char* it = end;
+  do
+  {
+    *--it = static_cast<char>('0' + _val%10);
+    _val /= 10;
+  } while(_val != 0);
+  m_buffer.append(it, static_cast<size_t>(end-it));
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::appendFloat(float _val)
+{
+  if(m_floatMode == FLOAT32)
+  {
+    m_buffer.append(m_format.data(), FloatConversion::formatShortest(_val, m_format.data()));
+    return;
+  }
+  //find the shortest representation that reads back as the same double, as QJsonDocument does
+  double wide = static_cast<double>(_val);
+  int len = 0;
+  for(int precision = 15; precision <= 17; ++precision)
+  {
+    len = std::snprintf(m_format.data(), m_format.size(), "%.*g", precision, wide);
+    if(std::strtod(m_format.data(), nullptr) == wide)
+      break;
+  }
+  //printf follows the C locale, which Qt applications set from the environment
+  const char point = *std::localeconv()->decimal_point;
+  for(int i = 0; i < len; ++i)
+  {
+    if(m_format[static_cast<size_t>(i)] == point)
+      m_format[static_cast<size_t>(i)] = '.';
+  }
+  m_buffer.append(m_format.data(), static_cast<size_t>(len));
+}
+//-----------------------------------------------------------------------------------------------------
+void SceneWriter::appendVector(const vec3 &_vec)
+{
+  m_buffer += "[\n            ";
+  appendFloat(_vec.x);
+  m_buffer += ",\n            ";
+  appendFloat(_vec.y);
+  m_buffer += ",\n            ";
+  appendFloat(_vec.z);
+  m_buffer += "\n        ]";
+}
+//-----------------------------------------------------------------------------------------------------
@@ -0,0 +1,127 @@
+#include "ThreadPool.h"
+#include <atomic>
+#include <memory>
+#include <algorithm>
+//-----------------------------------------------------------------------------------------------------
+ThreadPool::ThreadPool(size_t _threads)
+{
+  if(_threads == 0)
+    _threads = std::max(1u, std::thread::hardware_concurrency());
+  m_workers.reserve(_threads);
+  for(size_t i=0; i<_threads; ++i)
+    m_workers.emplace_back(&ThreadPool::work, this);
+}
+//-----------------------------------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_taskReady.notify_all();
+  for(auto &worker : m_workers)
+    worker.join();
+}
+//-----------------------------------------------------------------------------------------------------
+ThreadPool& ThreadPool::instance()
+{
+  static ThreadPool pool;
+  return pool;
+}
+//-----------------------------------------------------------------------------------------------------
+void ThreadPool::submit(std::function<void()> _task)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.push(std::move(_task));
+    ++m_pending;
+  }
+  m_taskReady.notify_one();
+}
+//-----------------------------------------------------------------------------------------------------
+void ThreadPool::wait()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_allDone.wait(lock, [this]{return m_pending == 0;});
+}
+//-----------------------------------------------------------------------------------------------------
+void ThreadPool::parallelFor(const size_t _count, const std::function<void(size_t, size_t)> &_body, const size_t _minRange)
+{
+  if(_count == 0)
+    return;
+  //a few more ranges than threads so uneven ranges still balance out
+  const size_t minRange = std::max<size_t>(1, _minRange);
+  const size_t ranges = std::min((_count + minRange - 1) / minRange, (m_workers.size() + 1) * 4);
+  if(ranges < 2)
+  {
+    _body(0, _count);
+    return;
+  }
+  //shared with the helpers, which may still be unwinding or not even started when the caller returns
+  struct State
+  {
+    std::atomic<size_t> next{0};
+    size_t active = 0;
+    bool closed = false;
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+  auto state = std::make_shared<State>();
+  const size_t rangeSize = (_count + ranges - 1) / ranges;
+  auto run = [state, &_body, _count, rangeSize]
+  {
+    for(size_t begin = state->next.fetch_add(rangeSize); begin < _count; begin = state->next.fetch_add(rangeSize))
+      _body(begin, std::min(begin + rangeSize, _count));
+  };
+  const size_t helpers = std::min(m_workers.size(), ranges - 1);
+  for(size_t i=0; i<helpers; ++i)
+  {
+    submit([state, run]
+    {
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if(state->closed) //the caller is gone, _body may no longer exist
+          return;
+        ++state->active;
+      }
+      run();
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if(--state->active == 0)
+        state->done.notify_one();
+    });
+  }
+  run();
+  //only helpers that already started are waited for, so a call from inside a pool task cannot deadlock
+  //on helpers queued behind it, the caller simply does all ranges itself
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->closed = true;
+  state->done.wait(lock, [&state]{return state->active == 0;});
+}
+//-----------------------------------------------------------------------------------------------------
+size_t ThreadPool::threadCount() const
+{
+  return m_workers.size();
+}
+//-----------------------------------------------------------------------------------------------------
+void ThreadPool::work()
+{
+  for(;;)
+  {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_taskReady.wait(lock, [this]{return m_stop || !m_tasks.empty();});
+      if(m_tasks.empty())
+        return; //only reached when stopping
+      task = std::move(m_tasks.front());
+      m_tasks.pop();
+    }
+    task();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if(--m_pending == 0)
+        m_allDone.notify_all();
+    }
+  }
+}
+//-----------------------------------------------------------------------------------------------------
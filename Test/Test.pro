@@ -9,8 +9,12 @@ CONFIG -= app_bundle
 MOC_DIR = moc
 OBJECTS_DIR = obj
 
+# Tests of the library code run against MLElib itself
 INCLUDEPATH += $$PWD/src \
-            $$PWD/include
+            $$PWD/include \
+            /usr/local/include/glm/glm \
+            /usr/local/include/glm \
+            $$PWD/../MLElib/include
 
 HEADERS += $$PWD/include/*.h
 
@@ -24,3 +28,7 @@ QMAKE_CXXFLAGS += -std=c++14
 linux-clang++: QMAKE_CXXFLAGS += -Weverything -Wno-c++98-compat
 #gcc
 linux-g++: QMAKE_CXXFLAGS += -Wall -Wextra -pedantic-errors
+
+linux:{
+    LIBS += -L../MLElib -lMyLittleEditor
+}
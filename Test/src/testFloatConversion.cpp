@@ -0,0 +1,108 @@
+#include <QtTest/QtTest>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include "FloatConversion.h"
+
+class testFloatConversion : public QObject
+{
+  Q_OBJECT
+private Q_SLOTS:
+  void test_formatShortest();
+  void test_formatNonFinite();
+  void test_parseFloat();
+  void test_parseNoNumber();
+  void test_roundTrip();
+private:
+  std::string format(const float _val) const;
+  bool roundTrips(const float _val) const;
+};
+
+std::string testFloatConversion::format(const float _val) const
+{
+  char out[FloatConversion::s_maxChars];
+  const size_t length = FloatConversion::formatShortest(_val, out);
+  return std::string(out, length);
+}
+
+bool testFloatConversion::roundTrips(const float _val) const
+{
+  char out[FloatConversion::s_maxChars];
+  const size_t length = FloatConversion::formatShortest(_val, out);
+  if(length == 0 || length > FloatConversion::s_maxChars)
+    return false;
+  float parsed = 0.0f;
+  if(FloatConversion::parseFloat(out, out + length, parsed) != out + length)
+    return false;
+  return std::memcmp(&parsed, &_val, sizeof(float)) == 0;
+}
+
+void testFloatConversion::test_formatShortest()
+{
+  QCOMPARE(format(0.1f), std::string{"0.1"});
+  QCOMPARE(format(1.5f), std::string{"1.5"});
+  QCOMPARE(format(-2.0f), std::string{"-2"});
+  QCOMPARE(format(0.3f), std::string{"0.3"});
+  QCOMPARE(format(0.0f), std::string{"0"});
+  QCOMPARE(format(100.0f), std::string{"100"});
+  QCOMPARE(format(123456.789f), std::string{"123456.79"});
+  QCOMPARE(format(1e-7f), std::string{"1e-7"});
+  QCOMPARE(format(1e30f), std::string{"1e30"});
+}
+
+void testFloatConversion::test_formatNonFinite()
+{
+  QCOMPARE(format(std::numeric_limits<float>::infinity()), std::string{"null"});
+  QCOMPARE(format(-std::numeric_limits<float>::infinity()), std::string{"null"});
+  QCOMPARE(format(std::numeric_limits<float>::quiet_NaN()), std::string{"null"});
+}
+
+void testFloatConversion::test_parseFloat()
+{
+  const char text[] = "-12.5e1, 3";
+  float val = 0.0f;
+  const char* it = FloatConversion::parseFloat(text, text + sizeof(text) - 1, val);
+  QCOMPARE(val, -125.0f);
+  QCOMPARE(*it, ',');
+
+  const char small[] = "0.1";
+  FloatConversion::parseFloat(small, small + 3, val);
+  QCOMPARE(val, 0.1f);
+
+  //only the available text is read, the digits past the end are not part of the number
+  const char cut[] = "1.25";
+  FloatConversion::parseFloat(cut, cut + 3, val);
+  QCOMPARE(val, 1.2f);
+}
+
+void testFloatConversion::test_parseNoNumber()
+{
+  const char text[] = "null";
+  float val = 7.0f;
+  QCOMPARE(FloatConversion::parseFloat(text, text + 4, val), static_cast<const char*>(text));
+  QCOMPARE(val, 7.0f);
+}
+
+void testFloatConversion::test_roundTrip()
+{
+  const float values[] = {0.0f, -0.0f, 1.0f, 0.1f, 1.0f / 3.0f, 3.14159274f, 123456.789f, 1e-10f, 1e30f,
+                          std::numeric_limits<float>::min(), std::numeric_limits<float>::max(),
+                          std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::epsilon()};
+  for(const float val : values)
+  {
+    QVERIFY(roundTrips(val));
+    QVERIFY(roundTrips(-val));
+  }
+  //random bit patterns cover every exponent, NaN and infinities are skipped as they are written as null
+  std::mt19937 generator(1234);
+  for(int i = 0; i < 200000; ++i)
+  {
+    const uint32_t bits = generator();
+    float val;
+    std::memcpy(&val, &bits, sizeof(float));
+    if(std::isfinite(val))
+      QVERIFY(roundTrips(val));
+  }
+}
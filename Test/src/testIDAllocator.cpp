@@ -0,0 +1,96 @@
+#include <QtTest/QtTest>
+#include "IDAllocator.h"
+
+class testIDAllocator : public QObject
+{
+  Q_OBJECT
+private Q_SLOTS:
+  void test_allocate();
+  void test_release();
+  void test_claim();
+  void test_claimReleased();
+  void test_releaseUnused();
+  void test_clear();
+};
+
+void testIDAllocator::test_allocate()
+{
+  IDAllocator ids;
+  QCOMPARE(ids.isUsed(0), false);
+  for(size_t i = 0; i < 100; ++i)
+    QCOMPARE(ids.allocate(), i);
+  QCOMPARE(ids.isUsed(99), true);
+  QCOMPARE(ids.isUsed(100), false);
+}
+
+void testIDAllocator::test_release()
+{
+  IDAllocator ids;
+  for(size_t i = 0; i < 10; ++i)
+    ids.allocate();
+  ids.release(7);
+  ids.release(2);
+  ids.release(5);
+  QCOMPARE(ids.isUsed(2), false);
+  //released IDs come back lowest first before any fresh one
+  QCOMPARE(ids.allocate(), size_t{2});
+  QCOMPARE(ids.allocate(), size_t{5});
+  QCOMPARE(ids.allocate(), size_t{7});
+  QCOMPARE(ids.allocate(), size_t{10});
+}
+
+void testIDAllocator::test_claim()
+{
+  IDAllocator ids;
+  QCOMPARE(ids.claim(0), true);
+  QCOMPARE(ids.claim(2), true);
+  QCOMPARE(ids.claim(2), false);
+  //allocate skips the claimed IDs
+  QCOMPARE(ids.allocate(), size_t{1});
+  QCOMPARE(ids.allocate(), size_t{3});
+  QCOMPARE(ids.claim(50), true);
+  for(size_t i = 4; i < 50; ++i)
+    QCOMPARE(ids.allocate(), i);
+  QCOMPARE(ids.allocate(), size_t{51});
+}
+
+void testIDAllocator::test_claimReleased()
+{
+  IDAllocator ids;
+  for(size_t i = 0; i < 5; ++i)
+    ids.allocate();
+  ids.release(1);
+  ids.release(3);
+  //1 is still queued as released, it must not be handed out twice
+  QCOMPARE(ids.claim(1), true);
+  QCOMPARE(ids.allocate(), size_t{3});
+  QCOMPARE(ids.allocate(), size_t{5});
+}
+
+void testIDAllocator::test_releaseUnused()
+{
+  IDAllocator ids;
+  ids.release(4);
+  QCOMPARE(ids.allocate(), size_t{0});
+  ids.allocate();
+  ids.release(1);
+  ids.release(1);
+  QCOMPARE(ids.allocate(), size_t{1});
+  QCOMPARE(ids.allocate(), size_t{2});
+}
+
+void testIDAllocator::test_clear()
+{
+  IDAllocator ids;
+  ids.claim(3);
+  ids.allocate();
+  ids.allocate();
+  ids.release(0);
+  ids.clear();
+  QCOMPARE(ids.isUsed(1), false);
+  QCOMPARE(ids.isUsed(3), false);
+  QCOMPARE(ids.allocate(), size_t{0});
+  QCOMPARE(ids.allocate(), size_t{1});
+  QCOMPARE(ids.allocate(), size_t{2});
+  QCOMPARE(ids.allocate(), size_t{3});
+}
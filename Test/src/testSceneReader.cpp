@@ -0,0 +1,190 @@
+#include <QtTest/QtTest>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "SceneReader.h"
+
+class testSceneReader : public QObject
+{
+  Q_OBJECT
+private Q_SLOTS:
+  void test_openEmpty();
+  void test_openInvalid();
+  void test_next();
+  void test_defaults();
+  void test_skipUnknown();
+  void test_escapes();
+  void test_parseError();
+  void test_readSpan();
+  void test_parseRecord();
+private:
+  //the reader keeps pointers into the text, it must outlive the reader
+  bool open(SceneReader &io_reader, const std::string &_text) const;
+  static const std::string s_scene;
+};
+
+const std::string testSceneReader::s_scene =
+  "{\n"
+  "    \"Object0\": {\n"
+  "        \"Active\": false,\n"
+  "        \"GeometryID\": 3,\n"
+  "        \"GeometryName\": \"Cookie\",\n"
+  "        \"ID\": 7,\n"
+  "        \"MaterialID\": 4,\n"
+  "        \"MaterialName\": \"Chocolate\",\n"
+  "        \"Name\": \"First\",\n"
+  "        \"Parent\": null,\n"
+  "        \"Position\": [1.5, -2, 0.1],\n"
+  "        \"Rotation\": [0, 90, 180],\n"
+  "        \"Scale\": [2, 2, 2]\n"
+  "    },\n"
+  "    \"Object1\": {\n"
+  "        \"ID\": 8,\n"
+  "        \"Name\": \"Second\",\n"
+  "        \"Parent\": 7\n"
+  "    }\n"
+  "}\n";
+
+bool testSceneReader::open(SceneReader &io_reader, const std::string &_text) const
+{
+  return io_reader.open(_text.data(), _text.data() + _text.size());
+}
+
+void testSceneReader::test_openEmpty()
+{
+  SceneReader reader;
+  SceneRecord record;
+  const std::string text = "{}";
+  QVERIFY(open(reader, text));
+  QCOMPARE(reader.next(record), false);
+}
+
+void testSceneReader::test_openInvalid()
+{
+  SceneReader reader;
+  SceneRecord record;
+  const std::string array = "[]";
+  QCOMPARE(open(reader, array), false);
+  QCOMPARE(reader.next(record), false);
+  const std::string empty;
+  QCOMPARE(open(reader, empty), false);
+}
+
+void testSceneReader::test_next()
+{
+  SceneReader reader;
+  SceneRecord record;
+  QVERIFY(open(reader, s_scene));
+  QVERIFY(reader.next(record));
+  QCOMPARE(record.name, std::string{"First"});
+  QCOMPARE(record.id, size_t{7});
+  QCOMPARE(record.active, false);
+  QCOMPARE(record.geo.first, size_t{3});
+  QCOMPARE(record.geo.second, std::string{"Cookie"});
+  QCOMPARE(record.mat.first, size_t{4});
+  QCOMPARE(record.mat.second, std::string{"Chocolate"});
+  QCOMPARE(record.hasParent, false);
+  QCOMPARE(record.position, glm::vec3(1.5f, -2.0f, 0.1f));
+  QCOMPARE(record.rotation, glm::vec3(0.0f, 90.0f, 180.0f));
+  QCOMPARE(record.scale, glm::vec3(2.0f, 2.0f, 2.0f));
+  QVERIFY(reader.next(record));
+  QCOMPARE(record.name, std::string{"Second"});
+  QCOMPARE(record.hasParent, true);
+  QCOMPARE(record.parent, size_t{7});
+  QCOMPARE(reader.next(record), false);
+}
+
+void testSceneReader::test_defaults()
+{
+  //the second object leaves out most keys, they must not carry over from the first
+  SceneReader reader;
+  SceneRecord record;
+  const SceneRecord defaults;
+  QVERIFY(open(reader, s_scene));
+  QVERIFY(reader.next(record));
+  QVERIFY(reader.next(record));
+  QCOMPARE(record.id, size_t{8});
+  QCOMPARE(record.active, defaults.active);
+  QCOMPARE(record.geo.first, defaults.geo.first);
+  QCOMPARE(record.geo.second, defaults.geo.second);
+  QCOMPARE(record.mat.first, defaults.mat.first);
+  QCOMPARE(record.mat.second, defaults.mat.second);
+  QCOMPARE(record.position, defaults.position);
+  QCOMPARE(record.rotation, defaults.rotation);
+  QCOMPARE(record.scale, defaults.scale);
+
+  //an empty object is all defaults, including the name and parent
+  QVERIFY(SceneReader::parseRecord("{}", "{}" + 2, record));
+  QCOMPARE(record.name, defaults.name);
+  QCOMPARE(record.id, defaults.id);
+  QCOMPARE(record.hasParent, false);
+}
+
+void testSceneReader::test_skipUnknown()
+{
+  SceneReader reader;
+  SceneRecord record;
+  const std::string text = "{\"Object0\": {\"Extra\": {\"a\": [1, \"}\", null]}, \"ID\": 5, \"More\": true}}";
+  QVERIFY(open(reader, text));
+  QVERIFY(reader.next(record));
+  QCOMPARE(record.id, size_t{5});
+  QCOMPARE(reader.next(record), false);
+}
+
+void testSceneReader::test_escapes()
+{
+  SceneReader reader;
+  SceneRecord record;
+  const std::string text = "{\"Object0\": {\"Name\": \"a\\\"b\\\\c\\n\\u00e9\"}}";
+  QVERIFY(open(reader, text));
+  QVERIFY(reader.next(record));
+  QCOMPARE(record.name, std::string{"a\"b\\c\n\xC3\xA9"});
+}
+
+void testSceneReader::test_parseError()
+{
+  SceneReader reader;
+  SceneRecord record;
+  const std::string text = "{\"Object0\": {\"ID\": 1}, \"Object1\": {\"ID\": }, \"Object2\": {\"ID\": 3}}";
+  QVERIFY(open(reader, text));
+  QVERIFY(reader.next(record));
+  QCOMPARE(reader.next(record), false);
+  //reading stops at the error
+  QCOMPARE(reader.next(record), false);
+}
+
+void testSceneReader::test_readSpan()
+{
+  SceneReader reader;
+  SceneRecord record;
+  QVERIFY(open(reader, s_scene));
+  QVERIFY(reader.next(record));
+  const auto first = reader.recordSpan();
+  QVERIFY(reader.next(record));
+  const auto second = reader.recordSpan();
+
+  std::vector<SceneRecord> records;
+  QVERIFY(reader.readSpan(first.first, second.second, records));
+  QCOMPARE(records.size(), size_t{2});
+  QCOMPARE(records[0].name, std::string{"First"});
+  QCOMPARE(records[1].name, std::string{"Second"});
+  QCOMPARE(records[1].geo.second, SceneRecord().geo.second);
+
+  QVERIFY(reader.readSpan(second.first, second.second, records));
+  QCOMPARE(records.size(), size_t{3});
+  QCOMPARE(records[2].id, size_t{8});
+  QCOMPARE(reader.readSpan(second.first, s_scene.size() + 1, records), false);
+}
+
+void testSceneReader::test_parseRecord()
+{
+  const std::string text = "{\"Name\": \"Lone\", \"Scale\": [0.5, 0.25, 4]}";
+  SceneRecord record;
+  record.name = "Stale";
+  record.id = 99;
+  QVERIFY(SceneReader::parseRecord(text.data(), text.data() + text.size(), record));
+  QCOMPARE(record.name, std::string{"Lone"});
+  QCOMPARE(record.id, size_t{0});
+  QCOMPARE(record.scale, glm::vec3(0.5f, 0.25f, 4.0f));
+  QCOMPARE(SceneReader::parseRecord(text.data(), text.data() + text.size() - 1, record), false);
+}
@@ -3,12 +3,18 @@
 #include "testSceneObject.cpp"
 #include "testDataContainer.cpp"
 #include "testObjectManager.cpp"
+#include "testFloatConversion.cpp"
+#include "testSceneReader.cpp"
+#include "testIDAllocator.cpp"
 
 //#define MAT_TEST
 //#define GEO_TEST
 #define SO_TEST
 //#define DATAC_TEST
 //#define OBJMGR_TEST
+//#define FLOAT_TEST
+//#define READER_TEST
+//#define IDALLOC_TEST
 
 #ifdef MAT_TEST
   QTEST_APPLESS_MAIN(testMaterial)
@@ -34,3 +40,18 @@
   QTEST_APPLESS_MAIN(testObjectManager)
   #include "moc/testObjectManager.moc"
 #endif
+
+#ifdef FLOAT_TEST
+  QTEST_APPLESS_MAIN(testFloatConversion)
+  #include "moc/testFloatConversion.moc"
+#endif
+
+#ifdef READER_TEST
+  QTEST_APPLESS_MAIN(testSceneReader)
+  #include "moc/testSceneReader.moc"
+#endif
+
+#ifdef IDALLOC_TEST
+  QTEST_APPLESS_MAIN(testIDAllocator)
+  #include "moc/testIDAllocator.moc"
+#endif